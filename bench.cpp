@@ -0,0 +1,718 @@
+#include "header.h"
+#include "history.h"
+#include "interrupts.h"
+#include "perfcounters.h"
+#include "smaps.h"
+#include "inventory.h"
+#include "snapshot.h"
+#include "procfs.h"
+#include "fixture.h"
+#include "clock.h"
+#include "scheduler.h"
+#include "selfstats.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <new>
+#include <thread>
+#include <signal.h>
+#include <sys/ptrace.h>
+#include <sys/wait.h>
+
+/*
+Benchmarks for the system monitor, built with `make bench`.
+
+    ./monitor-bench [--suite all|collectors|frames|history] [--json FILE] [--baseline FILE]
+                    [--fixture-pids N,N,...] [--fixture DIR] [--archive FILE]
+                    [--min-time-ms MS] [--threshold PCT] [--frames N] [--samples N] [--interval-ms MS]
+
+The collector suite times every collector and parser against the live host,
+generated fixture trees (interfaces scale with pids: pids / 20, at least 4;
+containers pids / 100, at least 2),
+an existing tree given with --fixture, and a capture archive given with
+--archive. Each source runs in its own process so discovery caches (thermal
+and fan sensor paths) start cold. It reports:
+    ns/op       mean wall time over at least --min-time-ms per benchmark
+    allocs/op   calls to operator new
+    syscalls/op counted in a separate ptrace'd run ("-" / null if ptrace is denied)
+
+The frame benchmark draws the System, Memory and Processes and Network windows
+for N frames (--frames, 600 = 10 s at 60 fps) in a windowless ImGui context
+against the same sources, and reports p50/p99 frame time split into snapshot
+collection, building the ImGui frame, and producing the draw data.
+
+--json writes the results of both suites for storing as a baseline; --baseline compares the
+run against such a file and exits with status 1 if any benchmark's time,
+allocations or syscalls grew by more than --threshold percent.
+
+The history benchmark first records live CPU, memory and network series from
+this host (N samples, MS apart), then reports the Gorilla compression ratio
+against raw 16-byte points and the write throughput of the segment log.
+*/
+
+namespace fs = std::filesystem;
+
+// ------------------------------
+// ALLOCATION COUNTER
+// ------------------------------
+
+static std::atomic<uint64_t> allocationCount{0};
+
+void* operator new(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    free(p);
+}
+
+struct BenchSeries {
+    std::string name;
+    std::vector<HistoryPoint> points;
+};
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Samples the collectors `samples` times, `intervalMs` apart
+static std::vector<BenchSeries> recordLiveSeries(int samples, int intervalMs) {
+    BenchSeries cpu{"cpu.total", {}}, mem{"mem.used_mb", {}};
+    std::map<std::string, BenchSeries> net;
+
+    CPUStats lastCpu = readCpuStats();
+    for (int i = 0; i < samples; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+        int64_t now = historyNowMs();
+
+        CPUStats stat = readCpuStats();
+        cpu.points.push_back({now, cpuUsageBetween(lastCpu, stat)});
+        lastCpu = stat;
+
+        mem.points.push_back({now, getMemoryUsageMB().first});
+
+        for (const auto& [iface, ns] : readNetworkStats()) {
+            BenchSeries& rx = net["net." + iface + ".rx_bytes"];
+            rx.points.push_back({now, (double)ns.rx_bytes});
+            BenchSeries& tx = net["net." + iface + ".tx_bytes"];
+            tx.points.push_back({now, (double)ns.tx_bytes});
+        }
+    }
+
+    std::vector<BenchSeries> all = {cpu, mem};
+    for (auto& [name, series] : net) {
+        series.name = name;
+        all.push_back(series);
+    }
+    return all;
+}
+
+// Compression ratio per series and write throughput of the segment log
+static void benchHistory(const std::vector<BenchSeries>& series) {
+    printf("%-32s %8s %10s %10s %8s\n", "series", "points", "raw B", "enc B", "ratio");
+
+    size_t totalPoints = 0, totalRaw = 0, totalEncoded = 0;
+    for (const BenchSeries& s : series) {
+        // Encode in chunks the same size the store uses
+        GorillaEncoder enc;
+        size_t encoded = 0;
+        std::vector<HistoryPoint> decoded;
+        for (size_t i = 0; i < s.points.size(); ++i) {
+            enc.append(s.points[i].timeMs, s.points[i].value);
+            if (enc.count() == 240 || i + 1 == s.points.size()) {
+                encoded += enc.bytes().size();
+                gorillaDecode(enc.bytes().data(), enc.bytes().size(), enc.count(), decoded);
+                enc.clear();
+            }
+        }
+
+        bool exact = decoded.size() == s.points.size();
+        for (size_t i = 0; exact && i < decoded.size(); ++i)
+            exact = decoded[i].timeMs == s.points[i].timeMs && decoded[i].value == s.points[i].value;
+
+        size_t raw = s.points.size() * sizeof(HistoryPoint);
+        printf("%-32s %8zu %10zu %10zu %7.2fx%s\n", s.name.c_str(), s.points.size(), raw, encoded,
+               encoded ? (double)raw / encoded : 0.0, exact ? "" : "  ROUND TRIP MISMATCH");
+        totalPoints += s.points.size();
+        totalRaw += raw;
+        totalEncoded += encoded;
+    }
+    printf("%-32s %8zu %10zu %10zu %7.2fx\n", "total", totalPoints, totalRaw, totalEncoded,
+           totalEncoded ? (double)totalRaw / totalEncoded : 0.0);
+
+    // Write throughput through the real store, replaying the series with
+    // shifted timestamps until enough points went through
+    std::string dir = (fs::temp_directory_path() / ("sysmon-bench-" + std::to_string(getpid()))).string();
+    if (!historyOpen(dir)) {
+        printf("history: could not open %s\n", dir.c_str());
+        return;
+    }
+
+    const size_t target = 2000000;
+    size_t written = 0;
+    int64_t shift = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (written < target && totalPoints > 0) {
+        for (const BenchSeries& s : series) {
+            for (const HistoryPoint& p : s.points) historyAppend(s.name, p.timeMs + shift, p.value);
+            written += s.points.size();
+        }
+        shift += 24LL * 3600 * 1000;
+    }
+    historyFlush();
+    double elapsed = secondsSince(start);
+    size_t bytes = historyDiskBytes();
+    historyClose();
+
+    printf("write: %zu points in %.3f s = %.0f points/s, %.2f MB/s on disk (%.2f bytes/point)\n",
+           written, elapsed, written / elapsed, bytes / elapsed / (1024.0 * 1024.0),
+           written ? (double)bytes / written : 0.0);
+
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+}
+
+// ------------------------------
+// COLLECTOR BENCHMARKS
+// ------------------------------
+
+struct BenchResult {
+    std::string name;
+    std::string source;
+    long long iterations = 0;
+    double nsPerOp = 0.0;
+    double allocsPerOp = 0.0;
+    double syscallsPerOp = -1.0;  // < 0 when ptrace is not permitted
+};
+
+struct BenchCase {
+    const char* name;
+    std::function<void()> run;
+    bool liveOnly;  // reads the host through APIs other than /proc and /sys
+};
+
+// Keeps the collectors' results alive so nothing is optimised away
+static volatile size_t benchSink = 0;
+
+// Syscalls made per call of fn, counted by tracing a forked child
+static double countSyscallsPerOp(const std::function<void()>& fn, int iterations) {
+    pid_t child = fork();
+    if (child < 0) return -1.0;
+    if (child == 0) {
+        fn();  // warm up caches outside the traced region
+        if (ptrace(PTRACE_TRACEME, 0, nullptr, nullptr) != 0) _exit(2);
+        raise(SIGSTOP);
+        for (int i = 0; i < iterations; i++) fn();
+        _exit(0);
+    }
+
+    int status = 0;
+    if (waitpid(child, &status, 0) != child || !WIFSTOPPED(status)) {
+        if (!WIFEXITED(status)) {
+            kill(child, SIGKILL);
+            waitpid(child, &status, 0);
+        }
+        return -1.0;
+    }
+    ptrace(PTRACE_SETOPTIONS, child, nullptr, PTRACE_O_TRACESYSGOOD | PTRACE_O_EXITKILL);
+
+    // Every syscall stops twice (entry and exit) except the final exit_group
+    long stops = 0;
+    while (ptrace(PTRACE_SYSCALL, child, nullptr, nullptr) == 0 && waitpid(child, &status, 0) == child) {
+        if (WIFEXITED(status) || WIFSIGNALED(status)) break;
+        if (WIFSTOPPED(status) && WSTOPSIG(status) == (SIGTRAP | 0x80)) stops++;
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) return -1.0;
+    return ((stops + 1) / 2 - 1) / (double)iterations;
+}
+
+static BenchResult runBench(const BenchCase& bench, const std::string& source, double minTimeMs) {
+    BenchResult r;
+    r.name = bench.name;
+    r.source = source;
+
+    bench.run();  // warm up: sensor discovery and first-round deltas
+
+    uint64_t allocsBefore = allocationCount.load();
+    auto start = std::chrono::steady_clock::now();
+    double elapsedMs = 0.0;
+    while (r.iterations < 3 || elapsedMs < minTimeMs) {
+        bench.run();
+        r.iterations++;
+        elapsedMs = secondsSince(start) * 1000.0;
+    }
+    r.nsPerOp = elapsedMs * 1e6 / r.iterations;
+    r.allocsPerOp = (allocationCount.load() - allocsBefore) / (double)r.iterations;
+    r.syscallsPerOp = countSyscallsPerOp(bench.run, (int)std::min<long long>(r.iterations, 20));
+    return r;
+}
+
+// A pid that exists in the active source: our own on the live host,
+// otherwise the first one listed in /proc
+static int benchPid() {
+    if (procRoot().empty() && !isArchiveOpen()) return getpid();
+    std::vector<std::string> names;
+    procListDir("/proc", names);
+    for (const std::string& n : names)
+        if (!n.empty() && isdigit((unsigned char)n[0])) return atoi(n.c_str());
+    return 1;
+}
+
+// The process with the most threads, as if a large JVM were expanded in the table.
+// Each source runs in its own process, so finding it once is enough
+static int widestPid() {
+    static int widest = [] {
+        int pid = 0, threads = 0;
+        for (const ProcessSample& p : collectProcesses())
+            if (p.threads > threads) pid = p.pid, threads = p.threads;
+        return pid;
+    }();
+    return widest;
+}
+
+static std::vector<BenchCase> collectorBenches() {
+    int pid = benchPid();
+    return {
+        {"getCpuUsagePercent", [] { benchSink += (size_t)getCpuUsagePercent(); }, false},
+        {"getMemoryUsageMB", [] { benchSink += (size_t)getMemoryUsageMB().first; }, false},
+        {"getSwapInfo", [] { benchSink += (size_t)getSwapInfo().totalMB; }, false},
+        {"readNetworkStats", [] { benchSink += readNetworkStats().size(); }, false},
+        {"getNetworkInterfaces", [] { benchSink += getNetworkInterfaces().size(); }, true},
+        {"getTaskStats", [] { benchSink += getTaskStats().total; }, false},
+        {"readProcessCpuTime", [pid] { benchSink += readProcessCpuTime(pid); }, false},
+        {"readProcessMemoryPercent", [pid] { benchSink += (size_t)readProcessMemoryPercent(pid); }, false},
+        {"readTemperatureC", [] { benchSink += (size_t)readTemperatureC(); }, false},
+        {"getFanInfo", [] { benchSink += getFanInfo().speedRPM; }, false},
+        {"readCpuFreq", [] { benchSink += readCpuFreq(clockWallMs()).cores.size(); }, false},
+        {"hostInventory", [] { benchSink += hostInventory().threads; }, false},
+        {"readSched", [] { benchSink += readSched(ProcStatCounters{}, clockWallMs()).cpus.size(); }, false},
+        {"readInterrupts", [] { benchSink += readInterrupts(clockWallMs()).sources.size(); }, false},
+        {"readPerf", [] { setPerfEnabled(true); benchSink += readPerf(clockWallMs()).cores.size(); }, true},
+        {"readPsi", [] { benchSink += readPsi(clockWallMs()).resources[PsiCpu].found; }, false},
+        {"readCgroups", [] { benchSink += readCgroups(clockWallMs()).groups.size(); }, false},
+        {"collectProcesses", [] { benchSink += collectProcesses().size(); }, false},
+        {"collectProcessesIo", [] {
+             processIoEnabled = true;
+             benchSink += collectProcesses().size();
+             processIoEnabled = false;
+         }, false},
+        {"collectProcessesThreads", [] {
+             expandedProcesses.insert(widestPid());
+             benchSink += collectProcesses().size();
+             expandedProcesses.clear();
+         }, false},
+        {"collectSnapshot", [] { benchSink += collectSnapshot().processes.size(); }, false},
+        {"collectSelfStats", [] { benchSink += collectSelfStats().threads.size(); }, true},
+    };
+}
+
+static void printResult(const BenchResult& r) {
+    char syscalls[32] = "-";
+    if (r.syscallsPerOp >= 0) snprintf(syscalls, sizeof(syscalls), "%.1f", r.syscallsPerOp);
+    printf("%-26s %-16s %14.0f %12.1f %12s %8lld\n", r.name.c_str(), r.source.c_str(), r.nsPerOp,
+           r.allocsPerOp, syscalls, r.iterations);
+    fflush(stdout);
+}
+
+// Runs `body` in a child process after `setup` selected the source there, so
+// caches, graph histories and /proc state never leak between sources
+static std::vector<BenchResult> benchSource(const std::string& source, const std::function<bool()>& setup,
+                                            const std::function<std::vector<BenchResult>(const std::string&)>& body) {
+    std::vector<BenchResult> results;
+    int fds[2];
+    if (pipe(fds) != 0) return results;
+
+    fflush(stdout);
+    pid_t child = fork();
+    if (child < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return results;
+    }
+    if (child == 0) {
+        close(fds[0]);
+        if (!setup()) {
+            fprintf(stderr, "%s: could not open source\n", source.c_str());
+            _exit(1);
+        }
+        FILE* out = fdopen(fds[1], "w");
+        for (const BenchResult& r : body(source))
+            fprintf(out, "%s\t%lld\t%.3f\t%.3f\t%.3f\n", r.name.c_str(), r.iterations, r.nsPerOp,
+                    r.allocsPerOp, r.syscallsPerOp);
+        fclose(out);
+        _exit(0);
+    }
+
+    close(fds[1]);
+    FILE* in = fdopen(fds[0], "r");
+    char name[128];
+    BenchResult r;
+    while (fscanf(in, "%127s %lld %lf %lf %lf", name, &r.iterations, &r.nsPerOp, &r.allocsPerOp,
+                  &r.syscallsPerOp) == 5) {
+        r.name = name;
+        r.source = source;
+        results.push_back(r);
+    }
+    fclose(in);
+    int status;
+    waitpid(child, &status, 0);
+    return results;
+}
+
+static std::vector<BenchResult> runCollectorBenches(const std::string& source, double minTimeMs) {
+    std::vector<BenchResult> results;
+    for (const BenchCase& bench : collectorBenches()) {
+        if (bench.liveOnly && source != "live") continue;
+        results.push_back(runBench(bench, source, minTimeMs));
+        printResult(results.back());
+    }
+    return results;
+}
+
+// Where a child process reads /proc and /sys from
+struct BenchTarget {
+    std::string name;
+    std::function<bool()> setup;
+};
+
+// The live host, a generated fixture per size, --fixture and --archive.
+// Generated trees are listed in `tempDirs` for removal once all suites ran.
+static std::vector<BenchTarget> prepareTargets(const std::vector<int>& fixturePids, const std::string& fixtureDir,
+                                               const std::string& archivePath, std::vector<std::string>& tempDirs) {
+    std::vector<BenchTarget> targets;
+    targets.push_back({"live", [] { return true; }});
+
+    for (int pids : fixturePids) {
+        FixtureSpec spec;
+        spec.pids = pids;
+        spec.interfaces = std::max(4, pids / 20);
+        spec.containers = std::max(2, pids / 100);
+        spec.sensors = 4;
+        std::string dir = (fs::temp_directory_path() /
+                           ("sysmon-bench-fixture-" + std::to_string(getpid()) + "-" + std::to_string(pids))).string();
+        tempDirs.push_back(dir);
+
+        // Two rounds, so the benchmarks see counters that moved
+        auto start = std::chrono::steady_clock::now();
+        bool ok = writeFixture(dir, spec, 0) && writeFixture(dir, spec, 1);
+        fprintf(stderr, "fixture %d pids, %d interfaces: %s in %.1f s\n", spec.pids, spec.interfaces,
+                ok ? "generated" : "FAILED", secondsSince(start));
+        if (ok) targets.push_back({"fixture-" + std::to_string(pids), [dir] { setProcRoot(dir); return true; }});
+    }
+
+    if (!fixtureDir.empty())
+        targets.push_back({"fixture-dir", [fixtureDir] { setProcRoot(fixtureDir); return true; }});
+    if (!archivePath.empty())
+        targets.push_back({"archive", [archivePath] { return openArchive(archivePath); }});
+    return targets;
+}
+
+static std::vector<BenchResult> benchAllTargets(const std::vector<BenchTarget>& targets,
+                                                const std::function<std::vector<BenchResult>(const std::string&)>& body) {
+    std::vector<BenchResult> all;
+    for (const BenchTarget& target : targets) {
+        std::vector<BenchResult> results = benchSource(target.name, target.setup, body);
+        all.insert(all.end(), results.begin(), results.end());
+    }
+    return all;
+}
+
+// ------------------------------
+// FRAME BENCHMARK
+// ------------------------------
+
+// Percentile of an unsorted sample, in ns
+static double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, (size_t)(p * values.size()))];
+}
+
+// Draws the three main windows for `frames` frames in a windowless ImGui
+// context, 60 frames per simulated second, so the snapshot is collected
+// every sampleIntervalMs as in the real app.
+// "draw" is ImGui::Render() plus copying every vertex and index buffer,
+// which stands in for the GL backend's upload.
+static std::vector<BenchResult> runFrameBench(const std::string& source, int frames) {
+    SimClock sim;
+    setClock(&sim);
+
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = nullptr;
+    io.DisplaySize = ImVec2(1920, 1080);
+    io.DeltaTime = 1.0f / 60.0f;
+    unsigned char* pixels;
+    int width, height;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+    const char* phases[] = {"collect", "build", "draw", "total"};
+    std::vector<double> times[4];
+    uint64_t allocs[4] = {};
+    std::vector<uint8_t> upload;
+
+    for (int frame = 0; frame < frames; frame++) {
+        uint64_t allocStart = allocationCount.load();
+        auto t0 = std::chrono::steady_clock::now();
+
+        updateSnapshot();
+        auto t1 = std::chrono::steady_clock::now();
+        uint64_t allocCollected = allocationCount.load();
+
+        ImGui::NewFrame();
+        ImVec2 display = io.DisplaySize;
+        memoryProcessesWindow("== Memory and Processes ==", ImVec2((display.x / 2) - 20, (display.y / 2) + 30),
+                              ImVec2((display.x / 2) + 10, 10));
+        systemWindow("== System ==", ImVec2((display.x / 2) - 10, (display.y / 2) + 30), ImVec2(10, 10));
+        networkWindow("== Network ==", ImVec2(display.x - 20, (display.y / 2) - 60), ImVec2(10, (display.y / 2) + 50));
+        auto t2 = std::chrono::steady_clock::now();
+        uint64_t allocBuilt = allocationCount.load();
+
+        ImGui::Render();
+        upload.clear();
+        ImDrawData* drawData = ImGui::GetDrawData();
+        for (int i = 0; i < drawData->CmdListsCount; i++) {
+            const ImDrawList* list = drawData->CmdLists[i];
+            const uint8_t* vtx = (const uint8_t*)list->VtxBuffer.Data;
+            const uint8_t* idx = (const uint8_t*)list->IdxBuffer.Data;
+            upload.insert(upload.end(), vtx, vtx + list->VtxBuffer.Size * sizeof(ImDrawVert));
+            upload.insert(upload.end(), idx, idx + list->IdxBuffer.Size * sizeof(ImDrawIdx));
+        }
+        benchSink += upload.size();
+        auto t3 = std::chrono::steady_clock::now();
+        uint64_t allocDrawn = allocationCount.load();
+
+        times[0].push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+        times[1].push_back(std::chrono::duration<double, std::nano>(t2 - t1).count());
+        times[2].push_back(std::chrono::duration<double, std::nano>(t3 - t2).count());
+        times[3].push_back(std::chrono::duration<double, std::nano>(t3 - t0).count());
+        allocs[0] += allocCollected - allocStart;
+        allocs[1] += allocBuilt - allocCollected;
+        allocs[2] += allocDrawn - allocBuilt;
+        allocs[3] += allocDrawn - allocStart;
+
+        sim.advance(io.DeltaTime);
+    }
+    ImGui::DestroyContext();
+    setClock(nullptr);
+    // The process table started the smaps reader for its visible rows
+    stopSmapsReader();
+
+    std::vector<BenchResult> results;
+    for (int phase = 0; phase < 4; phase++) {
+        for (double p : {0.50, 0.99}) {
+            BenchResult r;
+            r.name = std::string("frame.") + phases[phase] + (p == 0.50 ? ".p50" : ".p99");
+            r.source = source;
+            r.iterations = frames;
+            r.nsPerOp = percentile(times[phase], p);
+            r.allocsPerOp = allocs[phase] / (double)frames;
+            results.push_back(r);
+        }
+    }
+
+    printf("%-16s %6d", source.c_str(), frames);
+    for (int phase = 0; phase < 4; phase++)
+        printf("  %9.3f %9.3f", percentile(times[phase], 0.50) / 1e6, percentile(times[phase], 0.99) / 1e6);
+    printf("\n");
+    fflush(stdout);
+    return results;
+}
+
+// ------------------------------
+// JSON RESULTS AND BASELINES
+// ------------------------------
+
+static void writeJson(const std::string& path, const std::vector<BenchResult>& results) {
+    FILE* out = fopen(path.c_str(), "w");
+    if (!out) {
+        fprintf(stderr, "Error: could not write %s\n", path.c_str());
+        return;
+    }
+    fprintf(out, "{\n  \"results\": [\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        char syscalls[32] = "null";
+        if (r.syscallsPerOp >= 0) snprintf(syscalls, sizeof(syscalls), "%.3f", r.syscallsPerOp);
+        // One result per line, which is what readJson expects
+        fprintf(out, "    {\"name\": \"%s\", \"source\": \"%s\", \"iterations\": %lld, \"ns_per_op\": %.1f, "
+                     "\"allocs_per_op\": %.3f, \"syscalls_per_op\": %s}%s\n",
+                r.name.c_str(), r.source.c_str(), r.iterations, r.nsPerOp, r.allocsPerOp, syscalls,
+                i + 1 < results.size() ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+    fclose(out);
+}
+
+// Value of "key": in a line written by writeJson
+static std::string jsonField(const std::string& line, const char* key) {
+    std::string quoted = std::string("\"") + key + "\": ";
+    size_t at = line.find(quoted);
+    if (at == std::string::npos) return "";
+    at += quoted.size();
+    if (line[at] == '"') return line.substr(at + 1, line.find('"', at + 1) - at - 1);
+    return line.substr(at, line.find_first_of(",}", at) - at);
+}
+
+static std::vector<BenchResult> readJson(const std::string& path) {
+    std::vector<BenchResult> results;
+    FILE* in = fopen(path.c_str(), "r");
+    if (!in) return results;
+    char buf[1024];
+    while (fgets(buf, sizeof(buf), in)) {
+        std::string line = buf;
+        if (jsonField(line, "name").empty()) continue;
+        BenchResult r;
+        r.name = jsonField(line, "name");
+        r.source = jsonField(line, "source");
+        r.iterations = atoll(jsonField(line, "iterations").c_str());
+        r.nsPerOp = atof(jsonField(line, "ns_per_op").c_str());
+        r.allocsPerOp = atof(jsonField(line, "allocs_per_op").c_str());
+        std::string syscalls = jsonField(line, "syscalls_per_op");
+        r.syscallsPerOp = syscalls == "null" ? -1.0 : atof(syscalls.c_str());
+        results.push_back(r);
+    }
+    fclose(in);
+    return results;
+}
+
+// Prints the change against the baseline; returns the number of regressions
+static int compareBaseline(const std::vector<BenchResult>& results, const std::vector<BenchResult>& baseline,
+                           double thresholdPercent) {
+    printf("%-26s %-16s %10s %20s %20s\n", "benchmark", "source", "time", "allocs/op", "syscalls/op");
+    int regressions = 0;
+    for (const BenchResult& r : results) {
+        const BenchResult* base = nullptr;
+        for (const BenchResult& b : baseline)
+            if (b.name == r.name && b.source == r.source) base = &b;
+        if (!base) {
+            printf("%-26s %-16s %10s\n", r.name.c_str(), r.source.c_str(), "new");
+            continue;
+        }
+
+        double change = base->nsPerOp > 0 ? (r.nsPerOp / base->nsPerOp - 1.0) * 100.0 : 0.0;
+        bool slower = change > thresholdPercent;
+        // Counts move with the number of processes on a live host, so they
+        // get the same relative threshold as time (plus half an op)
+        double countLimit = 1.0 + thresholdPercent / 100.0;
+        bool moreAllocs = r.allocsPerOp > base->allocsPerOp * countLimit + 0.5;
+        bool moreSyscalls = r.syscallsPerOp >= 0 && base->syscallsPerOp >= 0 &&
+                            r.syscallsPerOp > base->syscallsPerOp * countLimit + 0.5;
+        if (slower || moreAllocs || moreSyscalls) regressions++;
+
+        char syscalls[48] = "-";
+        if (r.syscallsPerOp >= 0 && base->syscallsPerOp >= 0)
+            snprintf(syscalls, sizeof(syscalls), "%.1f -> %.1f", base->syscallsPerOp, r.syscallsPerOp);
+        char allocs[48];
+        snprintf(allocs, sizeof(allocs), "%.1f -> %.1f", base->allocsPerOp, r.allocsPerOp);
+        printf("%-26s %-16s %+9.1f%% %20s %20s%s\n", r.name.c_str(), r.source.c_str(), change, allocs, syscalls,
+               (slower || moreAllocs || moreSyscalls) ? "  REGRESSION" : "");
+    }
+    return regressions;
+}
+
+int main(int argc, char** argv) {
+    std::string suite = "all";
+    std::string jsonPath, baselinePath, fixtureDir, archivePath;
+    std::vector<int> fixturePids = {1000, 10000};
+    int frames = 600;
+    double minTimeMs = 200.0;
+    double thresholdPercent = 10.0;
+    int samples = 600;
+    int intervalMs = 10;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--samples") && i + 1 < argc) samples = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--interval-ms") && i + 1 < argc) intervalMs = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--suite") && i + 1 < argc) suite = argv[++i];
+        else if (!strcmp(argv[i], "--json") && i + 1 < argc) jsonPath = argv[++i];
+        else if (!strcmp(argv[i], "--baseline") && i + 1 < argc) baselinePath = argv[++i];
+        else if (!strcmp(argv[i], "--fixture") && i + 1 < argc) fixtureDir = argv[++i];
+        else if (!strcmp(argv[i], "--archive") && i + 1 < argc) archivePath = argv[++i];
+        else if (!strcmp(argv[i], "--min-time-ms") && i + 1 < argc) minTimeMs = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--threshold") && i + 1 < argc) thresholdPercent = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--frames") && i + 1 < argc) frames = std::max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--fixture-pids") && i + 1 < argc) {
+            fixturePids.clear();
+            for (char* p = argv[++i]; *p;) {
+                if (int n = (int)strtol(p, &p, 10)) fixturePids.push_back(n);
+                if (*p) p++;
+            }
+        } else {
+            fprintf(stderr,
+                    "usage: %s [--suite all|collectors|frames|history] [--json FILE] [--baseline FILE]\n"
+                    "       [--fixture-pids N,N,...] [--fixture DIR] [--archive FILE]\n"
+                    "       [--min-time-ms MS] [--threshold PCT] [--frames N] [--samples N] [--interval-ms MS]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    int status = 0;
+    std::vector<BenchResult> results;
+    std::vector<std::string> tempDirs;
+    std::vector<BenchTarget> targets;
+    if (suite == "all" || suite == "collectors" || suite == "frames")
+        targets = prepareTargets(fixturePids, fixtureDir, archivePath, tempDirs);
+
+    if (suite == "all" || suite == "collectors") {
+        printf("== collectors ==\n");
+        printf("%-26s %-16s %14s %12s %12s %8s\n", "benchmark", "source", "ns/op", "allocs/op", "syscalls/op", "iters");
+        std::vector<BenchResult> found = benchAllTargets(targets,
+            [minTimeMs](const std::string& source) { return runCollectorBenches(source, minTimeMs); });
+        results.insert(results.end(), found.begin(), found.end());
+    }
+
+    if (suite == "all" || suite == "frames") {
+        printf("== frames: ms per frame, p50 and p99 ==\n");
+        printf("%-16s %6s  %19s  %19s  %19s  %19s\n", "source", "frames", "collect", "ImGui build", "draw data", "total");
+        std::vector<BenchResult> found = benchAllTargets(targets,
+            [frames](const std::string& source) { return runFrameBench(source, frames); });
+        results.insert(results.end(), found.begin(), found.end());
+    }
+
+    if (!results.empty()) {
+        if (!jsonPath.empty()) writeJson(jsonPath, results);
+        if (!baselinePath.empty()) {
+            std::vector<BenchResult> baseline = readJson(baselinePath);
+            if (baseline.empty()) {
+                fprintf(stderr, "Error: no results in baseline %s\n", baselinePath.c_str());
+                status = 1;
+            } else {
+                printf("== against %s (threshold %+.0f%%) ==\n", baselinePath.c_str(), thresholdPercent);
+                if (compareBaseline(results, baseline, thresholdPercent) > 0) status = 1;
+            }
+        }
+    }
+
+    if (suite == "all" || suite == "history") {
+        printf("== history: recording %d samples %d ms apart ==\n", samples, intervalMs);
+        benchHistory(recordLiveSeries(samples, intervalMs));
+    }
+
+    for (const std::string& dir : tempDirs) {
+        std::error_code ec;
+        fs::remove_all(dir, ec);
+    }
+    return status;
+}
@@ -0,0 +1,342 @@
+#include "cgroups.h"
+#include "header.h"
+#include "procfs.h"
+#include "profiler.h"
+#include "snapshot.h"
+#include <imgui.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+
+static const int64_t cgroupScanIntervalMs = 5000;
+static const size_t maxCgroups = 4096;
+
+// ------------------------------
+// FILE TABLE
+// ------------------------------
+
+enum CgroupFile : uint8_t { CpuStat, MemoryCurrent, MemoryMax, MemoryEvents, IoStat, PidsCurrent, CgroupFiles };
+
+static const char* const cgroupFileNames[CgroupFiles] = {
+    "cpu.stat", "memory.current", "memory.max", "memory.events", "io.stat", "pids.current"};
+
+// One cgroup directory with its held files and the counters of the previous read
+struct CgroupNode {
+    CgroupStats last;
+    ProcHandle files[CgroupFiles];
+    bool open[CgroupFiles] = {};
+};
+
+struct CgroupTable {
+    uint64_t generation = 0;  // procSourceGeneration() the table was built for
+    std::string root;         // where the unified hierarchy is mounted
+    std::vector<CgroupNode> nodes;
+    int64_t scanTimeMs = 0;
+    int64_t lastTimeMs = 0;
+    bool rescan = false;      // a cgroup went away since the last walk
+};
+
+static CgroupTable table;
+
+// Walks the tree below `path`. A cgroup seen in the previous walk keeps its held files and
+// counters; the others open theirs, and only the files in the listing are tried
+static void walk(const std::string& path, int depth, std::vector<std::string>& names,
+                 std::unordered_map<std::string, CgroupNode>& previous) {
+    if (table.nodes.size() >= maxCgroups) return;
+    std::string dir = path == "/" ? table.root : table.root + path;
+    if (!procListDir(dir, names)) return;
+
+    CgroupNode node;
+    auto found = previous.find(path);
+    if (found != previous.end()) {
+        node = std::move(found->second);
+        previous.erase(found);
+    } else {
+        node.last.path = path;
+    }
+    node.last.depth = depth;
+
+    // Files come and go as the parent enables and disables controllers
+    for (int f = 0; f < CgroupFiles; f++) {
+        bool listed = std::find(names.begin(), names.end(), cgroupFileNames[f]) != names.end();
+        if (listed == node.open[f]) continue;
+        node.open[f] = listed && procOpenHandle(dir + "/" + cgroupFileNames[f], node.files[f]);
+        if (!node.open[f]) procCloseHandle(node.files[f]);
+    }
+    node.last.hasMemory = node.open[MemoryCurrent];
+    node.last.hasPids = node.open[PidsCurrent];
+    table.nodes.push_back(std::move(node));
+
+    // Child cgroups are the subdirectories; their names may look like interface files ("cpu.slice")
+    std::vector<std::string> children;
+    procListSubdirs(dir, children);
+    std::sort(children.begin(), children.end());
+    for (const std::string& child : children)
+        walk(path == "/" ? "/" + child : path + "/" + child, depth + 1, names, previous);
+}
+
+static void closeNode(CgroupNode& node) {
+    for (int f = 0; f < CgroupFiles; f++) {
+        procCloseHandle(node.files[f]);
+        node.open[f] = false;
+    }
+}
+
+// Walks the tree again, keeping the cgroups that are still there and closing the files of
+// those that went away. Held files reopen themselves after a source change (--root, an
+// archive), but the hierarchy may be mounted elsewhere in the new source
+static void discover(int64_t timeMs) {
+    if (table.generation != procSourceGeneration() || table.root.empty()) {
+        std::string root = table.root;
+        table.root.clear();
+        // Hybrid hosts mount v1 controllers at /sys/fs/cgroup and the unified hierarchy below it
+        std::string controllers;
+        for (const char* candidate : {"/sys/fs/cgroup", "/sys/fs/cgroup/unified"}) {
+            if (procReadFile(std::string(candidate) + "/cgroup.controllers", controllers)) {
+                table.root = candidate;
+                break;
+            }
+        }
+        if (table.root != root) {
+            for (CgroupNode& node : table.nodes) closeNode(node);
+            table.nodes.clear();
+        }
+        table.generation = procSourceGeneration();
+    }
+    table.scanTimeMs = timeMs;
+    table.rescan = false;
+
+    std::unordered_map<std::string, CgroupNode> previous;
+    previous.reserve(table.nodes.size());
+    for (CgroupNode& node : table.nodes) {
+        std::string path = node.last.path;
+        previous.emplace(std::move(path), std::move(node));
+    }
+    table.nodes.clear();
+
+    if (!table.root.empty()) {
+        raiseFdLimit();
+        std::vector<std::string> names;
+        walk("/", 0, names, previous);
+    }
+    for (auto& entry : previous) closeNode(entry.second);
+}
+
+// ------------------------------
+// READING
+// ------------------------------
+
+// Value of a "key value" line, as in cpu.stat and memory.events; 0 if missing
+static uint64_t lineValue(const std::string& text, const char* key) {
+    size_t len = strlen(key);
+    for (size_t pos = 0; pos < text.size();) {
+        if (text.compare(pos, len, key) == 0 && text[pos + len] == ' ')
+            return strtoull(text.c_str() + pos + len + 1, nullptr, 10);
+        pos = text.find('\n', pos);
+        if (pos == std::string::npos) break;
+        pos++;
+    }
+    return 0;
+}
+
+// Sum of one "key=value" field over the device lines of io.stat
+static uint64_t ioStatSum(const std::string& text, const char* key) {
+    uint64_t sum = 0;
+    size_t len = strlen(key);
+    for (const char* p = strstr(text.c_str(), key); p; p = strstr(p + len, key))
+        if (p > text.c_str() && p[-1] == ' ') sum += strtoull(p + len, nullptr, 10);
+    return sum;
+}
+
+// Per second increase, or 0 if the counter went back (a new cgroup under a reused name)
+static float ratePerSecond(uint64_t now, uint64_t before, double intervalMs) {
+    return now >= before ? (float)((now - before) * 1000.0 / intervalMs) : 0.0f;
+}
+
+CgroupInfo readCgroups(int64_t timeMs) {
+    PROFILE_ZONE("readCgroups");
+    if (table.generation != procSourceGeneration() || table.rescan || timeMs - table.scanTimeMs >= cgroupScanIntervalMs ||
+        timeMs < table.scanTimeMs)
+        discover(timeMs);
+
+    CgroupInfo info;
+    if (table.nodes.empty()) return info;
+    info.found = true;
+    double intervalMs = table.lastTimeMs > 0 && timeMs > table.lastTimeMs ? (double)(timeMs - table.lastTimeMs) : 0.0;
+    info.intervalMs = (float)intervalMs;
+    table.lastTimeMs = timeMs;
+
+    static std::string buffer;  // keeps its capacity between rounds
+    info.groups.reserve(table.nodes.size());
+    for (CgroupNode& node : table.nodes) {
+        CgroupStats g;
+        g.path = node.last.path;
+        g.depth = node.last.depth;
+        g.hasMemory = node.last.hasMemory;
+        g.hasPids = node.last.hasPids;
+
+        // cpu.stat is in every cgroup but the root of older kernels, so failing to read it
+        // means the cgroup was removed; if one of the same name replaced it, the walk reopens
+        if (node.open[CpuStat] && !procReadHandle(node.files[CpuStat], buffer)) {
+            closeNode(node);
+            table.rescan = true;
+            continue;
+        }
+        if (!node.open[CpuStat]) buffer.clear();
+        g.usageUsec = lineValue(buffer, "usage_usec");
+        g.userUsec = lineValue(buffer, "user_usec");
+        g.systemUsec = lineValue(buffer, "system_usec");
+        g.periods = lineValue(buffer, "nr_periods");
+        g.throttledPeriods = lineValue(buffer, "nr_throttled");
+        g.throttledUsec = lineValue(buffer, "throttled_usec");
+
+        if (node.open[MemoryCurrent] && procReadHandle(node.files[MemoryCurrent], buffer))
+            g.memoryBytes = strtoull(buffer.c_str(), nullptr, 10);
+        if (node.open[MemoryMax] && procReadHandle(node.files[MemoryMax], buffer))
+            g.memoryMaxBytes = strtoull(buffer.c_str(), nullptr, 10);  // "max" parses as 0
+        if (node.open[MemoryEvents] && procReadHandle(node.files[MemoryEvents], buffer)) {
+            g.memoryHighEvents = lineValue(buffer, "high");
+            g.memoryMaxEvents = lineValue(buffer, "max");
+            g.oomKills = lineValue(buffer, "oom_kill");
+        }
+        if (node.open[IoStat] && procReadHandle(node.files[IoStat], buffer)) {
+            g.ioReadBytes = ioStatSum(buffer, "rbytes=");
+            g.ioWriteBytes = ioStatSum(buffer, "wbytes=");
+            g.ioReads = ioStatSum(buffer, "rios=");
+            g.ioWrites = ioStatSum(buffer, "wios=");
+        }
+        if (node.open[PidsCurrent] && procReadHandle(node.files[PidsCurrent], buffer))
+            g.pids = strtoull(buffer.c_str(), nullptr, 10);
+
+        // A cgroup new since the previous walk has nothing to compare against yet
+        const CgroupStats& last = node.last;
+        if (intervalMs > 0.0 && last.usageUsec > 0) {
+            // usec over ms * 1000, as a percentage
+            if (g.usageUsec >= last.usageUsec) g.cpuPercent = (float)((g.usageUsec - last.usageUsec) / (intervalMs * 10.0));
+            if (g.periods > last.periods && g.throttledPeriods >= last.throttledPeriods)
+                g.throttledPercent = 100.0f * (g.throttledPeriods - last.throttledPeriods) / (g.periods - last.periods);
+            g.ioReadRate = ratePerSecond(g.ioReadBytes, last.ioReadBytes, intervalMs);
+            g.ioWriteRate = ratePerSecond(g.ioWriteBytes, last.ioWriteBytes, intervalMs);
+        }
+        node.last = g;
+        info.groups.push_back(std::move(g));
+    }
+    return info;
+}
+
+// ------------------------------
+// UI
+// ------------------------------
+
+enum CgroupColumn {
+    CgName, CgCpu, CgThrottled, CgMemory, CgLimit, CgOomKills, CgReadRate, CgWriteRate, CgPids, CgProcesses,
+    CgColumns
+};
+
+// Processes of each cgroup path in the current snapshot, rebuilt when it changes
+struct CgroupMembers {
+    uint64_t sequence = 0;
+    std::unordered_map<std::string, std::vector<int>> processes;  // indices into the snapshot's processes
+};
+
+static CgroupMembers members;
+
+static void updateMembers(const Snapshot& snap) {
+    if (members.sequence == snapshotSequence()) return;
+    members.sequence = snapshotSequence();
+    for (auto& entry : members.processes) entry.second.clear();
+    for (size_t i = 0; i < snap.processes.size(); i++)
+        if (!snap.processes[i].cgroup.empty()) members.processes[snap.processes[i].cgroup].push_back((int)i);
+}
+
+static const std::vector<int>* membersOf(const std::string& path) {
+    auto found = members.processes.find(path);
+    return found == members.processes.end() || found->second.empty() ? nullptr : &found->second;
+}
+
+// One tree row for groups[index]; returns the index after its subtree
+static size_t renderCgroupRow(const Snapshot& snap, size_t index) {
+    const std::vector<CgroupStats>& groups = snap.cgroups.groups;
+    const CgroupStats& g = groups[index];
+    size_t end = index + 1;
+    while (end < groups.size() && groups[end].depth > g.depth) end++;
+    const std::vector<int>* processes = membersOf(g.path);
+
+    ImGui::TableNextRow();
+    ImGui::TableSetColumnIndex(CgName);
+    ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_SpanFullWidth;
+    if (g.depth == 0) flags |= ImGuiTreeNodeFlags_DefaultOpen;
+    if (end == index + 1 && !processes) flags |= ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen;
+    const char* name = g.depth == 0 ? "/" : g.path.c_str() + g.path.rfind('/') + 1;
+    bool open = ImGui::TreeNodeEx(g.path.c_str(), flags, "%s", name);
+
+    ImGui::TableSetColumnIndex(CgCpu); ImGui::Text("%.1f%%", g.cpuPercent);
+    ImGui::TableSetColumnIndex(CgThrottled);
+    if (g.periods == 0) ImGui::TextDisabled("-");
+    else ImGui::Text("%.1f%%", g.throttledPercent);
+    ImGui::TableSetColumnIndex(CgMemory);
+    if (g.hasMemory) ImGui::Text("%s", formatBytes(g.memoryBytes).c_str());
+    else ImGui::TextDisabled("-");
+    ImGui::TableSetColumnIndex(CgLimit);
+    if (g.hasMemory && g.memoryMaxBytes > 0) ImGui::Text("%s", formatBytes(g.memoryMaxBytes).c_str());
+    else ImGui::TextDisabled("-");
+    ImGui::TableSetColumnIndex(CgOomKills);
+    if (g.oomKills > 0) ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%llu", (unsigned long long)g.oomKills);
+    else if (g.hasMemory) ImGui::Text("0");
+    else ImGui::TextDisabled("-");
+    ImGui::TableSetColumnIndex(CgReadRate); ImGui::Text("%s/s", formatBytes((uint64_t)g.ioReadRate).c_str());
+    ImGui::TableSetColumnIndex(CgWriteRate); ImGui::Text("%s/s", formatBytes((uint64_t)g.ioWriteRate).c_str());
+    ImGui::TableSetColumnIndex(CgPids);
+    if (g.hasPids) ImGui::Text("%llu", (unsigned long long)g.pids);
+    else ImGui::TextDisabled("-");
+    ImGui::TableSetColumnIndex(CgProcesses); ImGui::Text("%zu", processes ? processes->size() : (size_t)0);
+
+    if (!open || (flags & ImGuiTreeNodeFlags_NoTreePushOnOpen)) return end;
+    for (size_t child = index + 1; child < end;) child = renderCgroupRow(snap, child);
+
+    // The processes directly in this cgroup, below its children
+    if (processes) {
+        for (int i : *processes) {
+            const ProcessSample& p = snap.processes[i];
+            ImGui::TableNextRow();
+            ImGui::TableSetColumnIndex(CgName);
+            ImGui::TreeNodeEx((void*)(intptr_t)p.pid, ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen |
+                              ImGuiTreeNodeFlags_Bullet, "%d %s", p.pid, p.name.c_str());
+            ImGui::TableSetColumnIndex(CgCpu); ImGui::Text("%.1f%%", p.cpuPercent);
+        }
+    }
+    ImGui::TreePop();
+    return end;
+}
+
+void renderCgroupsTab() {
+    PROFILE_ZONE("renderCgroupsTab");
+    const Snapshot& snap = currentSnapshot();
+    if (!snap.cgroups.found) {
+        ImGui::Text("No cgroup v2 hierarchy (/sys/fs/cgroup/cgroup.controllers not found).");
+        return;
+    }
+    updateMembers(snap);
+    ImGui::Text("%zu cgroups", snap.cgroups.groups.size());
+    ImGui::SameLine();
+    ImGui::TextDisabled("(each row includes its descendants; processes are those directly in it)");
+
+    ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY |
+                            ImGuiTableFlags_Resizable | ImGuiTableFlags_Hideable;
+    if (!ImGui::BeginTable("CgroupTable", CgColumns, flags)) return;
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableSetupColumn("Cgroup", ImGuiTableColumnFlags_NoHide);
+    ImGui::TableSetupColumn("CPU %");
+    ImGui::TableSetupColumn("Throttled");
+    ImGui::TableSetupColumn("Memory");
+    ImGui::TableSetupColumn("Limit");
+    ImGui::TableSetupColumn("OOM kills");
+    ImGui::TableSetupColumn("Disk read/s");
+    ImGui::TableSetupColumn("Disk write/s");
+    ImGui::TableSetupColumn("Pids");
+    ImGui::TableSetupColumn("Processes");
+    ImGui::TableHeadersRow();
+    for (size_t index = 0; index < snap.cgroups.groups.size();) index = renderCgroupRow(snap, index);
+    ImGui::EndTable();
+}
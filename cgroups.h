@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ------------------------------
+// CGROUP V2 HIERARCHY
+// ------------------------------
+//
+// The unified hierarchy under /sys/fs/cgroup (or /sys/fs/cgroup/unified on
+// a hybrid host): systemd slices, services and container scopes, each with
+// the kernel's own accounting of everything in it, descendants included. So
+// a slice's CPU, memory and I/O come from a handful of its files instead of
+// a sum over the stat files of its processes. The tree is walked every
+// cgroupScanIntervalMs; its counter files are held open in between.
+
+struct CgroupStats {
+    std::string path;                // as in /proc/[pid]/cgroup, "/" is the root
+    int depth = 0;                   // 0 = the root
+    bool hasMemory = false;          // memory and pids controllers enabled by the parent
+    bool hasPids = false;
+    uint64_t usageUsec = 0;          // cpu.stat
+    uint64_t userUsec = 0;
+    uint64_t systemUsec = 0;
+    uint64_t periods = 0;            // cpu.max enforcement periods, and those that ran out of quota
+    uint64_t throttledPeriods = 0;
+    uint64_t throttledUsec = 0;
+    uint64_t memoryBytes = 0;        // memory.current
+    uint64_t memoryMaxBytes = 0;     // memory.max, 0 = "max"
+    uint64_t memoryHighEvents = 0;   // memory.events: reclaim forced by memory.high,
+    uint64_t memoryMaxEvents = 0;    // allocations that hit memory.max, and OOM kills
+    uint64_t oomKills = 0;
+    uint64_t ioReadBytes = 0;        // io.stat, summed over devices
+    uint64_t ioWriteBytes = 0;
+    uint64_t ioReads = 0;
+    uint64_t ioWrites = 0;
+    uint64_t pids = 0;               // pids.current
+    float cpuPercent = 0.0f;         // over the interval, 100 is one cpu
+    float throttledPercent = 0.0f;   // of the enforcement periods in the interval
+    float ioReadRate = 0.0f;         // bytes per second
+    float ioWriteRate = 0.0f;
+};
+
+struct CgroupInfo {
+    bool found = false;
+    float intervalMs = 0.0f;
+    std::vector<CgroupStats> groups; // depth first, children by name, the root first
+};
+
+// Rates are relative to the previous call's timeMs
+CgroupInfo readCgroups(int64_t timeMs);
+
+// The tree with usage, throttling, memory, I/O and the processes in each cgroup
+void renderCgroupsTab();
@@ -0,0 +1,41 @@
+#include "clock.h"
+#include <ctime>
+
+// ------------------------------
+// SYSTEM CLOCK
+// ------------------------------
+
+class SystemClock : public Clock {
+public:
+    double monotonicSeconds() override {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec + ts.tv_nsec / 1e9;
+    }
+
+    int64_t wallMs() override {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+    }
+};
+
+static SystemClock realClock;
+static Clock* activeClock = &realClock;
+
+void setClock(Clock* clock) {
+    activeClock = clock ? clock : &realClock;
+}
+
+Clock* systemClock() {
+    return &realClock;
+}
+
+// Return current monotonic time in seconds
+double getTimeSeconds() {
+    return activeClock->monotonicSeconds();
+}
+
+int64_t clockWallMs() {
+    return activeClock->wallMs();
+}
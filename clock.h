@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+
+// ------------------------------
+// CLOCK
+// ------------------------------
+//
+// The snapshot loop, the replay and the history store take time from the
+// active clock. Swapping in a SimClock lets a benchmark or a test step through
+// hours of sampling over fixture data without waiting for it.
+
+class Clock {
+public:
+    virtual ~Clock() {}
+
+    // Seconds on a monotonic clock with an arbitrary origin
+    virtual double monotonicSeconds() = 0;
+
+    // Wall-clock time in ms since the Unix epoch
+    virtual int64_t wallMs() = 0;
+};
+
+// Simulated time: stands still until advanced
+class SimClock : public Clock {
+public:
+    // Defaults to 2023-11-14 22:13:20 UTC, the btime of generated fixtures
+    explicit SimClock(int64_t startWallMs = 1700000000000) : startMs(startWallMs) {}
+
+    double monotonicSeconds() override { return elapsed; }
+    int64_t wallMs() override { return startMs + (int64_t)(elapsed * 1000.0); }
+
+    void advance(double seconds) { elapsed += seconds; }
+
+private:
+    int64_t startMs;
+    double elapsed = 0.0;
+};
+
+// nullptr restores the system clock
+void setClock(Clock* clock);
+Clock* systemClock();
+
+// Time from the active clock
+double getTimeSeconds();
+int64_t clockWallMs();
@@ -1,7 +1,14 @@
 #include "header.h"
+#include "plot.h"
+#include "heatmap.h"
+#include "snapshot.h"
+#include "procfs.h"
+#include "profiler.h"
 #include <deque>
 #include <vector>
-#include <fstream>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <string>
 
 // Platform detection for OS-specific includes
@@ -32,51 +39,180 @@ static float yScaleCPU = 100.0f;
 // GRAPH DATA STORAGE
 // ------------------------------
 
-// Deque holds recent CPU usage values (acts like a rolling buffer)
-static std::deque<float> cpuUsageHistory;
-
-// Maximum number of samples stored in the graph (roughly equivalent to how wide the graph is)
-static const int maxSamples = 100;
+// Maximum number of samples stored in the graph: one per snapshot, so 24 h at the
+// default 500 ms sampleIntervalMs; the plot reduces them to about two points per pixel
+static const int maxSamples = 172800;
+
+// Rolling buffer of recent CPU usage values
+static PlotHistory cpuUsageHistory(maxSamples);
+
+// Time of the last sample pushed to the graph
+static double lastCpuSampleTime = 0.0;
+
+// Per-state shares of recent snapshots for the stacked graph; only as many
+// as the graph has columns are drawn
+static const size_t maxStateSamples = 1200;
+static std::deque<CpuStates> cpuStateHistory;
+
+// Busy % per core over time, one texture column per snapshot
+static HeatmapTexture coreHeatmap(600);
+static std::vector<float> coreBusy;
+
+// Steal and guest share of each snapshot, for the virtualization graphs
+static PlotHistory stealHistory(maxStateSamples);
+static PlotHistory guestHistory(maxStateSamples);
+
+// Snapshot sequence/epoch the graph last saw
+static uint64_t lastCpuSequence = 0;
+static uint64_t lastCpuEpoch = 0;
+
+// States drawn in the stacked graphs, bottom to top (idle is left empty)
+struct CpuStateStyle {
+    const char* name;
+    float CpuStates::* field;
+    ImU32 color;
+};
+
+static const CpuStateStyle cpuStateStyles[] = {
+    {"user", &CpuStates::user, IM_COL32(80, 180, 90, 255)},
+    {"nice", &CpuStates::nice, IM_COL32(60, 130, 200, 255)},
+    {"system", &CpuStates::system, IM_COL32(220, 80, 70, 255)},
+    {"iowait", &CpuStates::iowait, IM_COL32(230, 190, 60, 255)},
+    {"irq", &CpuStates::irq, IM_COL32(200, 110, 200, 255)},
+    {"softirq", &CpuStates::softirq, IM_COL32(150, 90, 210, 255)},
+    {"steal", &CpuStates::steal, IM_COL32(140, 140, 140, 255)},
+    {"guest", &CpuStates::guest, IM_COL32(70, 200, 200, 255)},
+};
 
 // ------------------------------
 // CPU USAGE FUNCTION (Cross-platform)
 // ------------------------------
 
-// This function returns the current CPU usage in percentage
-float getCpuUsagePercent() {
 #ifdef __linux__
-    // Static variables retain values between calls to calculate deltas
-    static long long lastIdle = 0, lastTotal = 0;
-
-    // Open /proc/stat (Linux-only virtual file with CPU stats)
-    std::ifstream file("/proc/stat");
-    if (!file.is_open()) return 0.0f; // Return 0 if file can’t be opened
+// Parses the counters of one `cpu` line: user nice system idle iowait irq softirq steal guest guest_nice
+// (older kernels stop early; missing fields stay 0)
+static void parseCpuLine(const char* p, CPUStats& stat) {
+    long long int* fields[] = {&stat.user, &stat.nice, &stat.system, &stat.idle, &stat.iowait,
+                               &stat.irq, &stat.softirq, &stat.steal, &stat.guest, &stat.guestNice};
+    for (long long int* field : fields) {
+        char* end;
+        *field = strtoll(p, &end, 10);
+        if (end == p) break;
+        p = end;
+    }
+}
 
-    std::string cpu;
+// Reads the `cpu` and `cpuN` lines of /proc/stat in one pass, and the scheduler counters after them
+CPUStats readCpuStats(std::vector<CPUStats>* cores, ProcStatCounters* counters) {
+    PROFILE_ZONE("readCpuStats");
     CPUStats stat = {}; // Struct declared in header.h to hold values from /proc/stat
+    if (cores) cores->clear();
+    if (counters) *counters = {};
+
+    // Read /proc/stat (Linux-only virtual file with CPU stats)
+    std::string contents;
+    if (!procReadFile("/proc/stat", contents)) return stat; // All zeros if file can’t be read
+
+    // The cpu lines come first; offline cpus have no line, so their slot stays zero
+    const char* line = contents.c_str();
+    while (strncmp(line, "cpu", 3) == 0) {
+        const char* p = line + 3;
+        if (*p == ' ') {
+            parseCpuLine(p, stat);
+            if (!cores && !counters) return stat;
+        } else if (cores) {
+            char* end;
+            long cpu = strtol(p, &end, 10);
+            if (end != p && cpu >= 0 && cpu < 65536) {
+                if ((size_t)cpu >= cores->size()) cores->resize(cpu + 1, CPUStats{});
+                parseCpuLine(end, (*cores)[cpu]);
+            }
+        }
+        line = strchr(p, '\n');
+        if (!line) return stat;
+        line++;
+    }
 
-    // Read values: cpu user nice system idle iowait irq softirq steal
-    file >> cpu >> stat.user >> stat.nice >> stat.system >> stat.idle
-         >> stat.iowait >> stat.irq >> stat.softirq >> stat.steal;
+    // intr and softirq can be kilobytes long on big machines; only the line starts are looked at
+    while (counters && *line) {
+        if (strncmp(line, "ctxt ", 5) == 0) counters->ctxt = strtoull(line + 5, nullptr, 10);
+        else if (strncmp(line, "processes ", 10) == 0) counters->forks = strtoull(line + 10, nullptr, 10);
+        else if (strncmp(line, "procs_running ", 14) == 0) counters->procsRunning = atoi(line + 14);
+        else if (strncmp(line, "procs_blocked ", 14) == 0) counters->procsBlocked = atoi(line + 14);
+        line = strchr(line, '\n');
+        if (!line) break;
+        line++;
+    }
+    return stat;
+}
 
-    // Calculate total and idle times
-    long long idle = stat.idle + stat.iowait;
-    long long nonIdle = stat.user + stat.nice + stat.system + stat.irq + stat.softirq + stat.steal;
-    long long total = idle + nonIdle;
+// Share of each state between two samples, in percent
+CpuStates cpuStatesBetween(const CPUStats& prev, const CPUStats& curr) {
+    CpuStates states = {};
+
+    // Counters can step back (iowait does on some kernels), so clamp at 0
+    auto delta = [](long long int a, long long int b) { return b > a ? (double)(b - a) : 0.0; };
+    double guest = delta(prev.guest, curr.guest);
+    double guestNice = delta(prev.guestNice, curr.guestNice);
+    double user = std::max(0.0, delta(prev.user, curr.user) - guest);
+    double nice = std::max(0.0, delta(prev.nice, curr.nice) - guestNice);
+    double system = delta(prev.system, curr.system);
+    double idle = delta(prev.idle, curr.idle);
+    double iowait = delta(prev.iowait, curr.iowait);
+    double irq = delta(prev.irq, curr.irq);
+    double softirq = delta(prev.softirq, curr.softirq);
+    double steal = delta(prev.steal, curr.steal);
+
+    double total = user + nice + system + idle + iowait + irq + softirq + steal + guest + guestNice;
+    if (total <= 0.0) return states;
+
+    double scale = 100.0 / total;
+    states.user = user * scale;
+    states.nice = nice * scale;
+    states.system = system * scale;
+    states.iowait = iowait * scale;
+    states.irq = irq * scale;
+    states.softirq = softirq * scale;
+    states.steal = steal * scale;
+    states.guest = (guest + guestNice) * scale;
+    states.idle = idle * scale;
+    return states;
+}
 
-    // Calculate change since last call
-    long long deltaTotal = total - lastTotal;
-    long long deltaIdle = idle - lastIdle;
+// CPU usage in percent between two /proc/stat samples. Steal is time the
+// hypervisor gave to someone else: part of the total, but not busy time
+float cpuUsageBetween(const CPUStats& prev, const CPUStats& curr) {
+    // Calculate total and not-busy times
+    long long prevIdle = prev.idle + prev.iowait + prev.steal;
+    long long prevTotal = prevIdle + prev.user + prev.nice + prev.system + prev.irq + prev.softirq;
+    long long idle = curr.idle + curr.iowait + curr.steal;
+    long long total = idle + curr.user + curr.nice + curr.system + curr.irq + curr.softirq;
 
-    // Save current values for next comparison
-    lastTotal = total;
-    lastIdle = idle;
+    // Calculate change since the previous sample
+    long long deltaTotal = total - prevTotal;
+    long long deltaIdle = idle - prevIdle;
 
     // Avoid divide-by-zero
     if (deltaTotal == 0) return 0.0f;
 
     // Calculate CPU usage as percent
     return 100.0f * (deltaTotal - deltaIdle) / deltaTotal;
+}
+#endif
+
+// This function returns the current CPU usage in percentage
+float getCpuUsagePercent() {
+    PROFILE_ZONE("getCpuUsagePercent");
+#ifdef __linux__
+    // Static sample retains values between calls to calculate deltas
+    static CPUStats last = {};
+
+    CPUStats stat = readCpuStats();
+    float usage = cpuUsageBetween(last, stat);
+
+    // Save current values for next comparison
+    last = stat;
+    return usage;
 
 #elif _WIN32
     // Windows version using GetSystemTimes()
@@ -144,12 +280,165 @@ float getCpuUsagePercent() {
 #endif
 }
 
+// ------------------------------
+// STEAL TIME WINDOW
+// ------------------------------
+
+// Steal averaged over this long flags a noisy neighbour once it reaches the threshold
+static const int64_t stealWindowMs = 60000;
+static const float noisyStealPercent = 10.0f;
+
+struct StealSample {
+    int64_t timeMs;
+    float intervalMs;
+    float steal;
+    float guest;
+    std::vector<float> cores;
+};
+
+static std::deque<StealSample> stealSamples;
+
+StealInfo trackSteal(const CpuStates& total, const std::vector<CpuStates>& cores, int64_t timeMs) {
+    StealInfo info;
+    // A jump back in time (a new archive or fixture round) restarts the window
+    if (!stealSamples.empty() && timeMs <= stealSamples.back().timeMs) stealSamples.clear();
+    float intervalMs = stealSamples.empty() ? 0.0f : (float)(timeMs - stealSamples.back().timeMs);
+
+    StealSample sample{timeMs, intervalMs, total.steal, total.guest, {}};
+    sample.cores.reserve(cores.size());
+    for (const CpuStates& core : cores) sample.cores.push_back(core.steal);
+    stealSamples.push_back(std::move(sample));
+    // Drop samples whose interval starts before the window; the newest always stays
+    while (stealSamples.size() > 1 &&
+           stealSamples.front().timeMs - stealSamples.front().intervalMs < timeMs - stealWindowMs)
+        stealSamples.pop_front();
+
+    // Each sample's shares cover the interval before it, so weight by that
+    double covered = 0.0, steal = 0.0, guest = 0.0;
+    std::vector<double> coreSteal(cores.size(), 0.0);
+    for (const StealSample& s : stealSamples) {
+        covered += s.intervalMs;
+        steal += s.steal * s.intervalMs;
+        guest += s.guest * s.intervalMs;
+        for (size_t i = 0; i < s.cores.size() && i < coreSteal.size(); i++) coreSteal[i] += s.cores[i] * s.intervalMs;
+    }
+    if (covered <= 0.0) return info;
+
+    info.windowSeconds = (float)(covered / 1000.0);
+    info.percent = (float)(steal / covered);
+    info.guestPercent = (float)(guest / covered);
+    info.corePercent.resize(cores.size());
+    for (size_t i = 0; i < cores.size(); i++) {
+        info.corePercent[i] = (float)(coreSteal[i] / covered);
+        if (info.worstCore < 0 || info.corePercent[i] > info.corePercent[info.worstCore]) info.worstCore = (int)i;
+    }
+    // Wait for half a window so one slow sample doesn't raise the flag
+    info.noisyNeighbour = covered >= stealWindowMs / 2 && info.percent >= noisyStealPercent;
+    return info;
+}
+
+// ------------------------------
+// STACKED STATE DRAWING
+// ------------------------------
+
+// Same meaning as the CPU % graph: iowait and steal count as not busy
+static float busyPercent(const CpuStates& s) {
+    return 100.0f - s.idle - s.iowait - s.steal;
+}
+
+// Stacks the non-idle states of `s` upwards from yBottom in [x0, x1)
+static void drawStateColumn(ImDrawList* draw, const CpuStates& s, float x0, float x1, float yBottom, float height) {
+    float y = yBottom;
+    for (const CpuStateStyle& style : cpuStateStyles) {
+        float h = s.*style.field / 100.0f * height;
+        if (h <= 0.0f) continue;
+        draw->AddRectFilled(ImVec2(x0, y - h), ImVec2(x1, y), style.color);
+        y -= h;
+    }
+}
+
+static void stateTooltip(const char* title, const CpuStates& s) {
+    ImGui::BeginTooltip();
+    ImGui::Text("%s: %.1f%% busy", title, busyPercent(s));
+    for (const CpuStateStyle& style : cpuStateStyles)
+        ImGui::TextColored(ImGui::ColorConvertU32ToFloat4(style.color), "%-8s %5.1f%%", style.name, s.*style.field);
+    ImGui::Text("%-8s %5.1f%%", "idle", s.idle);
+    ImGui::EndTooltip();
+}
+
+// One 2 px column per snapshot, newest on the right
+static void drawStateHistory(const std::deque<CpuStates>& history, float height) {
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    ImVec2 size(ImGui::GetContentRegionAvail().x, height);
+    ImGui::Dummy(size);
+    ImDrawList* draw = ImGui::GetWindowDrawList();
+    draw->AddRectFilled(origin, ImVec2(origin.x + size.x, origin.y + size.y), ImGui::GetColorU32(ImGuiCol_FrameBg));
+
+    size_t columns = std::max(1, (int)(size.x / 2.0f));
+    size_t n = std::min(history.size(), columns);
+    float columnWidth = size.x / columns;
+    float left = origin.x + (columns - n) * columnWidth;
+    for (size_t i = 0; i < n; i++) {
+        float x0 = left + i * columnWidth;
+        drawStateColumn(draw, history[history.size() - n + i], x0, x0 + columnWidth, origin.y + size.y, size.y);
+    }
+
+    if (n > 0 && ImGui::IsItemHovered()) {
+        float mouseX = ImGui::GetIO().MousePos.x;
+        if (mouseX >= left) {
+            size_t i = std::min(n - 1, (size_t)((mouseX - left) / columnWidth));
+            stateTooltip("CPU", history[history.size() - n + i]);
+        }
+    }
+}
+
+// One stacked bar per core, wrapped into rows; stays a few thousand
+// rectangles even at 256 cores
+static void drawCoreBars(const std::vector<CpuStates>& cores) {
+    const float rowHeight = 40.0f;
+    const float rowGap = 4.0f;
+    float avail = ImGui::GetContentRegionAvail().x;
+    float barWidth = std::max(3.0f, std::min(16.0f, avail / cores.size()));
+    size_t perRow = std::max(1, (int)(avail / barWidth));
+    size_t rows = (cores.size() + perRow - 1) / perRow;
+
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    ImGui::Dummy(ImVec2(avail, rows * (rowHeight + rowGap)));
+    ImDrawList* draw = ImGui::GetWindowDrawList();
+    ImU32 background = ImGui::GetColorU32(ImGuiCol_FrameBg);
+
+    for (size_t row = 0; row < rows; row++) {
+        float top = origin.y + row * (rowHeight + rowGap);
+        size_t count = std::min(perRow, cores.size() - row * perRow);
+        draw->AddRectFilled(ImVec2(origin.x, top), ImVec2(origin.x + count * barWidth, top + rowHeight), background);
+        for (size_t col = 0; col < count; col++) {
+            float x0 = origin.x + col * barWidth;
+            // Leave a 1 px gap between bars once they're wide enough to see it
+            float x1 = x0 + barWidth - (barWidth >= 4.0f ? 1.0f : 0.0f);
+            drawStateColumn(draw, cores[row * perRow + col], x0, x1, top + rowHeight, rowHeight);
+        }
+    }
+
+    if (ImGui::IsItemHovered()) {
+        ImVec2 mouse = ImGui::GetIO().MousePos;
+        size_t col = (size_t)((mouse.x - origin.x) / barWidth);
+        size_t row = (size_t)((mouse.y - origin.y) / (rowHeight + rowGap));
+        size_t core = row * perRow + col;
+        if (col < perRow && core < cores.size()) {
+            char title[16];
+            snprintf(title, sizeof(title), "cpu%zu", core);
+            stateTooltip(title, cores[core]);
+        }
+    }
+}
+
 // ------------------------------
 // UI RENDERING FUNCTION FOR CPU TAB
 // ------------------------------
 
 // This function draws the CPU tab with controls and the graph
 void renderCpuTab() {
+    PROFILE_ZONE("renderCpuTab");
     ImGui::Text("CPU Usage");       // Label
     ImGui::Separator();             // Horizontal line
 
@@ -167,23 +456,39 @@ void renderCpuTab() {
     // UPDATE GRAPH DATA
     // ------------------
 
-    if (!pauseCPU) {
-        float usage = getCpuUsagePercent();     // Get current CPU usage
-        cpuUsageHistory.push_back(usage);       // Store new value
+    // Start over when the replay timeline jumps
+    if (snapshotEpoch() != lastCpuEpoch) {
+        lastCpuEpoch = snapshotEpoch();
+        cpuUsageHistory.clear();
+        cpuStateHistory.clear();
+        coreHeatmap.clear();
+        stealHistory.clear();
+        guestHistory.clear();
+    }
 
-        // Keep deque size within maxSamples
-        if (cpuUsageHistory.size() > maxSamples) {
-            cpuUsageHistory.pop_front();
-        }
+    // Push each new snapshot, at most at the rate chosen with the FPS slider
+    double now = ImGui::GetTime();
+    if (!pauseCPU && snapshotSequence() != lastCpuSequence && now - lastCpuSampleTime >= 1.0 / fpsCPU) {
+        lastCpuSampleTime = now;
+        lastCpuSequence = snapshotSequence();
+        cpuUsageHistory.push(currentSnapshot().cpuPercent); // Store new value
+        cpuStateHistory.push_back(currentSnapshot().cpuStates);
+        if (cpuStateHistory.size() > maxStateSamples) cpuStateHistory.pop_front();
+        stealHistory.push(currentSnapshot().cpuStates.steal);
+        guestHistory.push(currentSnapshot().cpuStates.guest);
+
+        const std::vector<CpuStates>& cores = currentSnapshot().coreStates;
+        coreBusy.resize(cores.size());
+        for (size_t i = 0; i < cores.size(); i++) coreBusy[i] = busyPercent(cores[i]) / 100.0f;
+        coreHeatmap.push(coreBusy);
     }
 
     // ------------------
     // DRAW GRAPH
     // ------------------
 
-    std::vector<float> values(cpuUsageHistory.begin(), cpuUsageHistory.end()); // Convert to vector
-    if (!values.empty()) {
-        ImGui::PlotLines("CPU %", values.data(), values.size(), 0, nullptr, 0.0f, yScaleCPU, graphSize);
+    if (!cpuUsageHistory.empty()) {
+        cpuUsageHistory.plot("CPU %", 0.0f, yScaleCPU, graphSize);
     }
 
     // ------------------
@@ -191,4 +496,97 @@ void renderCpuTab() {
     // ------------------
 
     ImGui::Text("Current: %.2f%%", cpuUsageHistory.empty() ? 0.0f : cpuUsageHistory.back());
+
+    // ------------------
+    // PRESSURE
+    // ------------------
+
+    renderPsiPanel(PsiCpu);
+
+    // ------------------
+    // TIME BY STATE
+    // ------------------
+
+    const Snapshot& snap = currentSnapshot();
+    ImGui::Separator();
+    ImGui::Text("Time by state");
+    for (const CpuStateStyle& style : cpuStateStyles) {
+        ImGui::SameLine();
+        ImGui::TextColored(ImGui::ColorConvertU32ToFloat4(style.color), "%s %.1f%%", style.name, snap.cpuStates.*style.field);
+    }
+    drawStateHistory(cpuStateHistory, graphSize.y);
+
+    // ------------------
+    // VIRTUALIZATION
+    // ------------------
+
+    // Open by default on a VM, where steal is the number that matters
+    const StealInfo& steal = snap.steal;
+    bool virtualized = !snap.host.hypervisor.empty();
+    if (ImGui::CollapsingHeader("Steal and guest time", virtualized ? ImGuiTreeNodeFlags_DefaultOpen : 0)) {
+        ImGui::Text("Hypervisor: %s", virtualized ? snap.host.hypervisor.c_str() : "none detected");
+        ImGui::Text("Steal %.1f%% now, %.1f%% over the last %.0f s   guest %.1f%% now", snap.cpuStates.steal,
+                    steal.percent, steal.windowSeconds, snap.cpuStates.guest);
+        if (steal.noisyNeighbour)
+            ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.3f, 1.0f),
+                               "Noisy neighbour: the hypervisor is giving %.1f%% of our CPU time to other guests",
+                               steal.percent);
+        if (steal.worstCore >= 0 && steal.corePercent[steal.worstCore] > 0.0f)
+            ImGui::Text("Most stolen: cpu%d at %.1f%% over the window", steal.worstCore,
+                        steal.corePercent[steal.worstCore]);
+
+        char overlay[32];
+        snprintf(overlay, sizeof(overlay), "steal %.1f%%", snap.cpuStates.steal);
+        stealHistory.plot("Steal %", 0.0f, 100.0f, ImVec2(0, 50), overlay);
+        snprintf(overlay, sizeof(overlay), "guest %.1f%%", snap.cpuStates.guest);
+        guestHistory.plot("Guest %", 0.0f, 100.0f, ImVec2(0, 50), overlay);
+
+        if (!snap.coreStates.empty() &&
+            ImGui::BeginTable("CoreSteal", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_ScrollY,
+                              ImVec2(0, 200))) {
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableSetupColumn("CPU");
+            ImGui::TableSetupColumn("Steal %");
+            ImGui::TableSetupColumn("Steal % (window)");
+            ImGui::TableSetupColumn("Guest %");
+            ImGui::TableHeadersRow();
+            ImGuiListClipper clipper;
+            clipper.Begin((int)snap.coreStates.size());
+            while (clipper.Step()) {
+                for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+                    const CpuStates& core = snap.coreStates[row];
+                    ImGui::TableNextRow();
+                    ImGui::TableSetColumnIndex(0);
+                    ImGui::Text("cpu%d", row);
+                    ImGui::TableSetColumnIndex(1);
+                    ImGui::Text("%.1f", core.steal);
+                    ImGui::TableSetColumnIndex(2);
+                    if ((size_t)row < steal.corePercent.size()) ImGui::Text("%.1f", steal.corePercent[row]);
+                    ImGui::TableSetColumnIndex(3);
+                    ImGui::Text("%.1f", core.guest);
+                }
+            }
+            ImGui::EndTable();
+        }
+    }
+
+    // ------------------
+    // PER-CORE VIEW
+    // ------------------
+
+    if (!snap.coreStates.empty() && ImGui::CollapsingHeader("Per core", ImGuiTreeNodeFlags_DefaultOpen)) {
+        // A single pinned core disappears in the aggregate, so name the busiest one
+        size_t busiest = 0;
+        for (size_t i = 1; i < snap.coreStates.size(); i++)
+            if (busyPercent(snap.coreStates[i]) > busyPercent(snap.coreStates[busiest])) busiest = i;
+        ImGui::Text("%zu cores, busiest cpu%zu at %.1f%%", snap.coreStates.size(), busiest,
+                    busyPercent(snap.coreStates[busiest]));
+        drawCoreBars(snap.coreStates);
+
+        // Rows are cores (cpu0 at the top), columns are snapshots, newest on the right
+        coreHeatmap.draw();
+        int row = coreHeatmap.hoveredRow();
+        if (row >= 0 && (size_t)row < snap.coreStates.size())
+            ImGui::SetTooltip("cpu%d: %.1f%% busy now", row, busyPercent(snap.coreStates[row]));
+    }
 }
@@ -0,0 +1,307 @@
+#include "cpufreq.h"
+#include "plot.h"
+#include "procfs.h"
+#include "profiler.h"
+#include "snapshot.h"
+#include <imgui.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+// ------------------------------
+// FILE TABLE
+// ------------------------------
+
+static const std::string cpuDir = "/sys/devices/system/cpu";
+
+enum FreqFileKind : uint8_t { CurFreq, Governor, TimeInState, IdleTime };
+
+// One held sysfs file
+struct FreqFile {
+    ProcHandle handle;
+    int core;             // index into FreqTable::cores
+    FreqFileKind kind;
+    int state;            // idle state, for IdleTime
+};
+
+// Counters of one cpu from the previous read
+struct FreqCore {
+    int cpu;
+    std::vector<std::pair<uint64_t, uint64_t>> timeInState;  // kHz, time in 10 ms units
+    std::vector<uint64_t> idleUs;                            // UINT64_MAX until first read
+};
+
+struct FreqTable {
+    uint64_t generation = 0;  // procSourceGeneration() the table was built for
+    std::vector<FreqFile> files;
+    std::vector<FreqCore> cores;
+    std::vector<std::string> idleStates;
+    int64_t lastTimeMs = 0;
+};
+
+static FreqTable table;
+
+static bool isNumbered(const std::string& name, const char* prefix) {
+    size_t len = strlen(prefix);
+    return name.size() > len && name.compare(0, len, prefix) == 0 &&
+           name.find_first_not_of("0123456789", len) == std::string::npos;
+}
+
+static void addFile(const std::string& path, int core, FreqFileKind kind, int state) {
+    FreqFile file{};
+    if (!procOpenHandle(path, file.handle)) {
+        procCloseHandle(file.handle);
+        return;
+    }
+    file.core = core;
+    file.kind = kind;
+    file.state = state;
+    table.files.push_back(std::move(file));
+}
+
+static void discover() {
+    for (FreqFile& file : table.files) procCloseHandle(file.handle);
+    table = FreqTable();
+    table.generation = procSourceGeneration();
+
+    std::vector<std::string> names;
+    if (!procListDir(cpuDir, names)) return;
+    std::vector<int> cpus;
+    for (const std::string& name : names)
+        if (isNumbered(name, "cpu")) cpus.push_back(atoi(name.c_str() + 3));
+    std::sort(cpus.begin(), cpus.end());
+    raiseFdLimit();
+
+    std::vector<std::string> states;
+    for (int cpu : cpus) {
+        std::string base = cpuDir + "/cpu" + std::to_string(cpu);
+        int core = (int)table.cores.size();
+        size_t before = table.files.size();
+        table.cores.push_back(FreqCore{cpu, {}, {}});
+
+        addFile(base + "/cpufreq/scaling_cur_freq", core, CurFreq, 0);
+        addFile(base + "/cpufreq/scaling_governor", core, Governor, 0);
+        addFile(base + "/cpufreq/stats/time_in_state", core, TimeInState, 0);
+
+        if (procListDir(base + "/cpuidle", states)) {
+            std::vector<int> indices;
+            for (const std::string& name : states)
+                if (isNumbered(name, "state")) indices.push_back(atoi(name.c_str() + 5));
+            std::sort(indices.begin(), indices.end());
+
+            for (int k : indices) {
+                std::string stateDir = base + "/cpuidle/state" + std::to_string(k);
+                // Names come from the first cpu with idle states; later cpus only add states past them
+                if (k == (int)table.idleStates.size()) {
+                    std::string name;
+                    if (!procReadFile(stateDir + "/name", name)) break;
+                    name.erase(name.find_last_not_of(" \n") + 1);
+                    table.idleStates.push_back(name);
+                }
+                if (k < (int)table.idleStates.size()) addFile(stateDir + "/time", core, IdleTime, k);
+            }
+        }
+
+        if (table.files.size() == before) table.cores.pop_back();
+    }
+    for (FreqCore& core : table.cores) core.idleUs.assign(table.idleStates.size(), UINT64_MAX);
+}
+
+// ------------------------------
+// READING
+// ------------------------------
+
+// Time-weighted average of stats/time_in_state ("kHz ticks" lines) since the last read, in MHz;
+// 0 if no time passed
+static float averageMHz(const std::string& text, std::vector<std::pair<uint64_t, uint64_t>>& last) {
+    double weighted = 0.0, total = 0.0;
+    size_t i = 0;
+    const char* p = text.c_str();
+    char* end;
+    while (true) {
+        uint64_t khz = strtoull(p, &end, 10);
+        if (end == p) break;
+        p = end;
+        uint64_t ticks = strtoull(p, &end, 10);
+        if (end == p) break;
+        p = end;
+
+        if (i < last.size() && last[i].first == khz && ticks >= last[i].second) {
+            double dt = (double)(ticks - last[i].second);
+            weighted += dt * khz;
+            total += dt;
+        }
+        if (i < last.size()) last[i] = {khz, ticks};
+        else last.push_back({khz, ticks});
+        i++;
+    }
+    last.resize(i);
+    return total > 0.0 ? (float)(weighted / total / 1000.0) : 0.0f;
+}
+
+CpuFreqInfo readCpuFreq(int64_t timeMs) {
+    PROFILE_ZONE("readCpuFreq");
+    if (table.generation != procSourceGeneration()) discover();
+
+    CpuFreqInfo info;
+    if (table.files.empty()) return info;
+    info.found = true;
+    info.idleStates = table.idleStates;
+
+    double intervalMs = table.lastTimeMs > 0 ? (double)(timeMs - table.lastTimeMs) : 0.0;
+    table.lastTimeMs = timeMs;
+
+    info.cores.resize(table.cores.size());
+    for (size_t i = 0; i < table.cores.size(); i++) {
+        info.cores[i].cpu = table.cores[i].cpu;
+        info.cores[i].idlePercent.assign(table.idleStates.size(), 0.0f);
+    }
+
+    static std::string buffer;  // keeps its capacity between rounds
+    for (FreqFile& file : table.files) {
+        if (!procReadHandle(file.handle, buffer)) continue;
+        CoreFreq& core = info.cores[file.core];
+        FreqCore& last = table.cores[file.core];
+
+        switch (file.kind) {
+        case CurFreq:
+            core.curMHz = strtoull(buffer.c_str(), nullptr, 10) / 1000.0f;
+            break;
+        case Governor: {
+            size_t len = strcspn(buffer.c_str(), " \n");
+            size_t index = 0;
+            while (index < info.governors.size() &&
+                   (info.governors[index].size() != len || buffer.compare(0, len, info.governors[index]) != 0))
+                index++;
+            if (index == info.governors.size()) info.governors.push_back(buffer.substr(0, len));
+            core.governor = (uint8_t)std::min<size_t>(index, 255);
+            break;
+        }
+        case TimeInState:
+            core.avgMHz = averageMHz(buffer, last.timeInState);
+            break;
+        case IdleTime: {
+            uint64_t us = strtoull(buffer.c_str(), nullptr, 10);
+            uint64_t& prev = last.idleUs[file.state];
+            // us over ms * 1000, as a percentage
+            if (intervalMs > 0.0 && prev != UINT64_MAX && us >= prev)
+                core.idlePercent[file.state] = std::min(100.0f, (float)((us - prev) / (intervalMs * 10.0)));
+            prev = us;
+            break;
+        }
+        }
+    }
+
+    // Without time_in_state (intel_pstate, amd-pstate) the sampled frequency stands in
+    for (CoreFreq& core : info.cores) {
+        if (core.avgMHz == 0.0f) core.avgMHz = core.curMHz;
+        info.avgMHz += core.avgMHz;
+    }
+    info.avgMHz /= info.cores.size();
+    return info;
+}
+
+// ------------------------------
+// UI RENDERING FUNCTION FOR FREQUENCY TAB
+// ------------------------------
+
+// One hour at the default sample interval; the plot downsamples
+static const int maxFreqSamples = 7200;
+
+static PlotHistory freqHistory(maxFreqSamples);
+static float freqScaleMHz = 1000.0f;
+static uint64_t lastFreqSequence = 0;
+static uint64_t lastFreqEpoch = 0;
+
+void renderCpuFreqTab() {
+    PROFILE_ZONE("renderCpuFreqTab");
+    const CpuFreqInfo& freq = currentSnapshot().freq;
+    if (!freq.found) {
+        ImGui::Text("No cpufreq or cpuidle data under %s.", cpuDir.c_str());
+        return;
+    }
+
+    if (snapshotEpoch() != lastFreqEpoch) {
+        lastFreqEpoch = snapshotEpoch();
+        freqHistory.clear();
+    }
+    if (snapshotSequence() != lastFreqSequence) {
+        lastFreqSequence = snapshotSequence();
+        freqHistory.push(freq.avgMHz);
+    }
+
+    float minMHz = freq.cores.empty() ? 0.0f : freq.cores[0].avgMHz;
+    float maxMHz = minMHz;
+    for (const CoreFreq& core : freq.cores) {
+        minMHz = std::min(minMHz, core.avgMHz);
+        maxMHz = std::max(maxMHz, core.avgMHz);
+    }
+    freqScaleMHz = std::max(freqScaleMHz, maxMHz * 1.1f);
+
+    ImGui::Text("Average %.0f MHz (min %.0f, max %.0f) over %zu cores", freq.avgMHz, minMHz, maxMHz, freq.cores.size());
+    std::string governors;
+    for (const std::string& g : freq.governors) governors += (governors.empty() ? "" : ", ") + g;
+    ImGui::Text("Governor: %s", governors.empty() ? "-" : governors.c_str());
+
+    char overlay[32];
+    snprintf(overlay, sizeof(overlay), "%.0f MHz", freq.avgMHz);
+    freqHistory.plot("Avg MHz", 0.0f, freqScaleMHz, ImVec2(0, 80), overlay);
+
+    // ------------------
+    // IDLE RESIDENCY
+    // ------------------
+
+    if (!freq.idleStates.empty()) {
+        ImGui::Separator();
+        ImGui::Text("Idle state residency (mean of all cores)");
+        for (size_t k = 0; k < freq.idleStates.size(); k++) {
+            float sum = 0.0f;
+            for (const CoreFreq& core : freq.cores) sum += core.idlePercent[k];
+            float mean = sum / freq.cores.size();
+            char label[48];
+            snprintf(label, sizeof(label), "%s %.1f%%", freq.idleStates[k].c_str(), mean);
+            ImGui::ProgressBar(mean / 100.0f, ImVec2(-1, 0), label);
+        }
+    }
+
+    // ------------------
+    // PER-CORE TABLE
+    // ------------------
+
+    // ImGui tables hold at most 64 columns
+    int states = (int)std::min<size_t>(freq.idleStates.size(), 60);
+    if (ImGui::CollapsingHeader("Per core") &&
+        ImGui::BeginTable("FreqCores", 4 + states, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_ScrollY,
+                          ImVec2(0, 300))) {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("CPU");
+        ImGui::TableSetupColumn("Avg MHz");
+        ImGui::TableSetupColumn("Cur MHz");
+        ImGui::TableSetupColumn("Governor");
+        for (int k = 0; k < states; k++) ImGui::TableSetupColumn(freq.idleStates[k].c_str());
+        ImGui::TableHeadersRow();
+
+        // Only the visible rows are built
+        ImGuiListClipper clipper;
+        clipper.Begin((int)freq.cores.size());
+        while (clipper.Step()) {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+                const CoreFreq& core = freq.cores[row];
+                ImGui::TableNextRow();
+                ImGui::TableSetColumnIndex(0);
+                ImGui::Text("cpu%d", core.cpu);
+                ImGui::TableSetColumnIndex(1);
+                ImGui::Text("%.0f", core.avgMHz);
+                ImGui::TableSetColumnIndex(2);
+                ImGui::Text("%.0f", core.curMHz);
+                ImGui::TableSetColumnIndex(3);
+                ImGui::TextUnformatted(core.governor < freq.governors.size() ? freq.governors[core.governor].c_str() : "-");
+                for (int k = 0; k < states; k++) {
+                    ImGui::TableSetColumnIndex(4 + k);
+                    ImGui::Text("%.1f%%", core.idlePercent[k]);
+                }
+            }
+        }
+        ImGui::EndTable();
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ------------------------------
+// CPU FREQUENCY AND IDLE STATES
+// ------------------------------
+//
+// From /sys/devices/system/cpu/cpuN/cpufreq and cpuN/cpuidle. The files are
+// discovered on the first read (and again when the ProcSource changes) into
+// one flat table of held handles, so a round is one pread per file.
+
+struct CoreFreq {
+    int cpu = 0;
+    float avgMHz = 0.0f;             // over the interval from stats/time_in_state, else = curMHz
+    float curMHz = 0.0f;             // scaling_cur_freq when sampled
+    uint8_t governor = 0;            // index into CpuFreqInfo::governors
+    std::vector<float> idlePercent;  // residency per idle state over the interval, as in idleStates
+};
+
+struct CpuFreqInfo {
+    bool found = false;                  // any cpufreq or cpuidle files
+    std::vector<std::string> governors;  // distinct governors in use
+    std::vector<std::string> idleStates; // state names (POLL, C1, C6, ...) of the first cpu that has them
+    std::vector<CoreFreq> cores;         // sorted by cpu
+    float avgMHz = 0.0f;                 // mean of the cores' avgMHz
+};
+
+// Reads every held file; interval values are relative to the previous call's timeMs
+CpuFreqInfo readCpuFreq(int64_t timeMs);
+
+// Frequency graph, governors, idle residency and the per-core table
+void renderCpuFreqTab();
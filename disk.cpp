@@ -1,4 +1,6 @@
 #include "header.h"
+#include "snapshot.h"
+#include "profiler.h"
 #include <imgui.h>
 #include <cstdio>
 
@@ -10,18 +12,11 @@
     #include <sys/statvfs.h>
 #endif
 
-void renderDiskWindow(const char* id, ImVec2 size, ImVec2 position)
+// Usage of the root filesystem; ok is false if it could not be read
+DiskStats getDiskStats()
 {
-    ImGui::SetNextWindowSize(size, ImGuiCond_FirstUseEver);
-    ImGui::SetNextWindowPos(position, ImGuiCond_FirstUseEver);
-
-    if (!ImGui::Begin(id)) {
-        ImGui::End();
-        return;
-    }
-
-    float usedPercent = 0.0f;
-    float totalGB = 0.0f, usedGB = 0.0f, availGB = 0.0f;
+    PROFILE_ZONE("getDiskStats");
+    DiskStats disk;
 
 #if defined(_WIN32)
     // Windows implementation
@@ -31,14 +26,12 @@ void renderDiskWindow(const char* id, ImVec2 size, ImVec2 position)
         unsigned long long free = freeBytes.QuadPart;
         unsigned long long used = total - free;
 
-        usedPercent = (float)used / (float)total;
-        totalGB = total / (1024.0f * 1024.0f * 1024.0f);
-        usedGB = used / (1024.0f * 1024.0f * 1024.0f);
-        availGB = free / (1024.0f * 1024.0f * 1024.0f);
+        disk.usedPercent = (float)used / (float)total;
+        disk.totalGB = total / (1024.0f * 1024.0f * 1024.0f);
+        disk.usedGB = used / (1024.0f * 1024.0f * 1024.0f);
+        disk.availGB = free / (1024.0f * 1024.0f * 1024.0f);
     } else {
-        ImGui::Text("Failed to get disk stats (Windows)");
-        ImGui::End();
-        return;
+        return disk;
     }
 
 #elif defined(__APPLE__)
@@ -50,14 +43,12 @@ void renderDiskWindow(const char* id, ImVec2 size, ImVec2 position)
         unsigned long long available = stats.f_bavail * stats.f_bsize;
         unsigned long long used = total - free;
 
-        usedPercent = (used + available > 0) ? (float)used / (float)(used + available) : 0.0f;
-        totalGB = total / (1024.0f * 1024.0f * 1024.0f);
-        usedGB = used / (1024.0f * 1024.0f * 1024.0f);
-        availGB = available / (1024.0f * 1024.0f * 1024.0f);
+        disk.usedPercent = (used + available > 0) ? (float)used / (float)(used + available) : 0.0f;
+        disk.totalGB = total / (1024.0f * 1024.0f * 1024.0f);
+        disk.usedGB = used / (1024.0f * 1024.0f * 1024.0f);
+        disk.availGB = available / (1024.0f * 1024.0f * 1024.0f);
     } else {
-        ImGui::Text("Failed to get disk stats (macOS)");
-        ImGui::End();
-        return;
+        return disk;
     }
 
 #elif defined(__linux__)
@@ -70,28 +61,47 @@ void renderDiskWindow(const char* id, ImVec2 size, ImVec2 position)
         unsigned long long available = stats.f_bavail * blockSize;
         unsigned long long used = total - free;
 
-        usedPercent = (used + available > 0) ? (float)used / (float)(used + available) : 0.0f;
-        totalGB = total / (1024.0f * 1024.0f * 1024.0f);
-        usedGB = used / (1024.0f * 1024.0f * 1024.0f);
-        availGB = available / (1024.0f * 1024.0f * 1024.0f);
+        disk.usedPercent = (used + available > 0) ? (float)used / (float)(used + available) : 0.0f;
+        disk.totalGB = total / (1024.0f * 1024.0f * 1024.0f);
+        disk.usedGB = used / (1024.0f * 1024.0f * 1024.0f);
+        disk.availGB = available / (1024.0f * 1024.0f * 1024.0f);
     } else {
-        ImGui::Text("Failed to get disk stats (Linux)");
-        ImGui::End();
-        return;
+        return disk;
     }
 
 #else
     // Unsupported platform
-    ImGui::Text("This OS is not currently supported for disk usage monitoring.");
-    ImGui::End();
-    return;
+    return disk;
 #endif
 
+    disk.ok = true;
+    return disk;
+}
+
+void renderDiskWindow(const char* id, ImVec2 size, ImVec2 position)
+{
+    PROFILE_ZONE("renderDiskWindow");
+    ImGui::SetNextWindowSize(size, ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowPos(position, ImGuiCond_FirstUseEver);
+
+    if (!ImGui::Begin(id)) {
+        ImGui::End();
+        return;
+    }
+
+    const DiskStats& disk = currentSnapshot().disk;
+    if (!disk.ok) {
+        ImGui::Text("Failed to get disk stats for /");
+        ImGui::End();
+        return;
+    }
+
     // Common rendering
     ImGui::Text("Disk Usage for /");
-    ImGui::ProgressBar(usedPercent, ImVec2(-1.0f, 20.0f));
-    ImGui::Text("Used: %.1f GB / Total: %.1f GB (%.1f%%)", usedGB, totalGB, usedPercent * 100.0f);
-    ImGui::Text("Available: %.1f GB", availGB);
+    ImGui::ProgressBar(disk.usedPercent, ImVec2(-1.0f, 20.0f));
+    ImGui::Text("Used: %.1f GB / Total: %.1f GB (%.1f%%)", disk.usedGB, disk.totalGB, disk.usedPercent * 100.0f);
+    ImGui::Text("Available: %.1f GB", disk.availGB);
+    renderPsiPanel(PsiIo);
 
     ImGui::End();
 }
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Compact binary encoding shared by the recording and capture formats:
+// LEB128 varints, zigzag signed varints, raw floats and length-prefixed strings.
+
+inline void putVarint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((uint8_t)v);
+}
+
+inline void putSigned(std::vector<uint8_t>& out, int64_t v) {
+    putVarint(out, ((uint64_t)v << 1) ^ (uint64_t)(v >> 63));
+}
+
+inline void putFloat(std::vector<uint8_t>& out, float f) {
+    uint8_t raw[4];
+    memcpy(raw, &f, 4);
+    out.insert(out.end(), raw, raw + 4);
+}
+
+inline void putString(std::vector<uint8_t>& out, const std::string& s) {
+    putVarint(out, s.size());
+    out.insert(out.end(), s.begin(), s.end());
+}
+
+// Reads the encodings above; `ok` turns false on truncated input
+struct Cursor {
+    const uint8_t* p;
+    const uint8_t* end;
+    bool ok = true;
+
+    uint64_t varint() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (p >= end) { ok = false; return 0; }
+            uint8_t b = *p++;
+            v |= (uint64_t)(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        ok = false;
+        return v;
+    }
+    int64_t svarint() {
+        uint64_t v = varint();
+        return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+    }
+    uint8_t byte() {
+        if (p >= end) { ok = false; return 0; }
+        return *p++;
+    }
+    float f32() {
+        float f = 0.0f;
+        if (end - p < 4) { ok = false; return f; }
+        memcpy(&f, p, 4);
+        p += 4;
+        return f;
+    }
+    std::string str() {
+        uint64_t n = varint();
+        if ((uint64_t)(end - p) < n) { ok = false; return ""; }
+        std::string s((const char*)p, n);
+        p += n;
+        return s;
+    }
+};
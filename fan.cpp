@@ -1,30 +1,35 @@
 #include "fan.h"
+#include "plot.h"
+#include "snapshot.h"
+#include "procfs.h"
+#include "profiler.h"
 #include <imgui.h>
 
 #ifdef __linux__
 
-#include <fstream>      // For file input (reading from sysfs files)
+#include <cstdlib>      // For parsing integers from sysfs files
 #include <string>       // For std::string manipulation
-#include <vector>       // For copying deque to vector for ImGui plotting
-#include <deque>        // To store history of fan speed readings
-#include <filesystem>   // For directory traversal to find hwmon files
+#include <vector>       // For std::vector
+#include <deque>        // For std::deque
 #include <iostream>     // (Optional) For debugging output
 
-namespace fs = std::filesystem;  // Alias to make filesystem calls shorter
-
 // Search through /sys/class/hwmon directories to find the path to the fan speed input file,
 // usually named something like "fan1_input"
 static std::string findFanInputPath() {
-    // Iterate all entries in /sys/class/hwmon
-    for (const auto& entry : fs::directory_iterator("/sys/class/hwmon")) {
-        if (!entry.is_directory()) continue;  // Only check directories
+    // List all entries in /sys/class/hwmon (missing on some VMs and containers)
+    std::vector<std::string> devices;
+    if (!procListDir("/sys/class/hwmon", devices)) return "";
+
+    std::vector<std::string> files;
+    for (const std::string& device : devices) {
+        std::string dir = "/sys/class/hwmon/" + device;
+        if (!procListDir(dir, files)) continue;  // Only check directories
 
-        // Inside each hwmonX directory, iterate files to find "fan1_input"
-        for (const auto& file : fs::directory_iterator(entry.path())) {
-            std::string filename = file.path().filename().string();
+        // Inside each hwmonX directory, look through the files to find "fan1_input"
+        for (const std::string& filename : files) {
             if (filename.find("fan1_input") != std::string::npos) {
                 // Return the full path to the fan input file when found
-                return file.path().string();
+                return dir + "/" + filename;
             }
         }
     }
@@ -36,24 +41,24 @@ static std::string findFanInputPath() {
 // such as "fan1_enable" or "fan1_status" in the same directory as fanInputPath
 static std::string findFanEnablePath(const std::string& fanInputPath) {
     // Get the directory containing fanInputPath (e.g. /sys/class/hwmon/hwmon0/device/)
-    fs::path base = fs::path(fanInputPath).parent_path();
+    std::string base = fanInputPath.substr(0, fanInputPath.rfind('/') + 1);
 
     // Try each possible filename; return the first that exists
     for (const char* name : {"fan1_enable", "fan1_status"}) {
-        fs::path p = base / name;
-        if (fs::exists(p)) return p.string();
+        std::string p = base + name;
+        if (procExists(p)) return p;
     }
     return "";
 }
 
 // Find a file that may indicate fan level or PWM control, like "fan1_level", "pwm1", or "pwm1_enable"
 static std::string findFanLevelPath(const std::string& fanInputPath) {
-    fs::path base = fs::path(fanInputPath).parent_path();
+    std::string base = fanInputPath.substr(0, fanInputPath.rfind('/') + 1);
 
     // Check common fan control or level files, return first found
     for (const char* name : {"fan1_level", "pwm1", "pwm1_enable"}) {
-        fs::path p = base / name;
-        if (fs::exists(p)) return p.string();
+        std::string p = base + name;
+        if (procExists(p)) return p;
     }
     return "";
 }
@@ -61,16 +66,17 @@ static std::string findFanLevelPath(const std::string& fanInputPath) {
 // Helper function to read an integer value from a given file path
 // Returns -1 if file can't be opened or read
 static int readIntFromFile(const std::string& path) {
-    std::ifstream file(path);
-    if (!file.is_open()) return -1; // File couldn't be opened
+    std::string contents;
+    if (!procReadFile(path, contents)) return -1; // File couldn't be read
 
-    int val = -1;
-    file >> val; // Read integer from file stream
-    return val;
+    char* end = nullptr;
+    long val = strtol(contents.c_str(), &end, 10); // Read integer from file contents
+    return end == contents.c_str() ? -1 : (int)val;
 }
 
 // Main function to gather fan information from the hardware monitoring sysfs files
 FanInfo getFanInfo() {
+    PROFILE_ZONE("getFanInfo");
     // Cache the paths so we only do filesystem search once
     static std::string fanInputPath = findFanInputPath();
     static std::string fanEnablePath = fanInputPath.empty() ? "" : findFanEnablePath(fanInputPath);
@@ -110,17 +116,21 @@ static bool pauseFan = false;       // Pause updating fan data graph
 static int fpsFan = 60;             // Frames per second update rate for fan tab
 static float yScaleFan = 8000.0f;  // Vertical scale for fan speed graph (max RPM)
 
-// Store recent fan speeds for plotting as a graph, using a deque as a fixed-size buffer
-static std::deque<float> fanSpeedHistory;
-static constexpr int maxSamples = 100;  // Max number of points in the graph history
+// Store recent fan speeds for plotting as a graph (one per snapshot, 24 h at the default interval)
+static constexpr int maxSamples = 172800;  // Max number of points in the graph history
+static PlotHistory fanSpeedHistory(maxSamples);
+static double lastFanSampleTime = 0.0;  // Time of the last sample pushed to the graph
+static uint64_t lastFanSequence = 0;    // Snapshot sequence the graph last saw
+static uint64_t lastFanEpoch = 0;       // Replay seeks clear the graph
 
 // Function to draw the fan tab in the ImGui interface
 void renderFanTab() {
+    PROFILE_ZONE("renderFanTab");
     ImGui::Text("Fan Information");
     ImGui::Separator();
 
-    // Query the current fan info from sysfs
-    FanInfo fan = getFanInfo();
+    // Fan info sampled from sysfs with the rest of the snapshot
+    const FanInfo& fan = currentSnapshot().fan;
 
     // Display fan status and readings
     ImGui::Text("Status: %s", fan.active ? "Active" : "Inactive");
@@ -132,25 +142,26 @@ void renderFanTab() {
     ImGui::SliderInt("FPS", &fpsFan, 1, 144);
     ImGui::SliderFloat("Y Scale", &yScaleFan, 100.0f, 16000.0f, "%.0f RPM");
 
-    if (!pauseFan) {
-        // Add the current fan speed to the history buffer
-        fanSpeedHistory.push_back(static_cast<float>(fan.speedRPM));
-        // Keep the buffer size limited to maxSamples by popping oldest values
-        if (fanSpeedHistory.size() > maxSamples) {
-            fanSpeedHistory.pop_front();
-        }
+    if (snapshotEpoch() != lastFanEpoch) {
+        lastFanEpoch = snapshotEpoch();
+        fanSpeedHistory.clear();
+    }
+
+    // Add each new fan speed to the history buffer, at most at the chosen FPS
+    double now = ImGui::GetTime();
+    if (!pauseFan && snapshotSequence() != lastFanSequence && now - lastFanSampleTime >= 1.0 / fpsFan) {
+        lastFanSampleTime = now;
+        lastFanSequence = snapshotSequence();
+        fanSpeedHistory.push(static_cast<float>(fan.speedRPM));
     }
 
     // Plot the fan speed history as a line graph if we have any data
     if (!fanSpeedHistory.empty()) {
-        // Convert deque to vector for ImGui plotting API
-        std::vector<float> values(fanSpeedHistory.begin(), fanSpeedHistory.end());
         ImVec2 graphSize = ImVec2(0, 100);  // Width=auto, height=100 pixels
-
-        ImGui::PlotLines("Fan Speed (RPM)", values.data(), static_cast<int>(values.size()), 0, nullptr, 0.0f, yScaleFan, graphSize);
+        fanSpeedHistory.plot("Fan Speed (RPM)", 0.0f, yScaleFan, graphSize);
 
         // Show latest fan speed as text below the graph
-        ImGui::Text("Current Speed: %.1f RPM", values.back());
+        ImGui::Text("Current Speed: %.1f RPM", fanSpeedHistory.back());
     } else {
         // No fan data available to plot yet
         ImGui::Text("No fan data available.");
@@ -161,10 +172,12 @@ void renderFanTab() {
 
 // Stub implementation for other OSs: fan monitoring not supported
 FanInfo getFanInfo() {
+    PROFILE_ZONE("getFanInfo");
     return {false, 0, 0};
 }
 
 void renderFanTab() {
+    PROFILE_ZONE("renderFanTab");
     ImGui::Text("Fan monitoring is only available on Linux.");
     ImGui::Text("This feature uses /sys/class/hwmon.");
 }
@@ -0,0 +1,616 @@
+#include "fixture.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <filesystem>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+// ------------------------------
+// HELPERS
+// ------------------------------
+
+// splitmix64: a cheap, well-mixed hash for deterministic fixture values
+static uint64_t mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+static uint64_t hash3(uint64_t seed, uint64_t a, uint64_t b) {
+    return mix(seed ^ mix(a ^ mix(b)));
+}
+
+// Set by any failed write during writeFixture
+static bool writeFailed = false;
+
+// Plain open/write: a 100k-pid tree is 300k small files, and stdio buffers add up
+static void writeText(const std::string& path, const std::string& text) {
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        writeFailed = true;
+        return;
+    }
+    if (write(fd, text.data(), text.size()) != (ssize_t)text.size()) writeFailed = true;
+    if (close(fd) != 0) writeFailed = true;
+}
+
+// Returns true if the directory was created (false if it already existed)
+static bool makeDir(const std::string& path) {
+    if (mkdir(path.c_str(), 0755) == 0) return true;
+    if (errno != EEXIST) writeFailed = true;
+    return false;
+}
+
+static void appendf(std::string& out, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+static void appendf(std::string& out, const char* fmt, ...) {
+    char buf[1024];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    if (n > 0) out.append(buf, std::min(n, (int)sizeof(buf) - 1));
+}
+
+// Processes replaced per round
+static int64_t churnPerRound(const FixtureSpec& spec) {
+    return (int64_t)std::llround(spec.churn * spec.pids);
+}
+
+// How many times a slot's process has been replaced by `round`;
+// replacements walk through the slots in order, churnPerRound at a time
+static int64_t slotGeneration(const FixtureSpec& spec, int slot, int round) {
+    int64_t replaced = churnPerRound(spec) * round;
+    return replaced > slot ? (replaced - slot - 1) / spec.pids + 1 : 0;
+}
+
+int fixturePid(const FixtureSpec& spec, int slot, int round) {
+    return (int)(1 + slot + slotGeneration(spec, slot, round) * spec.pids);
+}
+
+// Round at which the slot's current process started
+static int slotBirthRound(const FixtureSpec& spec, int slot, int round) {
+    int64_t gen = slotGeneration(spec, slot, round);
+    if (gen == 0) return 0;
+    int64_t nth = slot + (gen - 1) * spec.pids;  // index of that replacement
+    return (int)(nth / churnPerRound(spec)) + 1;
+}
+
+static const char* const fixtureServices[] = {"sshd", "cron", "dbus", "nginx", "postgresql", "containerd"};
+static const int fixtureServiceCount = sizeof(fixtureServices) / sizeof(fixtureServices[0]);
+
+// Cgroups processes live in: init, the services, a login session and one scope per container
+static int cgroupLeaves(const FixtureSpec& spec) {
+    return 2 + fixtureServiceCount + spec.containers;
+}
+
+static std::string cgroupLeafPath(const FixtureSpec& spec, int leaf) {
+    if (leaf == 0) return "/init.scope";
+    if (leaf <= fixtureServiceCount) return std::string("/system.slice/") + fixtureServices[leaf - 1] + ".service";
+    if (leaf == fixtureServiceCount + 1) return "/user.slice/user-1000.slice/session-1.scope";
+    int k = leaf - fixtureServiceCount - 2;
+    char path[128];
+    snprintf(path, sizeof(path), "/kubepods.slice/kubepods-pod%d.slice/cri-containerd-%08llx.scope", k,
+             (unsigned long long)(hash3(spec.seed, 0x6374, k) & 0xffffffff));
+    return path;
+}
+
+// Process slot 0 is in init.scope, the others spread over the remaining cgroups
+static std::string fixtureCgroup(const FixtureSpec& spec, int slot) {
+    if (slot == 0) return cgroupLeafPath(spec, 0);
+    return cgroupLeafPath(spec, 1 + (int)(hash3(spec.seed, 0x6367, slot) % (cgroupLeaves(spec) - 1)));
+}
+
+static const char* const processNames[] = {
+    "systemd", "kworker/0:1", "bash", "sshd", "Web Content", "postgres",
+    "nginx", "python3", "containerd-shim", "Xorg", "rcu_sched", "java",
+};
+
+// ------------------------------
+// /proc FILES
+// ------------------------------
+
+// Ticks per cpu per round (USER_HZ = 100, one second per round)
+static const int ticksPerRound = 100;
+
+static void writeProcStat(const std::string& proc, const FixtureSpec& spec, int round) {
+    std::string text;
+    std::vector<unsigned long long> total(8, 0);
+    std::string perCpu;
+
+    for (int cpu = 0; cpu < spec.cpus; cpu++) {
+        // Fixed share of each state per cpu, so counters grow linearly
+        uint64_t h = hash3(spec.seed, 0x5747, cpu);
+        unsigned long long user = round * (10 + h % 40);
+        unsigned long long nice = round * ((h >> 8) % 2);
+        unsigned long long system = round * (3 + (h >> 16) % 10);
+        unsigned long long iowait = round * ((h >> 24) % 3);
+        unsigned long long irq = round * ((h >> 32) % 2);
+        unsigned long long softirq = round * ((h >> 40) % 2);
+        // A guest on a shared host: a little steal everywhere, more on every eighth cpu
+        unsigned long long steal = round * ((h >> 48) % 3 + (cpu % 8 == 7 ? 15 : 0));
+        unsigned long long idle = (unsigned long long)round * ticksPerRound
+                                  - user - nice - system - iowait - irq - softirq - steal;
+        unsigned long long values[8] = {user, nice, system, idle, iowait, irq, softirq, steal};
+        appendf(perCpu, "cpu%d", cpu);
+        for (int i = 0; i < 8; i++) {
+            total[i] += values[i];
+            appendf(perCpu, " %llu", values[i]);
+        }
+        perCpu += " 0 0\n";
+    }
+
+    text += "cpu ";
+    for (unsigned long long v : total) appendf(text, " %llu", v);
+    text += " 0 0\n";
+    text += perCpu;
+    appendf(text, "intr %llu\n", (unsigned long long)round * 5000 * spec.cpus);
+    appendf(text, "ctxt %llu\n", (unsigned long long)round * 20000 * spec.cpus);
+    text += "btime 1700000000\n";
+    appendf(text, "processes %llu\n", (unsigned long long)spec.pids + churnPerRound(spec) * round);
+    appendf(text, "procs_running %d\n", 1 + (int)(hash3(spec.seed, 0x7275, round) % spec.cpus));
+    appendf(text, "procs_blocked %d\n", (int)(hash3(spec.seed, 0x626c, round) % 3));
+    writeText(proc + "/stat", text);
+}
+
+static void writeMeminfo(const std::string& proc, const FixtureSpec& spec, int round) {
+    const unsigned long long totalKb = 16ull * 1024 * 1024;
+    const unsigned long long swapKb = 4ull * 1024 * 1024;
+    double load = 0.5 + 0.25 * std::sin(round / 30.0 + spec.seed);
+    unsigned long long availKb = (unsigned long long)(totalKb * (1.0 - load));
+    unsigned long long swapFreeKb = swapKb - (unsigned long long)(swapKb * 0.1 * load);
+
+    std::string text;
+    appendf(text, "MemTotal:       %llu kB\n", totalKb);
+    appendf(text, "MemFree:        %llu kB\n", availKb / 2);
+    appendf(text, "MemAvailable:   %llu kB\n", availKb);
+    appendf(text, "Buffers:        %llu kB\n", totalKb / 64);
+    appendf(text, "Cached:         %llu kB\n", availKb / 3);
+    appendf(text, "SwapCached:     %llu kB\n", 0ull);
+    appendf(text, "SwapTotal:      %llu kB\n", swapKb);
+    appendf(text, "SwapFree:       %llu kB\n", swapFreeKb);
+    writeText(proc + "/meminfo", text);
+}
+
+// Load follows the same slow wave as memory; schedstat counters grow by a fixed share of each second
+static void writeSchedFiles(const std::string& proc, const FixtureSpec& spec, int round) {
+    double load = spec.cpus * (0.5 + 0.25 * std::sin(round / 30.0 + spec.seed));
+    std::string text;
+    appendf(text, "%.2f %.2f %.2f %d/%d %d\n", load, load * 0.9, load * 0.8,
+            1 + (int)(hash3(spec.seed, 0x7275, round) % spec.cpus), spec.pids, fixturePid(spec, spec.pids - 1, round));
+    writeText(proc + "/loadavg", text);
+
+    text = "version 15\ntimestamp 4295000000\n";
+    for (int cpu = 0; cpu < spec.cpus; cpu++) {
+        uint64_t h = hash3(spec.seed, 0x7363, cpu);
+        unsigned long long runNs = (300000000ull + h % 400000000ull) * round;
+        unsigned long long delayNs = (1000000ull + (h >> 20) % 20000000ull) * round;
+        unsigned long long slices = (500ull + (h >> 40) % 2000ull) * round;
+        appendf(text, "cpu%d 0 0 %llu %llu %llu %llu %llu %llu %llu\n", cpu, slices * 2, slices / 2, slices, slices / 3,
+                runNs, delayNs, slices);
+        text += "domain0 00000003 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0\n";
+    }
+    writeText(proc + "/schedstat", text);
+}
+
+// One row of /proc/interrupts or /proc/softirqs: `perSecond(cpu)` increments a second on each cpu
+template <typename Rate>
+static void appendIrqRow(std::string& text, const char* name, int width, const FixtureSpec& spec, int round,
+                         Rate perSecond, const std::string& label) {
+    appendf(text, "%*s:", width, name);
+    for (int cpu = 0; cpu < spec.cpus; cpu++) appendf(text, " %10llu", (unsigned long long)perSecond(cpu) * round);
+    if (!label.empty()) text += "   " + label;
+    text += "\n";
+}
+
+// Timer and NVMe interrupts, one network queue per cpu (up to 8) pinned to that cpu, and the
+// per-cpu architectural ones; softirqs follow the same queues
+static void writeInterrupts(const std::string& proc, const FixtureSpec& spec, int round) {
+    std::string header = "          ";
+    for (int cpu = 0; cpu < spec.cpus; cpu++) appendf(header, " %10s", ("CPU" + std::to_string(cpu)).c_str());
+    header += "\n";
+    int queues = std::min(spec.cpus, 8);
+
+    std::string text = header;
+    appendIrqRow(text, "0", 4, spec, round, [](int cpu) { return cpu == 0 ? 1 : 0; }, "IO-APIC   2-edge      timer");
+    for (int q = 0; q < queues; q++) {
+        uint64_t rate = 2000 + hash3(spec.seed, 0x6972, q) % 3000;
+        appendIrqRow(text, std::to_string(40 + q).c_str(), 4, spec, round, [&](int cpu) { return cpu == q ? rate : 0; },
+                     "PCI-MSI 524288" + std::to_string(q) + "-edge      eth0-TxRx-" + std::to_string(q));
+    }
+    appendIrqRow(text, "60", 4, spec, round, [&](int cpu) { return cpu == spec.cpus - 1 ? 300 : 0; },
+                 "PCI-MSI 1048576-edge      nvme0q1");
+    appendIrqRow(text, "NMI", 4, spec, round, [](int) { return 1; }, "Non-maskable interrupts");
+    appendIrqRow(text, "LOC", 4, spec, round, [](int) { return 1000; }, "Local timer interrupts");
+    appendIrqRow(text, "RES", 4, spec, round, [](int cpu) { return 20 + cpu % 7; }, "Rescheduling interrupts");
+    appendIrqRow(text, "TLB", 4, spec, round, [](int cpu) { return cpu % 3; }, "TLB shootdowns");
+    text += " ERR:          0\n MIS:          0\n";
+    writeText(proc + "/interrupts", text);
+
+    text = "         " + header;
+    appendIrqRow(text, "HI", 12, spec, round, [](int) { return 0; }, "");
+    appendIrqRow(text, "TIMER", 12, spec, round, [](int) { return 250; }, "");
+    appendIrqRow(text, "NET_TX", 12, spec, round, [&](int cpu) { return cpu < queues ? 40 : 0; }, "");
+    appendIrqRow(text, "NET_RX", 12, spec, round, [&](int cpu) { return cpu < queues ? 1500 : 0; }, "");
+    appendIrqRow(text, "BLOCK", 12, spec, round, [&](int cpu) { return cpu == spec.cpus - 1 ? 300 : 0; }, "");
+    appendIrqRow(text, "SCHED", 12, spec, round, [](int) { return 150; }, "");
+    appendIrqRow(text, "RCU", 12, spec, round, [](int) { return 400; }, "");
+    writeText(proc + "/softirqs", text);
+}
+
+// Fixed stall share per resource (some, full), so totals grow by that many microseconds a second
+static void writePressure(const std::string& proc, int round) {
+    static const char* const names[] = {"cpu", "memory", "io"};
+    static const double someShare[] = {0.04, 0.01, 0.08};
+    static const double fullShare[] = {0.0, 0.005, 0.03};
+
+    makeDir(proc + "/pressure");
+    for (int r = 0; r < 3; r++) {
+        std::string text;
+        double some = someShare[r] * 100.0, full = fullShare[r] * 100.0;
+        appendf(text, "some avg10=%.2f avg60=%.2f avg300=%.2f total=%llu\n", some, some, some,
+                (unsigned long long)(someShare[r] * 1e6 * round));
+        appendf(text, "full avg10=%.2f avg60=%.2f avg300=%.2f total=%llu\n", full, full, full,
+                (unsigned long long)(fullShare[r] * 1e6 * round));
+        writeText(proc + "/pressure/" + names[r], text);
+    }
+}
+
+// Two sockets from 64 cpus up, two threads per core
+static int fixtureSockets(const FixtureSpec& spec) {
+    return spec.cpus >= 64 ? 2 : 1;
+}
+
+static int fixtureSocket(const FixtureSpec& spec, int cpu) {
+    int perSocket = (spec.cpus + fixtureSockets(spec) - 1) / fixtureSockets(spec);
+    return cpu / perSocket;
+}
+
+static int fixtureCore(const FixtureSpec& spec, int cpu) {
+    int perSocket = (spec.cpus + fixtureSockets(spec) - 1) / fixtureSockets(spec);
+    return (cpu % perSocket) / 2;
+}
+
+static void writeCpuinfo(const std::string& proc, const FixtureSpec& spec) {
+    std::string text;
+    for (int cpu = 0; cpu < spec.cpus; cpu++) {
+        appendf(text, "processor\t: %d\n", cpu);
+        text += "vendor_id\t: GenuineIntel\n";
+        text += "model name\t: Fixture CPU @ 3.00GHz\n";
+        text += "cpu MHz\t\t: 3000.000\n";
+        appendf(text, "physical id\t: %d\n", fixtureSocket(spec, cpu));
+        appendf(text, "core id\t\t: %d\n", fixtureCore(spec, cpu));
+        appendf(text, "cpu cores\t: %d\n", (spec.cpus + 1) / 2 / fixtureSockets(spec));
+        text += "flags\t\t: fpu tsc msr pae sse sse2 ht syscall nx lm constant_tsc hypervisor\n\n";
+    }
+    writeText(proc + "/cpuinfo", text);
+
+    makeDir(proc + "/sys");
+    makeDir(proc + "/sys/kernel");
+    writeText(proc + "/sys/kernel/osrelease", "6.1.0-fixture\n");
+}
+
+static void writeNetDev(const std::string& proc, const FixtureSpec& spec, int round) {
+    std::string text =
+        "Inter-|   Receive                                                |  Transmit\n"
+        " face |bytes    packets errs drop fifo frame compressed multicast|bytes    packets errs drop fifo colls carrier compressed\n";
+    for (int i = 0; i < spec.interfaces; i++) {
+        char name[32];
+        if (i == 0) snprintf(name, sizeof(name), "lo");
+        else snprintf(name, sizeof(name), "%s%d", i <= 2 ? "eth" : "veth", i <= 2 ? i - 1 : i - 3);
+
+        uint64_t h = hash3(spec.seed, 0x6e6574, i);
+        unsigned long long rxRate = 1000 + h % 1000000, txRate = 1000 + (h >> 20) % 200000;
+        unsigned long long rx = rxRate * round, tx = txRate * round;
+        appendf(text, "%6s: %llu %llu 0 0 0 0 0 0 %llu %llu 0 0 0 0 0 0\n",
+                name, rx, rx / 800, tx, tx / 800);
+    }
+    writeText(proc + "/net/dev", text);
+}
+
+// A thread pool server: a few busy pools among many idle threads, each
+// listed with its own stat. Thread names never change while the pid lives
+static void writeThreads(const std::string& dir, const FixtureSpec& spec, int pid, int age, int threads) {
+    static const char* const pools[] = {"http-nio-%d", "GC Thread#%d", "C2 Compiler%d", "pool-1-thread-%d"};
+    makeDir(dir + "/task");
+    for (int k = 0; k < threads; k++) {
+        // The main thread's tid is the pid; the rest stay clear of the fixture's pids
+        int tid = k == 0 ? pid : (1 << 22) + k;
+        uint64_t h = hash3(spec.seed, 0x746964, k);
+        char name[16];
+        snprintf(name, sizeof(name), k == 0 ? "main" : pools[h % 4], k);
+        std::string task = dir + "/task/" + std::to_string(tid);
+        if (makeDir(task)) writeText(task + "/comm", std::string(name) + "\n");
+
+        bool busy = h % 4 == 0;
+        unsigned long long utime = (unsigned long long)age * (busy ? (h >> 8) % 80 : (h >> 8) % 2);
+        unsigned long long stime = (unsigned long long)age * (busy ? (h >> 16) % 10 : 0);
+        std::string stat;
+        appendf(stat, "%d (%s) %c 1 %d %d 0 -1 4194368 0 0 0 0 %llu %llu 0 0 20 0 %d 0 0 0 0 "
+                      "18446744073709551615 1 1 0 0 0 0 0 0 0 0 0 0 -1 %d 0 0 0 0 0 0 0 0 0 0 0 0 0\n",
+                tid, name, busy ? 'R' : 'S', pid, pid, utime, stime, threads, (int)((h >> 24) % spec.cpus));
+        writeText(task + "/stat", stat);
+    }
+}
+
+static void writeProcess(const std::string& proc, const FixtureSpec& spec, int slot, int round) {
+    int pid = fixturePid(spec, slot, round);
+    int age = round - slotBirthRound(spec, slot, round);
+    uint64_t h = hash3(spec.seed, 0x706964, pid);
+
+    const char* name = processNames[h % (sizeof(processNames) / sizeof(processNames[0]))];
+    static const char states[] = "SSSSSSSRIZ";
+    char state = states[(h >> 8) % 10];
+    int ppid = pid == 1 ? 0 : 1;
+    unsigned long long utime = (unsigned long long)age * ((h >> 16) % 50);
+    unsigned long long stime = (unsigned long long)age * ((h >> 24) % 10);
+    unsigned long long rssPages = 256 + (h >> 32) % 65536;
+    int threads = slot == 0 ? spec.threads : 1 + (int)((h >> 40) % 16);
+
+    // The name never changes while a pid lives
+    std::string dir = proc + "/" + std::to_string(pid);
+    if (makeDir(dir)) writeText(dir + "/comm", std::string(name) + "\n");
+
+    std::string stat;
+    appendf(stat, "%d (%s) %c %d %d %d 0 -1 4194304 %llu 0 %llu 0 %llu %llu 0 0 20 0 %d 0 %llu %llu %llu "
+                  "18446744073709551615 1 1 0 0 0 0 0 0 0 0 0 0 17 %d 0 0 0 0 0 0 0 0 0 0 0 0 0\n",
+            pid, name, state, ppid, pid, pid, (unsigned long long)age * 100, (unsigned long long)age / 10,
+            utime, stime, threads, (unsigned long long)slotBirthRound(spec, slot, round) * ticksPerRound,
+            rssPages * 4096 * 4, rssPages, slot % spec.cpus);
+    writeText(dir + "/stat", stat);
+    if (slot == 0) writeThreads(dir, spec, pid, age, threads);
+
+    // I/O grows with age like CPU time; about one process in four does disk I/O
+    unsigned long long rchar = (unsigned long long)age * ((h >> 44) % 65536) * 64;
+    unsigned long long diskBytes = (h >> 60) % 4 == 0 ? (unsigned long long)age * ((h >> 48) % 4096) * 4096 : 0;
+    std::string io;
+    appendf(io, "rchar: %llu\nwchar: %llu\nsyscr: %llu\nsyscw: %llu\nread_bytes: %llu\nwrite_bytes: %llu\n"
+                "cancelled_write_bytes: 0\n",
+            rchar, rchar / 2, rchar / 4096 + age, rchar / 8192 + age, diskBytes, diskBytes / 2);
+    writeText(dir + "/io", io);
+
+    // Forked workers of the same name share most of their pages
+    unsigned long long rssKB = rssPages * 4, sharedKB = rssKB * ((h >> 52) % 4) / 4;
+    unsigned long long swapKB = (h >> 56) % 64 * 4;
+    std::string rollup;
+    appendf(rollup, "00400000-7fffffffffff ---p 00000000 00:00 0 [rollup]\nRss: %llu kB\nPss: %llu kB\n"
+                    "Shared_Clean: %llu kB\nShared_Dirty: 0 kB\nPrivate_Clean: 0 kB\nPrivate_Dirty: %llu kB\n"
+                    "Swap: %llu kB\nSwapPss: %llu kB\n",
+            rssKB, rssKB - sharedKB + sharedKB / 4, sharedKB, rssKB - sharedKB, swapKB, swapKB);
+    writeText(dir + "/smaps_rollup", rollup);
+    writeText(dir + "/cgroup", "0::" + fixtureCgroup(spec, slot) + "\n");
+
+    std::string status;
+    appendf(status, "Name:\t%s\nUmask:\t0022\nState:\t%c\nTgid:\t%d\nPid:\t%d\nPPid:\t%d\n",
+            name, state, pid, pid, ppid);
+    appendf(status, "VmSize:\t%llu kB\nVmRSS:\t%llu kB\nThreads:\t%d\n",
+            rssPages * 16, rssPages * 4, threads);
+    appendf(status, "voluntary_ctxt_switches:\t%llu\nnonvoluntary_ctxt_switches:\t%llu\n",
+            (unsigned long long)age * 20, (unsigned long long)age * 2);
+    writeText(dir + "/status", status);
+}
+
+// ------------------------------
+// /sys FILES
+// ------------------------------
+
+static void writeSensors(const std::string& sys, const FixtureSpec& spec, int round) {
+    std::string thermal = sys + "/class/thermal/thermal_zone0";
+    makeDir(sys + "/class/thermal");
+    makeDir(thermal);
+    int milliC = 45000 + (int)(10000 * std::sin(round / 20.0 + spec.seed));
+    writeText(thermal + "/type", "x86_pkg_temp\n");
+    writeText(thermal + "/temp", std::to_string(milliC) + "\n");
+
+    makeDir(sys + "/class/hwmon");
+    for (int i = 0; i < spec.sensors; i++) {
+        std::string dir = sys + "/class/hwmon/hwmon" + std::to_string(i);
+        makeDir(dir);
+        uint64_t h = hash3(spec.seed, 0x68776d, i);
+        writeText(dir + "/name", i == 0 ? "k10temp\n" : "nct6775\n");
+        writeText(dir + "/temp1_input", std::to_string(milliC + (int)(h % 5000)) + "\n");
+        if (i > 0) {
+            int rpm = 800 + (int)(h % 1200) + (round % 10) * 10;
+            writeText(dir + "/fan1_input", std::to_string(rpm) + "\n");
+            writeText(dir + "/fan1_enable", "1\n");
+            writeText(dir + "/pwm1", std::to_string(100 + h % 155) + "\n");
+        }
+    }
+}
+
+// cpufreq and cpuidle under /sys/devices/system/cpu/cpuN
+static void writeCpuSysfs(const std::string& sys, const FixtureSpec& spec, int round) {
+    static const unsigned long long freqsKHz[] = {1200000, 2400000, 3600000};
+    static const char* const idleNames[] = {"POLL", "C1", "C6"};
+
+    std::string base = sys + "/devices/system/cpu";
+    for (const std::string& dir : {sys + "/devices", sys + "/devices/system", base}) makeDir(dir);
+    writeText(base + "/online", spec.cpus == 1 ? "0\n" : "0-" + std::to_string(spec.cpus - 1) + "\n");
+    makeDir(sys + "/devices/system/node");
+    writeText(sys + "/devices/system/node/online", fixtureSockets(spec) == 1 ? "0\n" : "0-1\n");
+
+    for (int cpu = 0; cpu < spec.cpus; cpu++) {
+        std::string dir = base + "/cpu" + std::to_string(cpu);
+        bool created = makeDir(dir);
+        if (created) {
+            for (const char* sub : {"/cpufreq", "/cpufreq/stats", "/cpuidle"}) makeDir(dir + sub);
+            for (int k = 0; k < 3; k++) {
+                makeDir(dir + "/cpuidle/state" + std::to_string(k));
+                writeText(dir + "/cpuidle/state" + std::to_string(k) + "/name", std::string(idleNames[k]) + "\n");
+            }
+            writeText(dir + "/cpufreq/scaling_governor", cpu % 4 == 3 ? "performance\n" : "schedutil\n");
+
+            makeDir(dir + "/topology");
+            writeText(dir + "/topology/physical_package_id", std::to_string(fixtureSocket(spec, cpu)) + "\n");
+            writeText(dir + "/topology/core_id", std::to_string(fixtureCore(spec, cpu)) + "\n");
+        }
+
+        // Fixed split of each second between the three frequencies (10 ms ticks)
+        uint64_t h = hash3(spec.seed, 0x66726571, cpu);
+        unsigned long long low = h % 60;
+        unsigned long long mid = (h >> 8) % (100 - low);
+        unsigned long long ticks[3] = {low, mid, 100 - low - mid};
+        std::string timeInState;
+        for (int i = 0; i < 3; i++) appendf(timeInState, "%llu %llu\n", freqsKHz[i], ticks[i] * round);
+        writeText(dir + "/cpufreq/stats/time_in_state", timeInState);
+        writeText(dir + "/cpufreq/scaling_cur_freq", std::to_string(freqsKHz[(round + cpu) % 3]) + "\n");
+
+        // Idle residency per second, in microseconds (under a second in total)
+        unsigned long long idleUs[3] = {1000 * ((h >> 16) % 5), 20000 * ((h >> 20) % 10), 10000 * ((h >> 24) % 40)};
+        for (int k = 0; k < 3; k++)
+            writeText(dir + "/cpuidle/state" + std::to_string(k) + "/time", std::to_string(idleUs[k] * round) + "\n");
+    }
+
+    // Per-core L1 and L2 shared by the SMT pair, one L3 per socket
+    struct FixtureCache { int level; const char* type; const char* size; bool perSocket; };
+    static const FixtureCache caches[] = {
+        {1, "Data", "48K", false}, {1, "Instruction", "32K", false},
+        {2, "Unified", "2048K", false}, {3, "Unified", "32768K", true}};
+    std::string cacheDir = base + "/cpu0/cache";
+    makeDir(cacheDir);
+    int perSocket = (spec.cpus + fixtureSockets(spec) - 1) / fixtureSockets(spec);
+    for (int k = 0; k < 4; k++) {
+        std::string dir = cacheDir + "/index" + std::to_string(k);
+        if (!makeDir(dir)) continue;
+        int shared = caches[k].perSocket ? perSocket : std::min(2, spec.cpus);
+        writeText(dir + "/level", std::to_string(caches[k].level) + "\n");
+        writeText(dir + "/type", std::string(caches[k].type) + "\n");
+        writeText(dir + "/size", std::string(caches[k].size) + "\n");
+        writeText(dir + "/shared_cpu_list", shared == 1 ? "0\n" : "0-" + std::to_string(shared - 1) + "\n");
+    }
+}
+
+// Leaf cgroups get their own counters and every parent the sum of its children,
+// as the kernel reports them. Containers have a CPU quota, a few of them throttled
+static void writeCgroups(const std::string& sys, const FixtureSpec& spec, int round) {
+    struct FixtureCgroup {
+        std::string path;
+        int parent;
+        bool limited;
+        unsigned long long usageUs, memory, readBytes, writeBytes, pids, oomKills, periods, throttled;
+    };
+    std::vector<FixtureCgroup> groups;
+    auto add = [&groups](const std::string& path, int parent, bool limited) {
+        groups.push_back({path, parent, limited, 0, 0, 0, 0, 0, 0, 0, 0});
+        return (int)groups.size() - 1;
+    };
+    add("", -1, false);
+    std::vector<int> leaves;
+    leaves.push_back(add(cgroupLeafPath(spec, 0), 0, false));
+    int system = add("/system.slice", 0, false);
+    for (int s = 0; s < fixtureServiceCount; s++) leaves.push_back(add(cgroupLeafPath(spec, 1 + s), system, false));
+    int user = add("/user.slice/user-1000.slice", add("/user.slice", 0, false), false);
+    leaves.push_back(add(cgroupLeafPath(spec, fixtureServiceCount + 1), user, false));
+    int kubepods = spec.containers > 0 ? add("/kubepods.slice", 0, false) : -1;
+    for (int k = 0; k < spec.containers; k++) {
+        std::string scope = cgroupLeafPath(spec, fixtureServiceCount + 2 + k);
+        leaves.push_back(add(scope, add(scope.substr(0, scope.rfind('/')), kubepods, false), true));
+    }
+
+    for (size_t i = 0; i < leaves.size(); i++) {
+        FixtureCgroup& g = groups[leaves[i]];
+        uint64_t h = hash3(spec.seed, 0x6367, i);
+        g.usageUs = (unsigned long long)round * ((h % 800) * 1000);
+        g.memory = (16 + (h >> 12) % 512) << 20;
+        g.readBytes = (unsigned long long)round * ((h >> 24) % 4096) * 4096;
+        g.writeBytes = g.readBytes / 2;
+        g.pids = 1 + (h >> 36) % 20;
+        if (g.limited) {
+            g.periods = (unsigned long long)round * 10;
+            g.throttled = (unsigned long long)round * ((h >> 40) % 4);
+            g.oomKills = (h >> 44) % 8 == 0 ? round / 30 : 0;
+        }
+    }
+    // Children come after their parents
+    for (size_t i = groups.size() - 1; i > 0; i--) {
+        FixtureCgroup& g = groups[i];
+        FixtureCgroup& parent = groups[g.parent];
+        parent.usageUs += g.usageUs;
+        parent.memory += g.memory;
+        parent.readBytes += g.readBytes;
+        parent.writeBytes += g.writeBytes;
+        parent.pids += g.pids;
+        parent.oomKills += g.oomKills;
+    }
+
+    std::string root = sys + "/fs/cgroup";
+    makeDir(sys + "/fs");
+    makeDir(root);
+    writeText(root + "/cgroup.controllers", "cpuset cpu io memory hugetlb pids rdma misc\n");
+    std::string text;
+    for (const FixtureCgroup& g : groups) {
+        std::string dir = root + g.path;
+        makeDir(dir);
+        text.clear();
+        appendf(text, "usage_usec %llu\nuser_usec %llu\nsystem_usec %llu\n", g.usageUs, g.usageUs * 7 / 10,
+                g.usageUs - g.usageUs * 7 / 10);
+        if (!g.path.empty())
+            appendf(text, "nr_periods %llu\nnr_throttled %llu\nthrottled_usec %llu\n", g.periods, g.throttled,
+                    g.throttled * 20000);
+        writeText(dir + "/cpu.stat", text);
+
+        // Three quarters of the I/O on the NVMe drive, the rest on a SATA disk
+        text.clear();
+        appendf(text, "259:0 rbytes=%llu wbytes=%llu rios=%llu wios=%llu dbytes=0 dios=0\n", g.readBytes * 3 / 4,
+                g.writeBytes * 3 / 4, g.readBytes * 3 / 4 / 4096, g.writeBytes * 3 / 4 / 4096);
+        appendf(text, "8:0 rbytes=%llu wbytes=%llu rios=%llu wios=%llu dbytes=0 dios=0\n", g.readBytes / 4,
+                g.writeBytes / 4, g.readBytes / 4 / 4096, g.writeBytes / 4 / 4096);
+        writeText(dir + "/io.stat", text);
+        if (g.path.empty()) continue;
+
+        writeText(dir + "/memory.current", std::to_string(g.memory) + "\n");
+        writeText(dir + "/memory.max", g.limited ? "1073741824\n" : "max\n");
+        text.clear();
+        appendf(text, "low 0\nhigh 0\nmax %llu\noom %llu\noom_kill %llu\n", g.oomKills * 10, g.oomKills,
+                g.oomKills);
+        writeText(dir + "/memory.events", text);
+        writeText(dir + "/pids.current", std::to_string(g.pids) + "\n");
+    }
+}
+
+// ------------------------------
+// TREE
+// ------------------------------
+
+bool writeFixture(const std::string& root, const FixtureSpec& spec, int round) {
+    if (spec.pids < 1 || spec.cpus < 1 || spec.threads < 1 || spec.containers < 0 || spec.interfaces < 0 || spec.sensors < 0) return false;
+
+    std::string proc = root + "/proc";
+    std::string sys = root + "/sys";
+    writeFailed = false;
+    for (const std::string& dir : {root, proc, proc + "/net", sys, sys + "/class"}) makeDir(dir);
+    if (writeFailed) return false;
+
+    // Remove processes that exited since the last tree written here
+    std::unordered_set<int> live;
+    for (int slot = 0; slot < spec.pids; slot++) live.insert(fixturePid(spec, slot, round));
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(proc, ec)) {
+        const std::string name = entry.path().filename().string();
+        if (name.empty() || name.find_first_not_of("0123456789") != std::string::npos) continue;
+        if (!live.count(atoi(name.c_str()))) fs::remove_all(entry.path(), ec);
+    }
+
+    writeProcStat(proc, spec, round);
+    writeMeminfo(proc, spec, round);
+    writePressure(proc, round);
+    writeSchedFiles(proc, spec, round);
+    writeInterrupts(proc, spec, round);
+    writeCpuinfo(proc, spec);
+    writeNetDev(proc, spec, round);
+    for (int slot = 0; slot < spec.pids; slot++) writeProcess(proc, spec, slot, round);
+    writeSensors(sys, spec, round);
+    writeCpuSysfs(sys, spec, round);
+    writeCgroups(sys, spec, round);
+    return !writeFailed;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// ------------------------------
+// SYNTHETIC /proc AND /sys TREES
+// ------------------------------
+//
+// Writes a fake /proc and /sys under a directory, for running the collectors
+// with setProcRoot() (or ./monitor --root DIR) against a host of any size.
+// Everything is derived from the spec, the seed and the round number, so the
+// same arguments always produce the same tree, and counters grow from one
+// round to the next as if one second had passed.
+
+struct FixtureSpec {
+    int pids = 1000;          // processes under /proc
+    int interfaces = 4;       // lines in /proc/net/dev (including lo)
+    int sensors = 2;          // /sys/class/hwmon devices
+    int cpus = 8;             // cpuN in /proc/stat, /proc/cpuinfo and /sys/devices/system/cpu
+    int threads = 2000;       // under /proc/[pid]/task of the first process; the others list none
+    int containers = 10;      // container scopes in /sys/fs/cgroup, besides init, services and a session
+    double churn = 0.0;       // fraction of processes replaced each round
+    uint64_t seed = 1;
+};
+
+// Writes the tree as it looks at `round`, removing processes that exited
+// since an earlier round was written to the same directory
+bool writeFixture(const std::string& root, const FixtureSpec& spec, int round);
+
+// Pid of process slot `slot` at `round` (slots are reused when a process exits)
+int fixturePid(const FixtureSpec& spec, int slot, int round);
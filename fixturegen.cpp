@@ -0,0 +1,76 @@
+#include "fixture.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+// ------------------------------
+// FIXTURE GENERATOR
+// ------------------------------
+//
+// monitor-fixture DIR [--pids N] [--interfaces M] [--sensors K] [--cpus C]
+//                     [--threads T] [--containers N] [--churn F] [--seed S] [--round R] [--interval-ms MS]
+//
+// Writes a synthetic /proc and /sys tree under DIR for ./monitor --root DIR.
+// With --interval-ms it keeps advancing one round per interval until killed,
+// so the monitor sees counters move and processes come and go.
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "usage: %s DIR [--pids N] [--interfaces M] [--sensors K] [--cpus C]\n"
+            "       [--threads T] [--containers N] [--churn F] [--seed S] [--round R] [--interval-ms MS]\n",
+            argv0);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argv[1][0] == '-') {
+        usage(argv[0]);
+        return 1;
+    }
+
+    const char* root = argv[1];
+    FixtureSpec spec;
+    int round = 0;
+    int intervalMs = 0;
+
+    for (int i = 2; i < argc; i++) {
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+            return 1;
+        }
+        const char* value = argv[++i];
+        if (!strcmp(argv[i - 1], "--pids")) spec.pids = atoi(value);
+        else if (!strcmp(argv[i - 1], "--interfaces")) spec.interfaces = atoi(value);
+        else if (!strcmp(argv[i - 1], "--sensors")) spec.sensors = atoi(value);
+        else if (!strcmp(argv[i - 1], "--cpus")) spec.cpus = atoi(value);
+        else if (!strcmp(argv[i - 1], "--threads")) spec.threads = atoi(value);
+        else if (!strcmp(argv[i - 1], "--containers")) spec.containers = atoi(value);
+        else if (!strcmp(argv[i - 1], "--churn")) spec.churn = atof(value);
+        else if (!strcmp(argv[i - 1], "--seed")) spec.seed = strtoull(value, nullptr, 10);
+        else if (!strcmp(argv[i - 1], "--round")) round = atoi(value);
+        else if (!strcmp(argv[i - 1], "--interval-ms")) intervalMs = atoi(value);
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    do {
+        auto start = std::chrono::steady_clock::now();
+        if (!writeFixture(root, spec, round)) {
+            fprintf(stderr, "Error: could not write fixture round %d under %s\n", round, root);
+            return 1;
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        printf("round %d: %d pids, %d interfaces, %d sensors written in %.0f ms\n",
+               round, spec.pids, spec.interfaces, spec.sensors, ms);
+        fflush(stdout);
+
+        round++;
+        if (intervalMs > 0 && ms < intervalMs)
+            std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(intervalMs - ms));
+    } while (intervalMs > 0);
+
+    return 0;
+}
@@ -33,6 +33,7 @@
 #include <arpa/inet.h>
 #include <map>
 #include <string> // std::string (needed because you use string type)
+#include <utility> // std::pair for the memory collector
 
 using namespace std;
 
@@ -50,6 +51,42 @@ struct CPUStats
     long long int guestNice;
 };
 
+// Percent of CPU time spent in each state between two CPUStats samples (sums to 100);
+// guest time is taken out of user and nice, which the kernel also counts it in
+struct CpuStates
+{
+    float user;
+    float nice;
+    float system;
+    float iowait;
+    float irq;
+    float softirq;
+    float steal;
+    float guest;
+    float idle;
+};
+
+// Scheduler counters from the lines after the cpu lines of /proc/stat
+struct ProcStatCounters
+{
+    uint64_t ctxt;          // context switches since boot
+    uint64_t forks;         // `processes`: forks since boot
+    int procsRunning;       // runnable tasks right now
+    int procsBlocked;       // tasks blocked on I/O right now
+};
+
+// Steal time averaged over a sliding window, and whether it is high enough
+// that another tenant of the host is taking our CPU time
+struct StealInfo
+{
+    float windowSeconds = 0.0f;             // time the averages cover so far
+    float percent = 0.0f;                   // aggregate steal over the window
+    float guestPercent = 0.0f;              // aggregate guest time over the window
+    std::vector<float> corePercent;         // steal over the window per core
+    int worstCore = -1;
+    bool noisyNeighbour = false;
+};
+
 // processes `stat`
 struct Proc
 {
@@ -97,8 +134,19 @@ struct RX
     int compressed;
 };
 
+// per-interface counters from /proc/net/dev
+struct NetStats {
+    uint64_t rx_bytes = 0, rx_packets = 0, rx_errs = 0, rx_drop = 0, rx_fifo = 0, rx_frame = 0, rx_compressed = 0, rx_multicast = 0;
+    uint64_t tx_bytes = 0, tx_packets = 0, tx_errs = 0, tx_drop = 0, tx_fifo = 0, tx_colls = 0, tx_carrier = 0, tx_compressed = 0;
+};
+
+struct SwapStats {
+    float usedMB = 0.0f;
+    float totalMB = 0.0f;
+    std::string errorMessage; // empty if no error
+};
+
 // student TODO : system stats
-string CPUinfo();
 const char *getOsName();
 
 // Needed for displaying the system info on the system window💜
@@ -116,7 +164,22 @@ struct TaskStats
 };
 TaskStats getTaskStats();
 
-std::string CPUinfo();
+// collectors shared by the panels and the history sampler
+// Aggregate /proc/stat counters; fills `cores` (indexed by cpu number) and `counters` from the same read
+CPUStats readCpuStats(std::vector<CPUStats> *cores = nullptr, ProcStatCounters *counters = nullptr);
+float cpuUsageBetween(const CPUStats &prev, const CPUStats &curr);
+CpuStates cpuStatesBetween(const CPUStats &prev, const CPUStats &curr);
+// Adds one snapshot's states to the steal window
+StealInfo trackSteal(const CpuStates &total, const std::vector<CpuStates> &cores, int64_t timeMs);
+float getCpuUsagePercent();
+std::pair<float, float> getMemoryUsageMB();
+SwapStats getSwapInfo();
+std::map<std::string, NetStats> readNetworkStats();
+float readTemperatureC();
+bool thermalSensorFound();
+unsigned long long readProcessCpuTime(int pid);
+float readProcessMemoryPercent(int pid);
+std::string formatBytes(uint64_t bytes);
 
 void renderCpuTab();
 
@@ -133,5 +196,13 @@ void rendernetworkWindow(const char* id, ImVec2 size, ImVec2 position);
 
 void RenderExtraNetworkWindow(const char *id, ImVec2 size, ImVec2 position);
 
+// past time ranges from the on-disk history
+void renderHistoryWindow(const char *id, ImVec2 size, ImVec2 position);
+
+// top-level windows drawn by main()
+void systemWindow(const char *id, ImVec2 size, ImVec2 position);
+void memoryProcessesWindow(const char *id, ImVec2 size, ImVec2 position);
+void networkWindow(const char *id, ImVec2 size, ImVec2 position);
+
 
 #endif
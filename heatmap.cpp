@@ -0,0 +1,127 @@
+#include "heatmap.h"
+#include "profiler.h"
+#include <algorithm>
+
+// Same loader selection as main.cpp and the OpenGL backend
+#if defined(IMGUI_IMPL_OPENGL_LOADER_GL3W)
+#include <GL/gl3w.h>
+#elif defined(IMGUI_IMPL_OPENGL_LOADER_GLEW)
+#include <GL/glew.h>
+#elif defined(IMGUI_IMPL_OPENGL_LOADER_GLAD)
+#include <glad/glad.h>
+#elif defined(IMGUI_IMPL_OPENGL_LOADER_GLAD2)
+#include <glad/gl.h>
+#elif defined(IMGUI_IMPL_OPENGL_LOADER_GLBINDING2)
+#define GLFW_INCLUDE_NONE
+#include <glbinding/Binding.h>
+#include <glbinding/gl/gl.h>
+using namespace gl;
+#elif defined(IMGUI_IMPL_OPENGL_LOADER_GLBINDING3)
+#define GLFW_INCLUDE_NONE
+#include <glbinding/glbinding.h>
+#include <glbinding/gl/gl.h>
+using namespace gl;
+#else
+#include IMGUI_IMPL_OPENGL_LOADER_CUSTOM
+#endif
+
+// ------------------------------
+// COLOUR SCALE
+// ------------------------------
+
+// Dark blue (idle) -> green -> yellow -> red (saturated), as RGBA bytes in memory order
+static uint32_t heatColor(float v) {
+    static const float stops[][3] = {{20, 30, 60}, {50, 160, 80}, {230, 200, 60}, {220, 60, 50}};
+    v = std::clamp(v, 0.0f, 1.0f) * 3.0f;
+    int i = std::min(2, (int)v);
+    float t = v - i;
+    uint32_t r = (uint32_t)(stops[i][0] + (stops[i + 1][0] - stops[i][0]) * t);
+    uint32_t g = (uint32_t)(stops[i][1] + (stops[i + 1][1] - stops[i][1]) * t);
+    uint32_t b = (uint32_t)(stops[i][2] + (stops[i + 1][2] - stops[i][2]) * t);
+    return r | (g << 8) | (b << 16) | (255u << 24);
+}
+
+// The frame benchmark runs ImGui without the OpenGL backend (or a context)
+static bool haveRenderer() {
+    return ImGui::GetIO().BackendRendererName != nullptr;
+}
+
+// ------------------------------
+// TEXTURE
+// ------------------------------
+
+void HeatmapTexture::createTexture(int rowCount) {
+    release();
+    rows = rowCount;
+    nextColumn = 0;
+    if (rows == 0 || !haveRenderer()) return;
+
+    GLint previous;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &previous);
+
+    GLuint name;
+    glGenTextures(1, &name);
+    glBindTexture(GL_TEXTURE_2D, name);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);  // draw() wraps the ring with UVs past 1
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+    // Starts out as the background colour of the frame
+    ImVec4 bg = ImGui::GetStyleColorVec4(ImGuiCol_FrameBg);
+    pixels.assign((size_t)columns * rows, ImGui::ColorConvertFloat4ToU32(ImVec4(bg.x, bg.y, bg.z, 1.0f)));
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, columns, rows, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+    glBindTexture(GL_TEXTURE_2D, previous);
+    texture = name;
+}
+
+void HeatmapTexture::push(const std::vector<float>& values) {
+    PROFILE_ZONE("HeatmapTexture::push");
+    if ((int)values.size() != rows) createTexture((int)values.size());
+    if (!texture) return;
+
+    pixels.resize(rows);
+    for (int row = 0; row < rows; row++) pixels[row] = heatColor(values[row]);
+
+    // One texel wide, `rows` tall
+    GLint previous;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &previous);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, nextColumn, 0, 1, rows, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glBindTexture(GL_TEXTURE_2D, previous);
+
+    nextColumn = (nextColumn + 1) % columns;
+}
+
+void HeatmapTexture::clear() {
+    createTexture(rows);
+}
+
+void HeatmapTexture::release() {
+    if (texture) {
+        GLuint name = texture;
+        glDeleteTextures(1, &name);
+    }
+    texture = 0;
+}
+
+void HeatmapTexture::draw(float height) {
+    if (height <= 0.0f) height = std::clamp(rows * 2.0f, 64.0f, 256.0f);
+    ImVec2 size(ImGui::GetContentRegionAvail().x, height);
+
+    if (texture) {
+        // The oldest column is nextColumn, so start there and wrap once around the ring
+        float start = (float)nextColumn / columns;
+        ImGui::Image((ImTextureID)(intptr_t)texture, size, ImVec2(start, 0.0f), ImVec2(start + 1.0f, 1.0f));
+    } else {
+        ImGui::Dummy(size);
+    }
+
+    hovered = -1;
+    if (rows > 0 && ImGui::IsItemHovered()) {
+        float y = ImGui::GetIO().MousePos.y - ImGui::GetItemRectMin().y;
+        hovered = std::clamp((int)(y / height * rows), 0, rows - 1);
+    }
+}
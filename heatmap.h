@@ -0,0 +1,42 @@
+#pragma once
+#include <imgui.h>
+#include <cstdint>
+#include <vector>
+
+// Rows x time heatmap kept in a GL texture.
+//
+// Each pushed column is uploaded with one glTexSubImage2D into a ring of
+// `columns` texels, and the whole map is drawn with a single ImGui::Image
+// whose UVs wrap around the ring (GL_REPEAT), so drawing costs the same
+// for 4 rows or 256 and for any history length.
+//
+// Without a renderer backend (the headless frame benchmark) nothing is
+// uploaded and draw() only reserves the space.
+class HeatmapTexture {
+public:
+    explicit HeatmapTexture(int columns = 600) : columns(columns) {}
+
+    // Appends one column; values are 0..1, one per row. A different row
+    // count starts a new, empty map.
+    void push(const std::vector<float>& values);
+    void clear();
+
+    // Draws the map at the cursor; height 0 picks 2 px per row (64..256 px)
+    void draw(float height = 0.0f);
+
+    // Row under the mouse after draw(), or -1
+    int hoveredRow() const { return hovered; }
+
+    // Frees the texture (needs the GL context; one left at exit goes with the context)
+    void release();
+
+private:
+    void createTexture(int rowCount);
+
+    int columns;
+    int rows = 0;
+    int nextColumn = 0;          // ring position of the next upload
+    unsigned int texture = 0;    // GL texture name, 0 = none
+    std::vector<uint32_t> pixels;
+    int hovered = -1;
+};
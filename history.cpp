@@ -0,0 +1,716 @@
+#include "history.h"
+#include "clock.h"
+#include "header.h"
+#include "snapshot.h"
+#include "plot.h"
+#include "profiler.h"
+#include <imgui.h>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <filesystem>
+#include <map>
+#include <set>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+// ------------------------------
+// FORMAT CONSTANTS
+// ------------------------------
+
+static const char segmentMagic[4] = {'S', 'M', 'T', 'S'};
+static const uint32_t segmentVersion = 1;
+static const uint32_t recordMagic = 0x31434552; // "REC1"
+static const size_t segmentHeaderSize = 4 + 4 + 8;
+static const size_t recordHeaderSize = 4 + 2 + 4 + 4 + 8 + 8;
+
+// Points per chunk before it is written out as one record
+static const uint32_t chunkPoints = 240;
+
+// Rotate the active segment once it is this big or this old
+static const size_t segmentMaxBytes = 8u << 20;
+static const int64_t segmentMaxAgeMs = 6LL * 3600 * 1000;
+
+// Segments older than this are deleted when a new one is opened
+static const int64_t retentionMs = 30LL * 24 * 3600 * 1000;
+
+int historyIntervalMs = 1000;
+
+// ------------------------------
+// GORILLA CODEC
+// ------------------------------
+
+void GorillaEncoder::writeBits(uint64_t value, int bits) {
+    while (bits > 0) {
+        if (bitPos == 0) buffer.push_back(0);
+        int freeBits = 8 - bitPos;
+        int n = bits < freeBits ? bits : freeBits;
+        uint8_t chunk = (uint8_t)((value >> (bits - n)) & ((1u << n) - 1));
+        buffer.back() |= (uint8_t)(chunk << (freeBits - n));
+        bitPos = (bitPos + n) & 7;
+        bits -= n;
+    }
+}
+
+void GorillaEncoder::clear() {
+    *this = GorillaEncoder();
+}
+
+void GorillaEncoder::append(int64_t timeMs, double value) {
+    uint64_t valueBits;
+    memcpy(&valueBits, &value, sizeof(valueBits));
+
+    if (pointCount == 0) {
+        // First point is stored raw
+        writeBits((uint64_t)timeMs, 64);
+        writeBits(valueBits, 64);
+        firstTimeMs = timeMs;
+        prevTime = timeMs;
+        prevDelta = 0;
+        prevValueBits = valueBits;
+        pointCount = 1;
+        return;
+    }
+
+    // Timestamp: delta-of-delta with variable-width buckets
+    int64_t delta = timeMs - prevTime;
+    int64_t dod = delta - prevDelta;
+    if (dod == 0) {
+        writeBits(0, 1);
+    } else if (dod >= -64 && dod <= 63) {
+        writeBits(0x2, 2);
+        writeBits((uint64_t)dod & 0x7F, 7);
+    } else if (dod >= -256 && dod <= 255) {
+        writeBits(0x6, 3);
+        writeBits((uint64_t)dod & 0x1FF, 9);
+    } else if (dod >= -2048 && dod <= 2047) {
+        writeBits(0xE, 4);
+        writeBits((uint64_t)dod & 0xFFF, 12);
+    } else {
+        writeBits(0xF, 4);
+        writeBits((uint64_t)dod, 64);
+    }
+    prevDelta = delta;
+    prevTime = timeMs;
+
+    // Value: XOR with the previous value, storing only the meaningful bits
+    uint64_t x = valueBits ^ prevValueBits;
+    if (x == 0) {
+        writeBits(0, 1);
+    } else {
+        writeBits(1, 1);
+        int leading = __builtin_clzll(x);
+        int trailing = __builtin_ctzll(x);
+        if (leading > 31) leading = 31; // only 5 bits to store it
+
+        if (prevLeading >= 0 && leading >= prevLeading && trailing >= prevTrailing) {
+            // Fits in the previous window
+            writeBits(0, 1);
+            writeBits(x >> prevTrailing, 64 - prevLeading - prevTrailing);
+        } else {
+            int significant = 64 - leading - trailing;
+            writeBits(1, 1);
+            writeBits((uint64_t)leading, 5);
+            writeBits((uint64_t)(significant - 1), 6);
+            writeBits(x >> trailing, significant);
+            prevLeading = leading;
+            prevTrailing = trailing;
+        }
+    }
+    prevValueBits = valueBits;
+    pointCount++;
+}
+
+// Reads bits MSB-first from a Gorilla payload
+struct BitReader {
+    const uint8_t* data;
+    size_t size;
+    size_t bit = 0;
+
+    bool read(int bits, uint64_t& out) {
+        if (bit + bits > size * 8) return false;
+        out = 0;
+        while (bits > 0) {
+            int offset = bit & 7;
+            int avail = 8 - offset;
+            int n = bits < avail ? bits : avail;
+            uint8_t byte = data[bit >> 3];
+            out = (out << n) | ((byte >> (avail - n)) & ((1u << n) - 1));
+            bit += n;
+            bits -= n;
+        }
+        return true;
+    }
+};
+
+// Sign-extends the low `bits` of v
+static int64_t signExtend(uint64_t v, int bits) {
+    uint64_t m = 1ULL << (bits - 1);
+    return (int64_t)((v ^ m) - m);
+}
+
+bool gorillaDecode(const uint8_t* data, size_t size, uint32_t count, std::vector<HistoryPoint>& out) {
+    if (count == 0) return true;
+
+    BitReader in{data, size};
+    uint64_t t, v;
+    if (!in.read(64, t) || !in.read(64, v)) return false;
+
+    int64_t prevTime = (int64_t)t;
+    int64_t prevDelta = 0;
+    uint64_t prevValue = v;
+    int leading = 0, trailing = 0;
+
+    HistoryPoint p;
+    p.timeMs = prevTime;
+    memcpy(&p.value, &prevValue, sizeof(double));
+    out.push_back(p);
+
+    for (uint32_t i = 1; i < count; ++i) {
+        // Timestamp bucket: count leading 1 bits (up to 4)
+        int ones = 0;
+        uint64_t b;
+        while (ones < 4) {
+            if (!in.read(1, b)) return false;
+            if (b == 0) break;
+            ones++;
+        }
+        int64_t dod = 0;
+        static const int widths[] = {0, 7, 9, 12, 64};
+        if (ones > 0) {
+            uint64_t raw;
+            if (!in.read(widths[ones], raw)) return false;
+            dod = ones == 4 ? (int64_t)raw : signExtend(raw, widths[ones]);
+        }
+        prevDelta += dod;
+        prevTime += prevDelta;
+
+        // Value
+        if (!in.read(1, b)) return false;
+        if (b == 1) {
+            uint64_t mode;
+            if (!in.read(1, mode)) return false;
+            if (mode == 1) {
+                uint64_t lead, sig;
+                if (!in.read(5, lead) || !in.read(6, sig)) return false;
+                leading = (int)lead;
+                trailing = 64 - leading - ((int)sig + 1);
+            }
+            uint64_t bits;
+            if (!in.read(64 - leading - trailing, bits)) return false;
+            prevValue ^= bits << trailing;
+        }
+
+        p.timeMs = prevTime;
+        memcpy(&p.value, &prevValue, sizeof(double));
+        out.push_back(p);
+    }
+    return true;
+}
+
+// ------------------------------
+// SEGMENT STORE
+// ------------------------------
+
+struct HistoryStore {
+    std::string dir;
+    FILE* active = nullptr;
+    int64_t activeCreatedMs = 0;
+    size_t activeBytes = 0;
+    std::map<std::string, GorillaEncoder> openChunks;
+    std::map<std::string, int64_t> lastRecordMs;
+    std::set<std::string> knownSeries;
+};
+
+static HistoryStore store;
+
+int64_t historyNowMs() {
+    return clockWallMs();
+}
+
+bool historyIsOpen() {
+    return store.active != nullptr;
+}
+
+template <typename T>
+static void putLE(std::vector<uint8_t>& out, T v) {
+    uint8_t raw[sizeof(T)];
+    memcpy(raw, &v, sizeof(T)); // host order, little endian on supported targets
+    out.insert(out.end(), raw, raw + sizeof(T));
+}
+
+template <typename T>
+static T getLE(const uint8_t* p) {
+    T v;
+    memcpy(&v, p, sizeof(T));
+    return v;
+}
+
+static std::string defaultHistoryDir() {
+    if (const char* env = std::getenv("SYSMON_HISTORY_DIR")) return env;
+    if (const char* xdg = std::getenv("XDG_DATA_HOME")) return std::string(xdg) + "/system-monitor/history";
+    const char* home = std::getenv("HOME");
+    return std::string(home ? home : ".") + "/.local/share/system-monitor/history";
+}
+
+// Segment files sorted by creation time (encoded in the file name)
+static std::vector<std::pair<int64_t, std::string>> listSegments() {
+    std::vector<std::pair<int64_t, std::string>> segments;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(store.dir, ec)) {
+        std::string name = entry.path().filename().string();
+        long long created;
+        if (sscanf(name.c_str(), "seg-%lld.tsl", &created) == 1)
+            segments.push_back({created, entry.path().string()});
+    }
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+// Calls fn(name, count, firstMs, lastMs, payload, payloadLen) for every complete record
+template <typename Fn>
+static void forEachRecord(const uint8_t* data, size_t size, Fn fn) {
+    if (size < segmentHeaderSize || memcmp(data, segmentMagic, 4) != 0) return;
+    size_t pos = segmentHeaderSize;
+    while (pos + recordHeaderSize <= size) {
+        const uint8_t* h = data + pos;
+        if (getLE<uint32_t>(h) != recordMagic) break;
+        uint16_t nameLen = getLE<uint16_t>(h + 4);
+        uint32_t count = getLE<uint32_t>(h + 6);
+        uint32_t payloadLen = getLE<uint32_t>(h + 10);
+        int64_t firstMs = getLE<int64_t>(h + 14);
+        int64_t lastMs = getLE<int64_t>(h + 22);
+        size_t end = pos + recordHeaderSize + nameLen + payloadLen;
+        if (end > size) break; // torn write at the end of a crashed segment
+
+        const char* name = (const char*)h + recordHeaderSize;
+        fn(std::string(name, nameLen), count, firstMs, lastMs,
+           h + recordHeaderSize + nameLen, (size_t)payloadLen);
+        pos = end;
+    }
+}
+
+// Maps a whole segment read-only; returns nullptr for empty or unreadable files
+static const uint8_t* mapSegment(const std::string& path, size_t& size) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return nullptr;
+    }
+    size = (size_t)st.st_size;
+    void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    return p == MAP_FAILED ? nullptr : (const uint8_t*)p;
+}
+
+static void writeRecord(const std::string& name, const GorillaEncoder& enc) {
+    if (!store.active || enc.count() == 0) return;
+
+    std::vector<uint8_t> rec;
+    rec.reserve(recordHeaderSize + name.size() + enc.bytes().size());
+    putLE<uint32_t>(rec, recordMagic);
+    putLE<uint16_t>(rec, (uint16_t)name.size());
+    putLE<uint32_t>(rec, enc.count());
+    putLE<uint32_t>(rec, (uint32_t)enc.bytes().size());
+    putLE<int64_t>(rec, enc.firstTime());
+    putLE<int64_t>(rec, enc.lastTime());
+    rec.insert(rec.end(), name.begin(), name.end());
+    rec.insert(rec.end(), enc.bytes().begin(), enc.bytes().end());
+
+    fwrite(rec.data(), 1, rec.size(), store.active);
+    store.activeBytes += rec.size();
+}
+
+static void pruneSegments(int64_t nowMs) {
+    for (const auto& seg : listSegments()) {
+        if (seg.first < nowMs - retentionMs) {
+            std::error_code ec;
+            fs::remove(seg.second, ec);
+        }
+    }
+}
+
+static bool openSegment(int64_t nowMs) {
+    // Segment names must be unique, so bump the timestamp on collision
+    std::string path;
+    std::error_code ec;
+    do {
+        char name[64];
+        snprintf(name, sizeof(name), "seg-%013lld.tsl", (long long)nowMs);
+        path = store.dir + "/" + name;
+    } while (fs::exists(path, ec) && ++nowMs);
+
+    store.active = fopen(path.c_str(), "wb");
+    if (!store.active) return false;
+
+    std::vector<uint8_t> header(segmentMagic, segmentMagic + 4);
+    putLE<uint32_t>(header, segmentVersion);
+    putLE<int64_t>(header, nowMs);
+    fwrite(header.data(), 1, header.size(), store.active);
+
+    store.activeCreatedMs = nowMs;
+    store.activeBytes = header.size();
+    return true;
+}
+
+void historyFlush() {
+    if (!store.active) return;
+    for (auto& [name, enc] : store.openChunks) {
+        writeRecord(name, enc);
+        enc.clear();
+    }
+    fflush(store.active);
+}
+
+static void rotateIfNeeded(int64_t nowMs) {
+    if (store.activeBytes < segmentMaxBytes && nowMs - store.activeCreatedMs < segmentMaxAgeMs) return;
+
+    historyFlush();
+    fclose(store.active);
+    store.active = nullptr;
+    pruneSegments(nowMs);
+    openSegment(nowMs);
+}
+
+bool historyOpen(const std::string& dir) {
+    if (store.active) return true;
+
+    store.dir = dir.empty() ? defaultHistoryDir() : dir;
+    std::error_code ec;
+    fs::create_directories(store.dir, ec);
+
+    int64_t now = historyNowMs();
+    pruneSegments(now);
+
+    // Learn which series exist so the GUI can list them
+    for (const auto& seg : listSegments()) {
+        size_t size = 0;
+        const uint8_t* data = mapSegment(seg.second, size);
+        if (!data) continue;
+        forEachRecord(data, size, [](const std::string& name, uint32_t, int64_t, int64_t, const uint8_t*, size_t) {
+            store.knownSeries.insert(name);
+        });
+        munmap((void*)data, size);
+    }
+
+    return openSegment(now);
+}
+
+void historyClose() {
+    if (!store.active) return;
+    historyFlush();
+    fclose(store.active);
+    store.active = nullptr;
+}
+
+void historyAppend(const std::string& series, int64_t timeMs, double value) {
+    if (!store.active) return;
+
+    GorillaEncoder& enc = store.openChunks[series];
+    if (enc.count() > 0 && timeMs < enc.lastTime()) return; // series must be time ordered
+    if (enc.count() == 0) store.knownSeries.insert(series);
+
+    enc.append(timeMs, value);
+    if (enc.count() >= chunkPoints) {
+        writeRecord(series, enc);
+        enc.clear();
+        rotateIfNeeded(historyNowMs());
+    }
+}
+
+void historyRecord(const char* series, double value) {
+    if (!store.active) return;
+
+    int64_t now = historyNowMs();
+    auto it = store.lastRecordMs.find(series);
+    if (it != store.lastRecordMs.end() && now - it->second < historyIntervalMs) return;
+    store.lastRecordMs[series] = now;
+    historyAppend(series, now, value);
+}
+
+std::vector<std::string> historySeriesNames() {
+    return std::vector<std::string>(store.knownSeries.begin(), store.knownSeries.end());
+}
+
+std::vector<HistoryPoint> historyQuery(const std::string& series, int64_t fromMs, int64_t toMs) {
+    std::vector<HistoryPoint> result;
+    std::vector<HistoryPoint> chunk;
+
+    auto collect = [&](const uint8_t* payload, size_t len, uint32_t count) {
+        chunk.clear();
+        gorillaDecode(payload, len, count, chunk);
+        for (const HistoryPoint& p : chunk)
+            if (p.timeMs >= fromMs && p.timeMs <= toMs) result.push_back(p);
+    };
+
+    if (store.active) fflush(store.active);
+
+    // Record headers carry their time span, so only matching chunks are decoded
+    for (const auto& seg : listSegments()) {
+        size_t size = 0;
+        const uint8_t* data = mapSegment(seg.second, size);
+        if (!data) continue;
+        forEachRecord(data, size, [&](const std::string& name, uint32_t count, int64_t firstMs, int64_t lastMs,
+                                      const uint8_t* payload, size_t len) {
+            if (name == series && lastMs >= fromMs && firstMs <= toMs) collect(payload, len, count);
+        });
+        munmap((void*)data, size);
+    }
+
+    // Points not yet written to disk
+    auto open = store.openChunks.find(series);
+    if (open != store.openChunks.end() && open->second.count() > 0)
+        collect(open->second.bytes().data(), open->second.bytes().size(), open->second.count());
+
+    return result;
+}
+
+size_t historyDiskBytes() {
+    size_t total = 0;
+    std::error_code ec;
+    for (const auto& seg : listSegments()) total += fs::file_size(seg.second, ec);
+    return total;
+}
+
+// ------------------------------
+// SAMPLER
+// ------------------------------
+
+void historySample(const Snapshot& snap) {
+    PROFILE_ZONE("historySample");
+    if (!store.active) return;
+
+    static int64_t lastSampleMs = 0;
+    static CPUStats lastCpu = {};
+    static std::vector<CPUStats> lastCores;
+    static bool haveCpu = false;
+    static bool stealSeen = false;
+    static PsiInfo lastPsi;
+    static SchedInfo lastSched;
+
+    if (snap.timeMs - lastSampleMs < historyIntervalMs) return;
+    int64_t now = snap.timeMs;
+    int64_t interval = now - lastSampleMs;
+    lastSampleMs = now;
+
+    // Usage over the history interval rather than the last snapshot interval
+#ifdef __linux__
+    if (haveCpu) {
+        historyAppend("cpu.total", now, cpuUsageBetween(lastCpu, snap.cpu));
+
+        // Aggregate time per state, and busy % per core (iowait and steal are not busy, as in cpu.total)
+        CpuStates states = cpuStatesBetween(lastCpu, snap.cpu);
+        historyAppend("cpu.user", now, states.user);
+        historyAppend("cpu.nice", now, states.nice);
+        historyAppend("cpu.system", now, states.system);
+        historyAppend("cpu.iowait", now, states.iowait);
+        historyAppend("cpu.irq", now, states.irq);
+        historyAppend("cpu.softirq", now, states.softirq);
+        historyAppend("cpu.steal", now, states.steal);
+        historyAppend("cpu.guest", now, states.guest);
+        // Per-core steal and guest only once the host shows it runs virtualized
+        stealSeen = stealSeen || !snap.host.hypervisor.empty() || states.steal > 0.0f || states.guest > 0.0f;
+        for (size_t i = 0; i < snap.cores.size() && i < lastCores.size(); i++) {
+            CpuStates core = cpuStatesBetween(lastCores[i], snap.cores[i]);
+            std::string name = "cpu.core" + std::to_string(i);
+            historyAppend(name, now, 100.0f - core.idle - core.iowait - core.steal);
+            if (stealSeen) {
+                historyAppend(name + ".steal", now, core.steal);
+                historyAppend(name + ".guest", now, core.guest);
+            }
+        }
+    }
+    if (snap.steal.windowSeconds > 0.0f) historyAppend("cpu.steal_1m", now, snap.steal.percent);
+    lastCpu = snap.cpu;
+    lastCores = snap.cores;
+    haveCpu = true;
+#else
+    historyAppend("cpu.total", now, snap.cpuPercent);
+#endif
+
+    // Frequency and idle residency are already averaged over the snapshot interval
+    if (snap.freq.found) {
+        historyAppend("cpu.freq_mhz", now, snap.freq.avgMHz);
+        for (size_t k = 0; k < snap.freq.idleStates.size(); k++) {
+            double sum = 0.0;
+            for (const CoreFreq& core : snap.freq.cores) sum += core.idlePercent[k];
+            historyAppend("cpu.idle." + snap.freq.idleStates[k] + "_pct", now, sum / snap.freq.cores.size());
+        }
+    }
+
+    // Stall share over the history interval, from the pressure totals
+    for (int r = 0; r < PsiResources; r++) {
+        const PsiStats& psi = snap.psi.resources[r];
+        const PsiStats& last = lastPsi.resources[r];
+        if (!psi.found || !last.found || interval <= 0) continue;
+        std::string prefix = std::string("psi.") + psiResourceName((PsiResource)r);
+        if (psi.some.totalUs >= last.some.totalUs)
+            historyAppend(prefix + ".some_pct", now, (psi.some.totalUs - last.some.totalUs) / (interval * 10.0));
+        if (psi.hasFull && psi.full.totalUs >= last.full.totalUs)
+            historyAppend(prefix + ".full_pct", now, (psi.full.totalUs - last.full.totalUs) / (interval * 10.0));
+    }
+    lastPsi = snap.psi;
+
+    // Load and run queue as sampled; switches, forks and run-queue delay over the history interval
+    if (snap.sched.loadFound) historyAppend("sched.load1", now, snap.sched.load1);
+    if (snap.sched.counters.ctxt > 0) {
+        historyAppend("sched.procs_running", now, snap.sched.counters.procsRunning);
+        historyAppend("sched.procs_blocked", now, snap.sched.counters.procsBlocked);
+    }
+    if (interval > 0 && lastSched.counters.ctxt > 0) {
+        const ProcStatCounters& a = lastSched.counters;
+        const ProcStatCounters& b = snap.sched.counters;
+        if (b.ctxt >= a.ctxt) historyAppend("sched.ctxt_per_s", now, (b.ctxt - a.ctxt) * 1000.0 / interval);
+        if (b.forks >= a.forks) historyAppend("sched.forks_per_s", now, (b.forks - a.forks) * 1000.0 / interval);
+    }
+    if (interval > 0 && snap.sched.schedstatFound && lastSched.cpus.size() == snap.sched.cpus.size()) {
+        uint64_t delayNs = 0;
+        for (size_t i = 0; i < snap.sched.cpus.size(); i++)
+            if (snap.sched.cpus[i].runDelayNs >= lastSched.cpus[i].runDelayNs)
+                delayNs += snap.sched.cpus[i].runDelayNs - lastSched.cpus[i].runDelayNs;
+        historyAppend("sched.run_delay_ms_per_s", now, delayNs / 1e6 * 1000.0 / interval);
+    }
+    lastSched = snap.sched;
+
+    // Already rates over the snapshot interval
+    if (snap.irq.found && snap.irq.intervalMs > 0.0f) {
+        double hard = 0.0;
+        for (const IrqSource& source : snap.irq.sources) {
+            if (!source.soft) hard += irqRate(snap.irq, source);
+            else if (source.name == "NET_RX") historyAppend("softirq.net_rx_per_s", now, irqRate(snap.irq, source));
+        }
+        historyAppend("irq.total_per_s", now, hard);
+    }
+
+    if (snap.perf.found && snap.perf.intervalMs > 0.0f) {
+        CorePerf total;
+        for (const CorePerf& core : snap.perf.cores)
+            for (int c = 0; c < PerfCounters; c++) total.counts[c] += core.counts[c];
+        const uint64_t* c = total.counts;
+        if ((snap.perf.available & (1 << PerfCycles)) && c[PerfCycles] > 0 && c[PerfInstructions] > 0) {
+            historyAppend("perf.ipc", now, (double)c[PerfInstructions] / c[PerfCycles]);
+            historyAppend("perf.cache_mpki", now, 1000.0 * c[PerfCacheMisses] / c[PerfInstructions]);
+            historyAppend("perf.branch_mpki", now, 1000.0 * c[PerfBranchMisses] / c[PerfInstructions]);
+        }
+        double seconds = snap.perf.intervalMs / 1000.0;
+        historyAppend("perf.ctx_per_s", now, c[PerfContextSwitches] / seconds);
+        historyAppend("perf.faults_per_s", now, c[PerfPageFaults] / seconds);
+        historyAppend("perf.migrations_per_s", now, c[PerfMigrations] / seconds);
+    }
+
+    if (snap.memTotalMB > 0.0f) historyAppend("mem.used_mb", now, snap.memUsedMB);
+    if (snap.swap.errorMessage.empty()) historyAppend("swap.used_mb", now, snap.swap.usedMB);
+
+    for (const auto& [iface, ns] : snap.net) {
+        historyAppend("net." + iface + ".rx_bytes", now, (double)ns.rx_bytes);
+        historyAppend("net." + iface + ".tx_bytes", now, (double)ns.tx_bytes);
+    }
+
+    if (snap.thermalFound) historyAppend("thermal.cpu_c", now, snap.temperatureC);
+    if (snap.fan.active) historyAppend("fan.rpm", now, snap.fan.speedRPM);
+}
+
+// ------------------------------
+// UI RENDERING FUNCTION FOR HISTORY WINDOW
+// ------------------------------
+
+void renderHistoryWindow(const char* id, ImVec2 size, ImVec2 position) {
+    PROFILE_ZONE("renderHistoryWindow");
+    ImGui::SetNextWindowSize(size, ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowPos(position, ImGuiCond_FirstUseEver);
+
+    if (!ImGui::Begin(id)) {
+        ImGui::End();
+        return;
+    }
+
+    if (!historyIsOpen()) {
+        ImGui::TextColored(ImVec4(1, 0, 0, 1), "History directory could not be opened.");
+        ImGui::End();
+        return;
+    }
+
+    static std::vector<std::string> names;
+    static int selected = 0;
+    static float fromHoursAgo = 1.0f;
+    static float toHoursAgo = 0.0f;
+    static bool asRate = false;
+    static PlotHistory values(SIZE_MAX);
+    static std::vector<HistoryPoint> points;
+    static bool loadedAsRate = false;
+    static float minValue = 0.0f, maxValue = 0.0f, avgValue = 0.0f;
+    static size_t diskBytes = 0;
+
+    if (names.empty() || ImGui::Button("Refresh Series")) {
+        names = historySeriesNames();
+        diskBytes = historyDiskBytes();
+    }
+    if (names.empty()) {
+        ImGui::Text("No history recorded yet.");
+        ImGui::End();
+        return;
+    }
+    if (selected >= (int)names.size()) selected = 0;
+
+    if (ImGui::BeginCombo("Series", names[selected].c_str())) {
+        for (int i = 0; i < (int)names.size(); ++i) {
+            if (ImGui::Selectable(names[i].c_str(), i == selected)) selected = i;
+        }
+        ImGui::EndCombo();
+    }
+
+    ImGui::SliderFloat("From (hours ago)", &fromHoursAgo, 0.0f, 24.0f * 30, "%.2f h", ImGuiSliderFlags_Logarithmic);
+    ImGui::SliderFloat("To (hours ago)", &toHoursAgo, 0.0f, 24.0f * 30, "%.2f h", ImGuiSliderFlags_Logarithmic);
+    ImGui::Checkbox("Show as rate (per second)", &asRate);
+
+    if (ImGui::Button("Load")) {
+        int64_t now = historyNowMs();
+        int64_t from = now - (int64_t)(std::max(fromHoursAgo, toHoursAgo) * 3600 * 1000);
+        int64_t to = now - (int64_t)(std::min(fromHoursAgo, toHoursAgo) * 3600 * 1000);
+        points = historyQuery(names[selected], from, to);
+        diskBytes = historyDiskBytes();
+        loadedAsRate = !asRate; // force a rebuild below
+    }
+
+    // Counters (e.g. network bytes) are more useful as a per-second rate
+    if (loadedAsRate != asRate) {
+        loadedAsRate = asRate;
+        values.clear();
+        for (size_t i = 0; i < points.size(); ++i) {
+            if (!asRate) {
+                values.push((float)points[i].value);
+            } else if (i > 0 && points[i].timeMs > points[i - 1].timeMs) {
+                double dt = (points[i].timeMs - points[i - 1].timeMs) / 1000.0;
+                values.push((float)((points[i].value - points[i - 1].value) / dt));
+            }
+        }
+
+        if (!values.empty()) {
+            const std::deque<float>& v = values.samples();
+            auto [minIt, maxIt] = std::minmax_element(v.begin(), v.end());
+            double sum = 0.0;
+            for (float x : v) sum += x;
+            minValue = *minIt;
+            maxValue = *maxIt;
+            avgValue = (float)(sum / v.size());
+        }
+    }
+
+    if (!values.empty()) {
+        values.plot("##history", minValue, maxValue, ImVec2(ImGui::GetContentRegionAvail().x, 120));
+        ImGui::Text("Points: %zu  Min: %.2f  Max: %.2f  Avg: %.2f",
+                    values.size(), minValue, maxValue, avgValue);
+    } else {
+        ImGui::Text("No points in the selected range.");
+    }
+
+    ImGui::Text("On disk: %.2f MB", diskBytes / (1024.0 * 1024.0));
+
+    ImGui::End();
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// ------------------------------
+// ON-DISK METRIC HISTORY
+// ------------------------------
+//
+// History is stored as an append-only log of segment files in the history
+// directory ($SYSMON_HISTORY_DIR, else $XDG_DATA_HOME/system-monitor/history,
+// else ~/.local/share/system-monitor/history).
+//
+// Segment file layout (little endian):
+//   header : "SMTS" | u32 version | i64 createdMs
+//   record : u32 magic | u16 nameLen | u32 count | u32 payloadLen
+//            | i64 firstMs | i64 lastMs | name | payload
+//
+// Each record holds one closed chunk of a single series, compressed with the
+// Gorilla scheme: delta-of-delta timestamps and XOR'd float values.
+// The active segment is rotated by size and age; closed segments are mmap'd
+// when a past time range is queried.
+
+// One timestamped sample of a metric series (time in ms since the Unix epoch)
+struct HistoryPoint {
+    int64_t timeMs;
+    double value;
+};
+
+// Gorilla chunk encoder: appends points to an in-memory bit stream
+class GorillaEncoder {
+public:
+    void append(int64_t timeMs, double value);
+    void clear();
+
+    const std::vector<uint8_t>& bytes() const { return buffer; }
+    uint32_t count() const { return pointCount; }
+    int64_t firstTime() const { return firstTimeMs; }
+    int64_t lastTime() const { return prevTime; }
+
+private:
+    void writeBits(uint64_t value, int bits);
+
+    std::vector<uint8_t> buffer;
+    int bitPos = 0;              // bits used in the last byte (0 = byte is full)
+    uint32_t pointCount = 0;
+    int64_t firstTimeMs = 0;
+    int64_t prevTime = 0;
+    int64_t prevDelta = 0;
+    uint64_t prevValueBits = 0;
+    int prevLeading = -1;        // -1 until the first XOR window is written
+    int prevTrailing = 0;
+};
+
+// Decodes `count` points from a Gorilla payload and appends them to `out`
+// Returns false if the payload is truncated
+bool gorillaDecode(const uint8_t* data, size_t size, uint32_t count, std::vector<HistoryPoint>& out);
+
+// Opens (or creates) the history directory, empty = default location
+bool historyOpen(const std::string& dir = "");
+
+// Flushes open chunks and closes the active segment
+void historyClose();
+
+// Whether historyOpen succeeded
+bool historyIsOpen();
+
+// Records a sample stamped with the current wall-clock time,
+// rate-limited to one point per series per historyIntervalMs
+void historyRecord(const char* series, double value);
+
+// Appends a sample with an explicit timestamp (no rate limit)
+void historyAppend(const std::string& series, int64_t timeMs, double value);
+
+// Writes all open chunks to the active segment
+void historyFlush();
+
+// Names of all series present on disk or in memory
+std::vector<std::string> historySeriesNames();
+
+// All points of `series` with fromMs <= time <= toMs, in time order
+std::vector<HistoryPoint> historyQuery(const std::string& series, int64_t fromMs, int64_t toMs);
+
+// Bytes currently used by all segment files
+size_t historyDiskBytes();
+
+struct Snapshot;
+
+// Records the values of a live snapshot (rate limited to historyIntervalMs)
+void historySample(const Snapshot& snap);
+
+// Current wall-clock time in ms since the Unix epoch (from the active clock)
+int64_t historyNowMs();
+
+// Minimum spacing between two recorded points of one series
+extern int historyIntervalMs;
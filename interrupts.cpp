@@ -0,0 +1,367 @@
+#include "interrupts.h"
+#include "heatmap.h"
+#include "procfs.h"
+#include "profiler.h"
+#include "snapshot.h"
+#include <imgui.h>
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+
+// ------------------------------
+// PARSER STATE
+// ------------------------------
+
+// A source is a storm when its rate is this many times its recent average
+// (and at least stormMinRate), once the average has settled
+static const double stormFactor = 8.0;
+static const double stormMinRate = 1000.0;
+static const int stormWarmup = 5;
+static const double stormAlpha = 0.1;
+
+// NET_RX is imbalanced when one cpu takes this share of at least netRxMinRate softirqs/s
+static const float netRxImbalanceShare = 0.75f;
+static const double netRxMinRate = 1000.0;
+
+struct IrqRow {
+    std::string name;
+    std::string label;
+    std::vector<uint64_t> last;   // counts per column at the previous read
+    bool seen = false;
+    double avgRate = 0.0;
+    int rounds = 0;
+};
+
+struct IrqFile {
+    const char* path;
+    bool soft;
+    ProcHandle handle;
+    std::vector<int> cpus;        // header columns
+    std::vector<int> columns;     // header column -> IrqInfo::cpus column, -1 if missing
+    std::vector<IrqRow> rows;
+};
+
+struct IrqTable {
+    IrqFile files[2] = {{"/proc/interrupts", false, {}, {}, {}, {}}, {"/proc/softirqs", true, {}, {}, {}, {}}};
+    bool opened = false;
+    int64_t lastTimeMs = 0;
+};
+
+static IrqTable table;
+
+// "           CPU0       CPU1       CPU3" -> {0, 1, 3}
+static void parseHeader(const char* p, const char* end, std::vector<int>& cpus) {
+    cpus.clear();
+    while (p < end) {
+        while (p < end && *p == ' ') p++;
+        if (end - p < 4 || strncmp(p, "CPU", 3) != 0) break;
+        char* next;
+        cpus.push_back((int)strtol(p + 3, &next, 10));
+        p = next;
+    }
+}
+
+static bool sameText(const std::string& s, const char* p, size_t len) {
+    return s.size() == len && memcmp(s.data(), p, len) == 0;
+}
+
+static void parseFile(IrqFile& file, const std::string& text, double intervalMs, IrqInfo& info) {
+    const char* line = text.c_str();
+    const char* eol = strchr(line, '\n');
+    if (!eol) return;
+
+    // A different header (cpu hotplug) drops the rows and their counts
+    static std::vector<int> header;
+    parseHeader(line, eol, header);
+    if (header != file.cpus) {
+        file.cpus = header;
+        file.rows.clear();
+    }
+    if (info.cpus.empty()) info.cpus = file.cpus;
+    file.columns.resize(file.cpus.size());
+    for (size_t c = 0; c < file.cpus.size(); c++) {
+        auto it = std::find(info.cpus.begin(), info.cpus.end(), file.cpus[c]);
+        file.columns[c] = it == info.cpus.end() ? -1 : (int)(it - info.cpus.begin());
+    }
+
+    static std::vector<uint64_t> values;
+    size_t cols = file.cpus.size();
+    values.resize(cols);
+    size_t row = 0;
+    for (line = eol + 1; *line; line = *eol ? eol + 1 : eol) {
+        eol = strchr(line, '\n');
+        if (!eol) eol = line + strlen(line);
+        const char* p = line;
+        while (p < eol && *p == ' ') p++;
+        const char* colon = (const char*)memchr(p, ':', eol - p);
+        if (!colon) continue;
+        const char* name = p;
+        size_t nameLen = colon - p;
+
+        // Counts stop early on lines like ERR and MIS; strtoull must not run into the next line
+        size_t got = 0;
+        for (p = colon + 1; got < cols; got++) {
+            while (p < eol && *p == ' ') p++;
+            if (p >= eol || !isdigit((unsigned char)*p)) break;
+            char* end;
+            values[got] = strtoull(p, &end, 10);
+            p = end;
+        }
+        while (p < eol && isspace((unsigned char)*p)) p++;
+        const char* label = p;
+        const char* labelEnd = eol;
+        while (labelEnd > label && isspace((unsigned char)labelEnd[-1])) labelEnd--;
+
+        if (row >= file.rows.size()) file.rows.emplace_back();
+        IrqRow& r = file.rows[row++];
+        if (!sameText(r.name, name, nameLen) || !sameText(r.label, label, labelEnd - label)) {
+            r.name.assign(name, nameLen);
+            r.label.assign(label, labelEnd - label);
+            r.seen = false;
+            r.avgRate = 0.0;
+            r.rounds = 0;
+        }
+
+        IrqSource source;
+        source.name = r.name;
+        source.label = r.label;
+        source.soft = file.soft;
+        source.deltas.assign(info.cpus.size(), 0);
+        r.last.resize(cols, 0);
+        for (size_t c = 0; c < got; c++) {
+            if (r.seen && values[c] >= r.last[c] && file.columns[c] >= 0) {
+                uint64_t d = values[c] - r.last[c];
+                source.deltas[file.columns[c]] = (uint32_t)std::min<uint64_t>(d, UINT32_MAX);
+                source.total += d;
+            }
+            r.last[c] = values[c];
+        }
+
+        if (r.seen && intervalMs > 0.0) {
+            double rate = source.total * 1000.0 / intervalMs;
+            source.storm = r.rounds >= stormWarmup && rate >= stormMinRate && rate > stormFactor * r.avgRate;
+            r.avgRate = r.rounds == 0 ? rate : r.avgRate + (rate - r.avgRate) * stormAlpha;
+            r.rounds++;
+        }
+        r.seen = true;
+        info.sources.push_back(std::move(source));
+    }
+    file.rows.resize(row);
+}
+
+// ------------------------------
+// READING
+// ------------------------------
+
+float irqRate(const IrqInfo& info, uint32_t delta) {
+    return info.intervalMs > 0.0f ? delta * 1000.0f / info.intervalMs : 0.0f;
+}
+
+float irqRate(const IrqInfo& info, const IrqSource& source) {
+    return info.intervalMs > 0.0f ? (float)(source.total * 1000.0 / info.intervalMs) : 0.0f;
+}
+
+IrqInfo readInterrupts(int64_t timeMs) {
+    PROFILE_ZONE("readInterrupts");
+    // Held open; a read still runs to the end, past the first few KB of rows on a big host
+    if (!table.opened) {
+        for (IrqFile& file : table.files) procOpenHandle(file.path, file.handle);
+        table.opened = true;
+    }
+
+    IrqInfo info;
+    info.intervalMs = table.lastTimeMs > 0 ? (float)(timeMs - table.lastTimeMs) : 0.0f;
+    table.lastTimeMs = timeMs;
+
+    info.sources.reserve(table.files[0].rows.size() + table.files[1].rows.size());
+    static std::string buffer;
+    for (IrqFile& file : table.files) {
+        if (!procReadHandle(file.handle, buffer)) continue;
+        info.found = true;
+        parseFile(file, buffer, info.intervalMs, info);
+    }
+
+    for (const IrqSource& source : info.sources) {
+        if (!source.soft || source.name != "NET_RX" || source.total == 0) continue;
+        size_t busiest = std::max_element(source.deltas.begin(), source.deltas.end()) - source.deltas.begin();
+        info.netRxCpu = info.cpus[busiest];
+        info.netRxShare = (float)source.deltas[busiest] / source.total;
+        info.netRxImbalance = info.cpus.size() > 1 && irqRate(info, source) >= netRxMinRate &&
+                              info.netRxShare >= netRxImbalanceShare;
+    }
+    return info;
+}
+
+// ------------------------------
+// UI RENDERING FUNCTION FOR INTERRUPTS TAB
+// ------------------------------
+
+enum IrqColumn { ColSource, ColLabel, ColRate, ColBusiest, ColShare };
+
+static bool showSoftirqs = true;
+static bool hideIdle = true;
+static std::string selectedSource;   // name shown in the heatmap; empty = all hardware interrupts
+static bool selectedSoft = false;
+
+static HeatmapTexture irqHeatmap(600);
+static std::vector<float> heatColumn;
+static std::vector<float> heatRates;
+static uint64_t lastIrqSequence = 0;
+static uint64_t lastIrqEpoch = 0;
+
+// Column with the most increments and its share of the total
+static std::pair<int, float> busiestColumn(const IrqSource& source) {
+    if (source.total == 0 || source.deltas.empty()) return {-1, 0.0f};
+    size_t i = std::max_element(source.deltas.begin(), source.deltas.end()) - source.deltas.begin();
+    return {(int)i, (float)source.deltas[i] / source.total};
+}
+
+// Per-cpu rates of the selected source (or all hardware interrupts) into heatRates
+static void selectedRates(const IrqInfo& info) {
+    heatRates.assign(info.cpus.size(), 0.0f);
+    for (const IrqSource& source : info.sources) {
+        bool match = selectedSource.empty() ? !source.soft
+                                            : source.soft == selectedSoft && source.name == selectedSource;
+        if (!match) continue;
+        for (size_t c = 0; c < source.deltas.size() && c < heatRates.size(); c++)
+            heatRates[c] += irqRate(info, source.deltas[c]);
+    }
+}
+
+void renderInterruptsTab() {
+    PROFILE_ZONE("renderInterruptsTab");
+    const IrqInfo& info = currentSnapshot().irq;
+    if (!info.found) {
+        ImGui::Text("No /proc/interrupts or /proc/softirqs.");
+        return;
+    }
+
+    // ------------------
+    // FLAGS
+    // ------------------
+
+    const ImVec4 warn(1.0f, 0.4f, 0.3f, 1.0f);
+    if (info.netRxImbalance)
+        ImGui::TextColored(warn, "NET_RX imbalance: cpu%d handles %.0f%% of network receive softirqs (check RSS/RPS or irqbalance)",
+                           info.netRxCpu, info.netRxShare * 100.0f);
+    for (const IrqSource& source : info.sources)
+        if (source.storm)
+            ImGui::TextColored(warn, "Interrupt storm: %s %s at %.0f/s", source.name.c_str(), source.label.c_str(),
+                               irqRate(info, source));
+
+    // ------------------
+    // HEATMAP
+    // ------------------
+
+    if (snapshotEpoch() != lastIrqEpoch) {
+        lastIrqEpoch = snapshotEpoch();
+        irqHeatmap.clear();
+    }
+    if (snapshotSequence() != lastIrqSequence) {
+        lastIrqSequence = snapshotSequence();
+        selectedRates(info);
+        // Each column is scaled to its busiest cpu, so the map shows the spread rather than the volume
+        float peak = heatRates.empty() ? 0.0f : *std::max_element(heatRates.begin(), heatRates.end());
+        heatColumn.resize(heatRates.size());
+        for (size_t c = 0; c < heatRates.size(); c++) heatColumn[c] = peak > 0.0f ? heatRates[c] / peak : 0.0f;
+        irqHeatmap.push(heatColumn);
+    }
+
+    ImGui::Text("Per-cpu spread of %s over time (rows are cpus)",
+                selectedSource.empty() ? "all hardware interrupts" : selectedSource.c_str());
+    if (!selectedSource.empty()) {
+        ImGui::SameLine();
+        if (ImGui::SmallButton("Show all")) {
+            selectedSource.clear();
+            irqHeatmap.clear();
+        }
+    }
+    irqHeatmap.draw();
+    int row = irqHeatmap.hoveredRow();
+    if (row >= 0 && row < (int)info.cpus.size() && row < (int)heatRates.size())
+        ImGui::SetTooltip("cpu%d: %.0f/s", info.cpus[row], heatRates[row]);
+
+    // ------------------
+    // RATE TABLE
+    // ------------------
+
+    ImGui::Checkbox("Softirqs", &showSoftirqs);
+    ImGui::SameLine();
+    ImGui::Checkbox("Hide idle", &hideIdle);
+
+    static std::vector<int> order;
+    order.clear();
+    for (int i = 0; i < (int)info.sources.size(); i++) {
+        const IrqSource& source = info.sources[i];
+        if ((!showSoftirqs && source.soft) || (hideIdle && source.total == 0)) continue;
+        order.push_back(i);
+    }
+
+    ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY |
+                            ImGuiTableFlags_Sortable | ImGuiTableFlags_Resizable;
+    if (!ImGui::BeginTable("Interrupts", 5, flags, ImVec2(0, 300))) return;
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableSetupColumn("Source", ImGuiTableColumnFlags_None, 0.0f, ColSource);
+    ImGui::TableSetupColumn("Description", ImGuiTableColumnFlags_None, 0.0f, ColLabel);
+    ImGui::TableSetupColumn("Rate/s", ImGuiTableColumnFlags_DefaultSort | ImGuiTableColumnFlags_PreferSortDescending, 0.0f, ColRate);
+    ImGui::TableSetupColumn("Busiest cpu", ImGuiTableColumnFlags_None, 0.0f, ColBusiest);
+    ImGui::TableSetupColumn("Share", ImGuiTableColumnFlags_PreferSortDescending, 0.0f, ColShare);
+    ImGui::TableHeadersRow();
+
+    // Rates change every round, so the order is rebuilt every frame (a few hundred rows at most)
+    if (const ImGuiTableSortSpecs* specs = ImGui::TableGetSortSpecs()) {
+        if (specs->SpecsCount > 0) {
+            const ImGuiTableColumnSortSpecs& spec = specs->Specs[0];
+            bool descending = spec.SortDirection == ImGuiSortDirection_Descending;
+            auto key = [&](const IrqSource& s) -> float {
+                switch (spec.ColumnUserID) {
+                case ColBusiest: return (float)busiestColumn(s).first;
+                case ColShare: return busiestColumn(s).second;
+                default: return irqRate(info, s);
+                }
+            };
+            std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+                const IrqSource& x = info.sources[a];
+                const IrqSource& y = info.sources[b];
+                if (spec.ColumnUserID == ColSource || spec.ColumnUserID == ColLabel) {
+                    const std::string& u = spec.ColumnUserID == ColSource ? x.name : x.label;
+                    const std::string& v = spec.ColumnUserID == ColSource ? y.name : y.label;
+                    return descending ? v < u : u < v;
+                }
+                return descending ? key(y) < key(x) : key(x) < key(y);
+            });
+        }
+    }
+
+    ImGuiListClipper clipper;
+    clipper.Begin((int)order.size());
+    while (clipper.Step()) {
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+            const IrqSource& source = info.sources[order[i]];
+            auto [busiest, share] = busiestColumn(source);
+            ImGui::TableNextRow();
+            ImGui::TableSetColumnIndex(0);
+            ImGui::PushID(order[i]);
+            bool selected = source.soft == selectedSoft && source.name == selectedSource;
+            if (ImGui::Selectable(source.name.c_str(), selected, ImGuiSelectableFlags_SpanAllColumns)) {
+                selectedSource = source.name;
+                selectedSoft = source.soft;
+                irqHeatmap.clear();
+            }
+            ImGui::PopID();
+            ImGui::TableSetColumnIndex(1);
+            if (source.storm) ImGui::TextColored(warn, "%s (storm)", source.label.c_str());
+            else ImGui::TextUnformatted(source.soft ? "softirq" : source.label.c_str());
+            ImGui::TableSetColumnIndex(2);
+            ImGui::Text("%.0f", irqRate(info, source));
+            ImGui::TableSetColumnIndex(3);
+            if (busiest >= 0) ImGui::Text("cpu%d", info.cpus[busiest]);
+            else ImGui::TextUnformatted("-");
+            ImGui::TableSetColumnIndex(4);
+            ImGui::Text("%.0f%%", share * 100.0f);
+        }
+    }
+    ImGui::EndTable();
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ------------------------------
+// INTERRUPTS AND SOFTIRQS
+// ------------------------------
+//
+// /proc/interrupts and /proc/softirqs as one matrix of sources x cpus,
+// holding the count increments since the previous read. The parser keeps
+// its rows between rounds and only copies a name or label when the layout
+// changes, so a round on a 256-cpu host parses numbers in place.
+
+struct IrqSource {
+    std::string name;                // "24", "LOC", "NET_RX"
+    std::string label;               // controller and device, e.g. "PCI-MSI 524288-edge eth0-TxRx-0"
+    bool soft = false;               // from /proc/softirqs
+    bool storm = false;              // rate jumped far above its recent average
+    uint64_t total = 0;              // increments over all cpus
+    std::vector<uint32_t> deltas;    // increments per column of IrqInfo::cpus
+};
+
+struct IrqInfo {
+    bool found = false;
+    float intervalMs = 0.0f;         // time the increments cover; 0 on the first read
+    std::vector<int> cpus;           // cpu number of each column (offline cpus have none)
+    std::vector<IrqSource> sources;  // hardware interrupts first, then softirqs
+
+    // NET_RX softirqs concentrated on one cpu
+    int netRxCpu = -1;               // busiest cpu for NET_RX, -1 without NET_RX work
+    float netRxShare = 0.0f;         // its share of all NET_RX softirqs
+    bool netRxImbalance = false;
+};
+
+// Increments are relative to the previous call's timeMs
+IrqInfo readInterrupts(int64_t timeMs);
+
+// Per second rate of one source, or of one of its cells
+float irqRate(const IrqInfo& info, const IrqSource& source);
+float irqRate(const IrqInfo& info, uint32_t delta);
+
+// Sortable rate table, per-cpu heatmap and the imbalance and storm flags
+void renderInterruptsTab();
@@ -0,0 +1,289 @@
+#include "inventory.h"
+#include "procfs.h"
+#include "profiler.h"
+#include <imgui.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <sys/utsname.h>
+
+// ------------------------------
+// PARSING HELPERS
+// ------------------------------
+
+static const std::string cpuDir = "/sys/devices/system/cpu";
+
+// Expands a kernel cpu list such as "0-3,8,10-11"
+static std::vector<int> parseCpuList(const std::string& text) {
+    std::vector<int> ids;
+    const char* p = text.c_str();
+    char* end;
+    while (true) {
+        long first = strtol(p, &end, 10);
+        if (end == p) break;
+        long last = first;
+        p = end;
+        if (*p == '-') {
+            last = strtol(p + 1, &end, 10);
+            p = end;
+        }
+        for (long id = first; id <= last && id - first < 65536; id++) ids.push_back((int)id);
+        if (*p != ',') break;
+        p++;
+    }
+    return ids;
+}
+
+static std::string trimmed(std::string text) {
+    text.erase(0, text.find_first_not_of(" \t\n"));
+    text.erase(text.find_last_not_of(" \t\n") + 1);
+    return text;
+}
+
+static bool readTrimmed(const std::string& path, std::string& out) {
+    if (!procReadFile(path, out)) return false;
+    out = trimmed(out);
+    return true;
+}
+
+static int readInt(const std::string& path, int fallback) {
+    std::string text;
+    if (!procReadFile(path, text)) return fallback;
+    return atoi(text.c_str());
+}
+
+// Value of the first "key : value" line of /proc/cpuinfo
+static std::string cpuinfoField(const std::string& cpuinfo, const char* key) {
+    size_t pos = cpuinfo.find(std::string("\n") + key);
+    if (pos == std::string::npos && cpuinfo.compare(0, strlen(key), key) == 0) pos = 0;
+    else if (pos != std::string::npos) pos++;
+    if (pos == std::string::npos) return "";
+    size_t colon = cpuinfo.find(':', pos);
+    size_t eol = cpuinfo.find('\n', pos);
+    if (colon == std::string::npos || colon > eol) return "";
+    return trimmed(cpuinfo.substr(colon + 1, eol - colon - 1));
+}
+
+// ------------------------------
+// BUILDING
+// ------------------------------
+
+// Brand and vendor strings from cpuid; only meaningful for the machine we run on
+static bool cpuidModel(std::string& model, std::string& vendor) {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int regs[4];
+    if (!__get_cpuid(0, &regs[0], &regs[1], &regs[2], &regs[3])) return false;
+    char vendorId[13];
+    memcpy(vendorId, &regs[1], 4);
+    memcpy(vendorId + 4, &regs[3], 4);
+    memcpy(vendorId + 8, &regs[2], 4);
+    vendorId[12] = '\0';
+    vendor = vendorId;
+
+    if (!__get_cpuid(0x80000000, &regs[0], &regs[1], &regs[2], &regs[3]) || regs[0] < 0x80000004) return false;
+    char brand[49] = {};
+    for (unsigned int leaf = 0; leaf < 3; leaf++) {
+        __get_cpuid(0x80000002 + leaf, &regs[0], &regs[1], &regs[2], &regs[3]);
+        memcpy(brand + leaf * 16, regs, 16);
+    }
+    model = trimmed(brand);
+    return !model.empty();
+#else
+    return false;
+#endif
+}
+
+// Hypervisor vendor from cpuid leaf 0x40000000; empty when cpuid says we run on bare metal
+static bool cpuidHypervisor(std::string& hypervisor) {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int regs[4];
+    if (!__get_cpuid(1, &regs[0], &regs[1], &regs[2], &regs[3])) return false;
+    hypervisor.clear();
+    if (!(regs[2] & (1u << 31))) return true;  // the "hypervisor present" bit
+
+    // The leaf is outside the ranges __get_cpuid checks, so query it directly
+    __cpuid(0x40000000, regs[0], regs[1], regs[2], regs[3]);
+    char signature[13];
+    memcpy(signature, &regs[1], 4);
+    memcpy(signature + 4, &regs[2], 4);
+    memcpy(signature + 8, &regs[3], 4);
+    signature[12] = '\0';
+
+    static const struct { const char* signature; const char* name; } known[] = {
+        {"KVMKVMKVM", "KVM"},         {"Linux KVM Hv", "KVM"},     {"Microsoft Hv", "Hyper-V"},
+        {"VMwareVMware", "VMware"},   {"XenVMMXenVMM", "Xen"},     {"TCGTCGTCGTCG", "QEMU (TCG)"},
+        {"VBoxVBoxVBox", "VirtualBox"}, {" lrpepyh  vr", "Parallels"}, {"bhyve bhyve ", "bhyve"},
+        {"ACRNACRNACRN", "ACRN"},     {"QNXQVMBSQG", "QNX"},
+    };
+    for (const auto& entry : known)
+        if (strcmp(signature, entry.signature) == 0) {
+            hypervisor = entry.name;
+            return true;
+        }
+    hypervisor = trimmed(signature);
+    if (hypervisor.empty()) hypervisor = "unknown";
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Hypervisor of a fixture or archive: Xen's /sys/hypervisor, else the cpuinfo flag and the DMI vendor
+static std::string procHypervisor(const std::string& cpuinfo) {
+    std::string text;
+    if (readTrimmed("/sys/hypervisor/type", text) && !text.empty()) return text == "xen" ? "Xen" : text;
+    if ((" " + cpuinfoField(cpuinfo, "flags") + " ").find(" hypervisor ") == std::string::npos) return "";
+    if (readTrimmed("/sys/class/dmi/id/sys_vendor", text) && !text.empty()) return text;
+    return "unknown";
+}
+
+static HostInfo buildInventory() {
+    PROFILE_ZONE("buildInventory");
+    HostInfo info;
+    info.osName = getOsName();
+    info.user = getLoggedInUser();
+    info.hostname = getComputerName();
+
+    // cpuid describes this machine, so a fixture or an archive uses its own /proc/cpuinfo
+    std::string cpuinfo;
+    bool local = !isArchiveOpen() && procRoot().empty();
+    if (!local || !cpuidModel(info.cpuModel, info.cpuVendor)) {
+        procReadFile("/proc/cpuinfo", cpuinfo);
+        info.cpuModel = cpuinfoField(cpuinfo, "model name");
+        info.cpuVendor = cpuinfoField(cpuinfo, "vendor_id");
+        if (info.cpuModel.empty()) info.cpuModel = "Unknown CPU";
+    }
+    if (!local || !cpuidHypervisor(info.hypervisor)) {
+        if (cpuinfo.empty()) procReadFile("/proc/cpuinfo", cpuinfo);
+        info.hypervisor = procHypervisor(cpuinfo);
+    }
+
+    if (!readTrimmed("/proc/sys/kernel/osrelease", info.kernel)) {
+        struct utsname name;
+        if (local && uname(&name) == 0) info.kernel = name.release;
+    }
+
+    // Topology of the online cpus
+    std::string text;
+    std::vector<int> cpus;
+    if (procReadFile(cpuDir + "/online", text)) cpus = parseCpuList(text);
+    std::set<int> packages;
+    std::set<std::pair<int, int>> cores;
+    for (int cpu : cpus) {
+        std::string topology = cpuDir + "/cpu" + std::to_string(cpu) + "/topology/";
+        int package = readInt(topology + "physical_package_id", 0);
+        packages.insert(package);
+        cores.insert({package, readInt(topology + "core_id", cpu)});
+    }
+    info.threads = (int)cpus.size();
+    info.sockets = std::max<int>(1, (int)packages.size());
+    info.cores = cores.empty() ? info.threads : (int)cores.size();
+
+    // Cache hierarchy seen from cpu0
+    std::vector<std::string> indices;
+    if (procListDir(cpuDir + "/cpu0/cache", indices)) {
+        std::sort(indices.begin(), indices.end());
+        for (const std::string& index : indices) {
+            if (index.compare(0, 5, "index") != 0) continue;
+            std::string dir = cpuDir + "/cpu0/cache/" + index + "/";
+            CacheLevel cache;
+            cache.level = readInt(dir + "level", 0);
+            readTrimmed(dir + "type", cache.type);
+            cache.sizeKB = readInt(dir + "size", 0);  // "32K"
+            if (procReadFile(dir + "shared_cpu_list", text)) cache.sharedBy = (int)parseCpuList(text).size();
+            if (cache.level > 0) info.caches.push_back(cache);
+        }
+    }
+
+    info.numaNodes = 1;
+    if (procReadFile("/sys/devices/system/node/online", text))
+        info.numaNodes = std::max<int>(1, (int)parseCpuList(text).size());
+
+    if (procReadFile("/proc/meminfo", text)) {
+        size_t pos = text.find("MemTotal:");
+        if (pos != std::string::npos) info.memTotalGB = strtoull(text.c_str() + pos + 9, nullptr, 10) / (1024.0f * 1024.0f);
+    }
+    return info;
+}
+
+// ------------------------------
+// HOTPLUG CHECK
+// ------------------------------
+
+struct Inventory {
+    HostInfo info;
+    uint64_t generation = 0;    // procSourceGeneration() it was built for
+    ProcHandle cpusOnline;
+    ProcHandle nodesOnline;
+    std::string lastCpus;
+    std::string lastNodes;
+};
+
+static Inventory inventory;
+
+const HostInfo& hostInventory() {
+    PROFILE_ZONE("hostInventory");
+    // Handles reopen themselves when the source changes
+    if (inventory.cpusOnline.path.empty()) {
+        procOpenHandle(cpuDir + "/online", inventory.cpusOnline);
+        procOpenHandle("/sys/devices/system/node/online", inventory.nodesOnline);
+    }
+    bool rebuild = inventory.generation != procSourceGeneration();
+
+    // The online lists are a few bytes; anything else only changes with them
+    static std::string cpus, nodes;
+    if (!procReadHandle(inventory.cpusOnline, cpus)) cpus.clear();
+    if (!procReadHandle(inventory.nodesOnline, nodes)) nodes.clear();
+    if (cpus != inventory.lastCpus || nodes != inventory.lastNodes) rebuild = true;
+
+    if (rebuild) {
+        inventory.info = buildInventory();
+        inventory.generation = procSourceGeneration();
+        inventory.lastCpus = cpus;
+        inventory.lastNodes = nodes;
+    }
+    return inventory.info;
+}
+
+// ------------------------------
+// UI RENDERING FUNCTION FOR HARDWARE TAB
+// ------------------------------
+
+void renderInventoryTab() {
+    PROFILE_ZONE("renderInventoryTab");
+    const HostInfo& host = currentSnapshot().host;
+
+    ImGui::Text("CPU: %s", host.cpuModel.c_str());
+    ImGui::Text("Vendor: %s", host.cpuVendor.empty() ? "-" : host.cpuVendor.c_str());
+    ImGui::Text("Topology: %d socket%s, %d cores, %d threads", host.sockets, host.sockets == 1 ? "" : "s",
+                host.cores, host.threads);
+    if (host.cores > 0)
+        ImGui::Text("SMT: %s (%d thread%s per core)", host.threads > host.cores ? "on" : "off",
+                    host.threads / host.cores, host.threads / host.cores == 1 ? "" : "s");
+    ImGui::Text("NUMA nodes: %d", host.numaNodes);
+    ImGui::Text("Memory: %.1f GB", host.memTotalGB);
+    ImGui::Text("Kernel: %s", host.kernel.empty() ? "-" : host.kernel.c_str());
+    ImGui::Text("Hypervisor: %s", host.hypervisor.empty() ? "none (bare metal)" : host.hypervisor.c_str());
+
+    if (!host.caches.empty() && ImGui::BeginTable("Caches", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders)) {
+        ImGui::TableSetupColumn("Cache");
+        ImGui::TableSetupColumn("Type");
+        ImGui::TableSetupColumn("Size");
+        ImGui::TableSetupColumn("Shared by");
+        ImGui::TableHeadersRow();
+        for (const CacheLevel& cache : host.caches) {
+            ImGui::TableNextRow();
+            ImGui::TableSetColumnIndex(0);
+            ImGui::Text("L%d", cache.level);
+            ImGui::TableSetColumnIndex(1);
+            ImGui::TextUnformatted(cache.type.c_str());
+            ImGui::TableSetColumnIndex(2);
+            if (cache.sizeKB >= 1024) ImGui::Text("%.1f MB", cache.sizeKB / 1024.0f);
+            else ImGui::Text("%d KB", cache.sizeKB);
+            ImGui::TableSetColumnIndex(3);
+            ImGui::Text("%d cpu%s", cache.sharedBy, cache.sharedBy == 1 ? "" : "s");
+        }
+        ImGui::EndTable();
+    }
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include "snapshot.h"
+
+// ------------------------------
+// HARDWARE INVENTORY
+// ------------------------------
+//
+// CPU model, topology, caches, NUMA nodes, memory and kernel are read once
+// and shared by every panel. Each call only re-reads the cpu and node
+// `online` lists (two held files). The inventory is rebuilt when one of them
+// changes (hotplug) or when the ProcSource does.
+
+const HostInfo& hostInventory();
+
+// Topology, caches and the rest of the inventory
+void renderInventoryTab();
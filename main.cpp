@@ -1,6 +1,14 @@
 #include "header.h"
 #include <SDL.h>
-#include "fan.h"
+#include "history.h"
+#include "perfcounters.h"
+#include "procfs.h"
+#include "profiler.h"
+#include "psi.h"
+#include "selfstats.h"
+#include "smaps.h"
+#include "snapshot.h"
+#include <cstring>
 
 /*
 NOTE : You are free to change the code as you wish, the main objective is to make the
@@ -42,94 +50,63 @@ using namespace gl;
 #include IMGUI_IMPL_OPENGL_LOADER_CUSTOM
 #endif
 
-// systemWindow, display information for the system monitorization
-void systemWindow(const char *id, ImVec2 size, ImVec2 position)
-{
-    ImGui::Begin(id);
-    ImGui::SetWindowSize(id, size);
-    ImGui::SetWindowPos(id, position);
-
-    // student TODO : add code here for the system window
-    // Show system monitorization info💜
-    ImGui::Text("Operating System: %s", getOsName());
-    ImGui::Text("User logged in: %s", getLoggedInUser().c_str());
-    ImGui::Text("Computer Name: %s", getComputerName().c_str());
-    
-    TaskStats tasks = getTaskStats();
-    ImGui::Text("Total Tasks: %d", tasks.total);
-    ImGui::Text("Running: %d", tasks.running);
-    ImGui::Text("Sleeping: %d", tasks.sleeping);
-    ImGui::Text("Uninterruptible: %d", tasks.uninterruptible);
-    ImGui::Text("Stopped: %d", tasks.stopped);
-    ImGui::Text("Zombie: %d", tasks.zombie);
-
-    ImGui::Text("CPU: %s", CPUinfo().c_str());
-
-
-    if (ImGui::BeginTabBar("SystemMonitorTabs"))
+// Main code
+int main(int argc, char **argv)
 {
-    // CPU Tab
-    if (ImGui::BeginTabItem("CPU"))
+    // Command line: --record file | --replay file, --capture file | --archive file, --root dir, --profile, --perf
+    const char *recordPath = nullptr;
+    const char *replayPath = nullptr;
+    const char *capturePath = nullptr;
+    const char *archivePath = nullptr;
+    for (int i = 1; i < argc; i++)
     {
-    renderCpuTab();
-        ImGui::EndTabItem();
+        if (!strcmp(argv[i], "--record") && i + 1 < argc)
+            recordPath = argv[++i];
+        else if (!strcmp(argv[i], "--replay") && i + 1 < argc)
+            replayPath = argv[++i];
+        else if (!strcmp(argv[i], "--capture") && i + 1 < argc)
+            capturePath = argv[++i];
+        else if (!strcmp(argv[i], "--archive") && i + 1 < argc)
+            archivePath = argv[++i];
+        else if (!strcmp(argv[i], "--root") && i + 1 < argc)
+            setProcRoot(argv[++i]);
+        else if (!strcmp(argv[i], "--profile"))
+        {
+            showProfiler = true;
+            setProfilerEnabled(true);
+        }
+        else if (!strcmp(argv[i], "--perf"))
+            setPerfEnabled(true);
+        else
+        {
+            fprintf(stderr, "usage: %s [--record file | --replay file] [--capture file | --archive file] [--root dir] [--profile] [--perf]\n", argv[0]);
+            return 1;
+        }
     }
-
-    // Fan Tab
-    if (ImGui::BeginTabItem("Fan"))
+    if (archivePath && !openArchive(archivePath))
     {
-    renderFanTab();
-        ImGui::EndTabItem();
+        fprintf(stderr, "Error: could not open capture archive %s\n", archivePath);
+        return 1;
     }
-
-    // Thermal Tab
-    if (ImGui::BeginTabItem("Thermal"))
+    if (capturePath && !archivePath && !startCapture(capturePath))
     {
-        // Your Thermal content goes here
-        renderThermalTab();
-        ImGui::EndTabItem();
+        fprintf(stderr, "Error: could not create capture archive %s\n", capturePath);
+        return 1;
     }
+    if (replayPath && !openReplay(replayPath))
+    {
+        fprintf(stderr, "Error: could not open recording %s\n", replayPath);
+        return 1;
+    }
+    if (recordPath && !replayPath && !startRecording(recordPath))
+    {
+        fprintf(stderr, "Error: could not create recording %s\n", recordPath);
+        return 1;
+    }
+    // PSI triggers need the live host and a kernel with CONFIG_PSI; the panels work without them
+    if (!archivePath && !replayPath)
+        startPsiTriggers();
 
-    ImGui::EndTabBar();
-}
-
-    ImGui::End();
-}
-
-// memoryProcessesWindow, display information for the memory and processes information
-void memoryProcessesWindow(const char *id, ImVec2 size, ImVec2 position)
-{
-    ImGui::Begin(id);
-    ImGui::SetWindowSize(id, size);
-    ImGui::SetWindowPos(id, position);
-
-    // student TODO : add code here for the memory and process information
-    renderRAMWindow(id, size, position);
-    renderSwapWindow(id, size, position);
-    renderDiskWindow(id, size, position);
-
-    renderProcessesWindow(id, size, position);  // NEW LINE
-
-    ImGui::End();
-}
-
-// network, display information network information
-void networkWindow(const char *id, ImVec2 size, ImVec2 position)
-{
-    ImGui::Begin(id);
-    ImGui::SetWindowSize(id, size);
-    ImGui::SetWindowPos(id, position);
-
-    // student TODO : add code here for the network information
-    rendernetworkWindow(id, ImVec2(400, 300), ImVec2(50, 400));
-    RenderExtraNetworkWindow(id, ImVec2(400, 300), ImVec2(50, 400));
-
-    ImGui::End();
-}
-
-// Main code
-int main(int, char **)
-{
     // Setup SDL
     // (Some versions of SDL before <2.0.10 appears to have performance/stalling issues on a minority of Windows systems,
     // depending on whether SDL_INIT_GAMECONTROLLER is enabled or disabled.. updating to latest version of SDL is recommended!)
@@ -197,10 +174,16 @@ int main(int, char **)
     // note : you are free to change the style of the application
     ImVec4 clear_color = ImVec4(0.0f, 0.0f, 0.0f, 0.0f);
 
+    // On-disk history; the monitor still works if it can't be opened
+    if (!historyOpen())
+        fprintf(stderr, "Warning: history disabled, could not open the history directory\n");
+
     // Main loop
     bool done = false;
     while (!done)
     {
+        PROFILE_ZONE("frame");
+
         // Poll and handle events (inputs, window resize, etc.)
         // You can read the io.WantCaptureMouse, io.WantCaptureKeyboard flags to tell if dear imgui wants to use your inputs.
         // - When io.WantCaptureMouse is true, do not dispatch mouse input data to your main application.
@@ -221,6 +204,10 @@ int main(int, char **)
         ImGui_ImplSDL2_NewFrame(window);
         ImGui::NewFrame();
 
+        // Collect a live snapshot when due (also feeds history and recording), or advance the replay
+        updateSnapshot();
+        updateSelfStats();
+
         {
             ImVec2 mainDisplay = io.DisplaySize;
             memoryProcessesWindow("== Memory and Processes ==",
@@ -234,10 +221,27 @@ int main(int, char **)
             networkWindow("== Network ==",
                           ImVec2(mainDisplay.x - 20, (mainDisplay.y / 2) - 60),
                           ImVec2(10, (mainDisplay.y / 2) + 50));
+            // --------------------------------------
+            renderHistoryWindow("== History ==",
+                                ImVec2(mainDisplay.x / 2, mainDisplay.y / 3),
+                                ImVec2(mainDisplay.x / 4, mainDisplay.y / 3));
+            // --------------------------------------
+            renderReplayWindow("== Record / Replay ==",
+                               ImVec2(mainDisplay.x / 3, 130),
+                               ImVec2(mainDisplay.x / 3, 20));
+            // --------------------------------------
+            if (showProfiler)
+                renderProfilerWindow("== Profiler ==",
+                                     ImVec2(560, 360),
+                                     ImVec2(mainDisplay.x - 580, 20));
         }
 
         // Rendering
-        ImGui::Render();
+        {
+            PROFILE_ZONE("ImGui::Render");
+            ImGui::Render();
+        }
+        PROFILE_ZONE("GL draw + swap");
         glViewport(0, 0, (int)io.DisplaySize.x, (int)io.DisplaySize.y);
         glClearColor(clear_color.x, clear_color.y, clear_color.z, clear_color.w);
         glClear(GL_COLOR_BUFFER_BIT);
@@ -246,6 +250,12 @@ int main(int, char **)
     }
 
     // Cleanup
+    stopRecording();
+    stopCapture();
+    stopPsiTriggers();
+    setPerfEnabled(false);
+    stopSmapsReader();
+    historyClose();
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplSDL2_Shutdown();
     ImGui::DestroyContext();
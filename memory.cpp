@@ -1,10 +1,12 @@
 #include "header.h"
+#include "snapshot.h"
+#include "procfs.h"
+#include "profiler.h"
 #include <imgui.h>
 #include <utility>
 #include <string>
 
 #if defined(__linux__)
-    #include <fstream>
     #include <sstream>
     #include <unordered_map>
 #elif defined(_WIN32)
@@ -17,8 +19,11 @@
 
 // Cross-platform memory usage
 std::pair<float, float> getMemoryUsageMB() {
+    PROFILE_ZONE("getMemoryUsageMB");
 #if defined(__linux__)
-    std::ifstream meminfo("/proc/meminfo");
+    std::string contents;
+    procReadFile("/proc/meminfo", contents);
+    std::istringstream meminfo(contents);
     std::string line;
     std::unordered_map<std::string, long> memValues;
 
@@ -78,6 +83,7 @@ std::pair<float, float> getMemoryUsageMB() {
 
 void renderRAMWindow(const char *id, ImVec2 size, ImVec2 position)
 {
+    PROFILE_ZONE("renderRAMWindow");
     ImGui::SetNextWindowSize(size, ImGuiCond_FirstUseEver);
     ImGui::SetNextWindowPos(position, ImGuiCond_FirstUseEver);
 
@@ -86,8 +92,8 @@ void renderRAMWindow(const char *id, ImVec2 size, ImVec2 position)
         return;
     }
 
-    float usedMB, totalMB;
-    std::tie(usedMB, totalMB) = getMemoryUsageMB();
+    float usedMB = currentSnapshot().memUsedMB;
+    float totalMB = currentSnapshot().memTotalMB;
 
     if (usedMB < 0.0f || totalMB <= 0.0f) {
         ImGui::Text("This OS is not currently supported for RAM monitoring.");
@@ -100,6 +106,7 @@ void renderRAMWindow(const char *id, ImVec2 size, ImVec2 position)
     ImGui::Text("Physical Memory (RAM) Usage:");
     ImGui::ProgressBar(ramPercent, ImVec2(-1.0f, 20.0f));
     ImGui::Text("Used: %.1f MB / Total: %.1f MB (%.1f%%)", usedMB, totalMB, ramPercent * 100.0f);
+    renderPsiPanel(PsiMemory);
 
     ImGui::End();
 }
@@ -1,19 +1,19 @@
 #include "header.h"
+#include "snapshot.h"
+#include "procfs.h"
+#include "profiler.h"
 #include <imgui.h>
-#include <fstream>
 #include <sstream>
 #include <string>
 #include <map>
 #include <algorithm> // For std::min
 
-struct NetStats {
-    uint64_t rx_bytes = 0, rx_packets = 0, rx_errs = 0, rx_drop = 0, rx_fifo = 0, rx_frame = 0, rx_compressed = 0, rx_multicast = 0;
-    uint64_t tx_bytes = 0, tx_packets = 0, tx_errs = 0, tx_drop = 0, tx_fifo = 0, tx_colls = 0, tx_carrier = 0, tx_compressed = 0;
-};
-
 std::map<std::string, NetStats> readNetworkStats() {
+    PROFILE_ZONE("readNetworkStats");
     std::map<std::string, NetStats> stats;
-    std::ifstream file("/proc/net/dev");
+    std::string contents;
+    procReadFile("/proc/net/dev", contents);
+    std::istringstream file(contents);
     std::string line;
 
     // Skip headers
@@ -59,12 +59,13 @@ std::string formatBytes(uint64_t bytes) {
 
 void RenderExtraNetworkWindow(const char *id, ImVec2 size, ImVec2 position)
 {
+    PROFILE_ZONE("RenderExtraNetworkWindow");
     ImGui::SetNextWindowSize(size, ImGuiCond_FirstUseEver);
     ImGui::SetNextWindowPos(position, ImGuiCond_FirstUseEver);
 
     if (!ImGui::Begin(id)) { ImGui::End(); return; }
 
-    auto stats = readNetworkStats();
+    const auto& stats = currentSnapshot().net;
 
     // --- RX and TX tables ---
     if (ImGui::BeginTabBar("NetTab")) {
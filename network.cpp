@@ -1,4 +1,6 @@
 #include "header.h"
+#include "snapshot.h"
+#include "profiler.h"
 #include <imgui.h>
 #include <string>
 #include <vector>
@@ -9,12 +11,8 @@
 #include <sys/socket.h>
 #include <net/if.h>
 
-struct NetInterface {
-    std::string name;
-    std::string ipv4;
-};
-
 std::vector<NetInterface> getNetworkInterfaces() {
+    PROFILE_ZONE("getNetworkInterfaces");
     std::vector<NetInterface> interfaces;
 
     struct ifaddrs *ifaddr, *ifa;
@@ -37,6 +35,7 @@ std::vector<NetInterface> getNetworkInterfaces() {
 
 void rendernetworkWindow(const char *id, ImVec2 size, ImVec2 position)
 {
+    PROFILE_ZONE("rendernetworkWindow");
     ImGui::SetNextWindowSize(size, ImGuiCond_FirstUseEver);
     ImGui::SetNextWindowPos(position, ImGuiCond_FirstUseEver);
 
@@ -47,7 +46,7 @@ void rendernetworkWindow(const char *id, ImVec2 size, ImVec2 position)
 
 #if defined(__linux__)
 
-    auto interfaces = getNetworkInterfaces();
+    const auto& interfaces = currentSnapshot().interfaces;
 
     if (ImGui::BeginTable("NetTable", 2, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
         ImGui::TableSetupColumn("Interface");
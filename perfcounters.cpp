@@ -0,0 +1,325 @@
+#include "perfcounters.h"
+#include "plot.h"
+#include "procfs.h"
+#include "profiler.h"
+#include "snapshot.h"
+#include <imgui.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+static const char* const counterNames[PerfCounters] = {
+    "cycles", "instructions", "cache-misses", "branch-misses", "context-switches", "page-faults", "cpu-migrations"};
+
+const char* perfCounterName(PerfCounter counter) {
+    return counter < PerfCounters ? counterNames[counter] : "?";
+}
+
+// ------------------------------
+// COUNTER GROUPS
+// ------------------------------
+
+struct PerfGroup {
+    std::vector<int> fds;                // leader first
+    std::vector<PerfCounter> counters;   // counter of each fd, in read order
+    std::vector<uint64_t> last;          // raw values at the previous read
+    uint64_t lastEnabled = 0;
+    uint64_t lastRunning = 0;
+    bool primed = false;
+};
+
+struct PerfCpu {
+    int cpu;
+    PerfGroup groups[2];                 // hardware, software
+};
+
+struct PerfState {
+    bool enabled = false;
+    bool open = false;
+    std::vector<PerfCpu> cpus;
+    uint8_t available = 0;
+    std::string status = "off";
+    int64_t lastTimeMs = 0;
+    std::vector<uint64_t> readBuffer;
+};
+
+static PerfState perf;
+
+#ifdef __linux__
+// perf_event_attr type and config of each counter
+static const struct { uint32_t type; uint64_t config; } counterEvents[PerfCounters] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS},
+};
+
+static int openCounter(PerfCounter counter, int cpu, int groupFd) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = counterEvents[counter].type;
+    attr.config = counterEvents[counter].config;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // The leader starts disabled so every member starts counting together
+    attr.disabled = groupFd == -1;
+    return (int)syscall(__NR_perf_event_open, &attr, -1, cpu, groupFd, PERF_FLAG_FD_CLOEXEC);
+}
+
+// Opens the counters [first, last] that exist as one group; false if the leader can't be opened
+static bool openGroup(PerfGroup& group, int cpu, PerfCounter first, PerfCounter last, int& error) {
+    for (int c = first; c <= last; c++) {
+        int fd = openCounter((PerfCounter)c, cpu, group.fds.empty() ? -1 : group.fds[0]);
+        if (fd < 0) {
+            error = errno;
+            if (group.fds.empty() && c == first) return false;
+            continue;  // a member this PMU doesn't have
+        }
+        group.fds.push_back(fd);
+        group.counters.push_back((PerfCounter)c);
+    }
+    group.last.assign(group.fds.size(), 0);
+    ioctl(group.fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return true;
+}
+
+#endif
+
+static void closeCounters() {
+    for (PerfCpu& cpu : perf.cpus)
+        for (PerfGroup& group : cpu.groups)
+            for (int fd : group.fds) close(fd);
+    perf.cpus.clear();
+    perf.available = 0;
+    perf.open = false;
+}
+
+static void openCounters() {
+    perf.open = true;
+    perf.lastTimeMs = 0;
+    if (isArchiveOpen() || !procRoot().empty()) {
+        perf.status = "counters are only read on the live host";
+        return;
+    }
+#ifndef __linux__
+    perf.status = "perf_event_open is Linux only";
+#else
+    raiseFdLimit();
+
+    int hwError = 0, swError = 0;
+    long cpus = sysconf(_SC_NPROCESSORS_CONF);
+    for (int cpu = 0; cpu < cpus; cpu++) {
+        PerfCpu entry{cpu, {}};
+        openGroup(entry.groups[0], cpu, PerfCycles, PerfBranchMisses, hwError);
+        // Offline cpus fail with ENODEV and are left out
+        if (!openGroup(entry.groups[1], cpu, PerfContextSwitches, PerfMigrations, swError) &&
+            entry.groups[0].fds.empty())
+            continue;
+        for (const PerfGroup& group : entry.groups)
+            for (PerfCounter c : group.counters) perf.available |= 1 << c;
+        perf.cpus.push_back(std::move(entry));
+    }
+
+    int paranoid = -1;
+    std::string text;
+    if (procReadFile("/proc/sys/kernel/perf_event_paranoid", text)) paranoid = atoi(text.c_str());
+    bool hardware = perf.available & (1 << PerfCycles);
+    char status[256];
+    if (perf.cpus.empty() && (swError == EACCES || swError == EPERM))
+        snprintf(status, sizeof(status),
+                 "no permission: cpu-wide counters need root, CAP_PERFMON or kernel.perf_event_paranoid <= 0 (it is %d)",
+                 paranoid);
+    else if (perf.cpus.empty())
+        snprintf(status, sizeof(status), "perf_event_open failed: %s", strerror(swError));
+    else if (!hardware)
+        snprintf(status, sizeof(status), "software events only: no hardware PMU (%s; usual in VMs)", strerror(hwError));
+    else
+        snprintf(status, sizeof(status), "hardware and software counters on %zu cpus", perf.cpus.size());
+    perf.status = status;
+#endif
+}
+
+void setPerfEnabled(bool enabled) {
+    if (perf.enabled == enabled) return;
+    perf.enabled = enabled;
+    if (!enabled) {
+        closeCounters();
+        perf.status = "off";
+    }
+}
+
+bool perfEnabled() {
+    return perf.enabled;
+}
+
+// ------------------------------
+// READING
+// ------------------------------
+
+// One read() of the whole group: nr, time_enabled, time_running, then one value per member
+static void readGroup(PerfGroup& group, CorePerf& core) {
+    if (group.fds.empty()) return;
+    std::vector<uint64_t>& buf = perf.readBuffer;
+    buf.resize(3 + group.fds.size());
+    ssize_t n = read(group.fds[0], buf.data(), buf.size() * sizeof(uint64_t));
+    if (n < (ssize_t)(3 * sizeof(uint64_t)) || buf[0] != group.fds.size()) return;
+
+    uint64_t enabled = buf[1] - group.lastEnabled;
+    uint64_t running = buf[2] - group.lastRunning;
+    // Multiplexed groups only counted for part of the interval; scale up to all of it
+    double scale = running > 0 ? (double)enabled / running : 0.0;
+    for (size_t i = 0; i < group.fds.size(); i++) {
+        uint64_t value = buf[3 + i];
+        if (group.primed && value >= group.last[i])
+            core.counts[group.counters[i]] = (uint64_t)((value - group.last[i]) * scale);
+        group.last[i] = value;
+    }
+    group.lastEnabled = buf[1];
+    group.lastRunning = buf[2];
+    group.primed = true;
+}
+
+PerfInfo readPerf(int64_t timeMs) {
+    PROFILE_ZONE("readPerf");
+    PerfInfo info;
+    if (perf.enabled && !perf.open) openCounters();
+    info.status = perf.status;
+    if (perf.cpus.empty()) return info;
+
+    info.found = true;
+    info.available = perf.available;
+    info.intervalMs = perf.lastTimeMs > 0 ? (float)(timeMs - perf.lastTimeMs) : 0.0f;
+    perf.lastTimeMs = timeMs;
+
+    info.cores.resize(perf.cpus.size());
+    for (size_t i = 0; i < perf.cpus.size(); i++) {
+        info.cores[i].cpu = perf.cpus[i].cpu;
+        for (PerfGroup& group : perf.cpus[i].groups) readGroup(group, info.cores[i]);
+    }
+    return info;
+}
+
+// ------------------------------
+// UI RENDERING FUNCTION FOR PERF TAB
+// ------------------------------
+
+static const int maxPerfSamples = 1200;
+
+static PlotHistory ipcHistory(maxPerfSamples);
+static PlotHistory switchHistory(maxPerfSamples);
+static float switchScale = 1000.0f;
+static uint64_t lastPerfSequence = 0;
+static uint64_t lastPerfEpoch = 0;
+
+static float ratio(uint64_t a, uint64_t b) {
+    return b > 0 ? (float)a / b : 0.0f;
+}
+
+static float perSecond(const PerfInfo& info, uint64_t count) {
+    return info.intervalMs > 0.0f ? count * 1000.0f / info.intervalMs : 0.0f;
+}
+
+void renderPerfTab() {
+    PROFILE_ZONE("renderPerfTab");
+    const PerfInfo& info = currentSnapshot().perf;
+
+    if (!isReplaying()) {
+        bool enabled = perfEnabled();
+        if (ImGui::Checkbox("Count with perf_event_open", &enabled)) setPerfEnabled(enabled);
+    }
+    ImGui::TextDisabled("%s", info.status.c_str());
+    if (!info.found) return;
+
+    CorePerf total;
+    for (const CorePerf& core : info.cores)
+        for (int c = 0; c < PerfCounters; c++) total.counts[c] += core.counts[c];
+    bool hardware = info.available & (1 << PerfCycles);
+
+    if (snapshotEpoch() != lastPerfEpoch) {
+        lastPerfEpoch = snapshotEpoch();
+        ipcHistory.clear();
+        switchHistory.clear();
+    }
+    if (snapshotSequence() != lastPerfSequence) {
+        lastPerfSequence = snapshotSequence();
+        ipcHistory.push(ratio(total.counts[PerfInstructions], total.counts[PerfCycles]));
+        switchHistory.push(perSecond(info, total.counts[PerfContextSwitches]));
+    }
+
+    char overlay[64];
+    if (hardware) {
+        float ipc = ratio(total.counts[PerfInstructions], total.counts[PerfCycles]);
+        ImGui::Text("IPC %.2f   cache misses %.2f per 1k instructions   branch misses %.2f per 1k instructions", ipc,
+                    1000.0f * ratio(total.counts[PerfCacheMisses], total.counts[PerfInstructions]),
+                    1000.0f * ratio(total.counts[PerfBranchMisses], total.counts[PerfInstructions]));
+        snprintf(overlay, sizeof(overlay), "IPC %.2f", ipc);
+        ipcHistory.plot("IPC", 0.0f, 4.0f, ImVec2(0, 60), overlay);
+    }
+    float switches = perSecond(info, total.counts[PerfContextSwitches]);
+    ImGui::Text("Context switches %.0f/s   page faults %.0f/s   migrations %.0f/s", switches,
+                perSecond(info, total.counts[PerfPageFaults]), perSecond(info, total.counts[PerfMigrations]));
+    switchScale = std::max(switchScale, switches * 1.2f);
+    snprintf(overlay, sizeof(overlay), "%.0f/s", switches);
+    switchHistory.plot("Switches/s", 0.0f, switchScale, ImVec2(0, 60), overlay);
+
+    // ------------------
+    // PER-CORE TABLE
+    // ------------------
+
+    int columns = hardware ? 8 : 4;
+    if (!ImGui::BeginTable("PerfCores", columns, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_ScrollY,
+                           ImVec2(0, 300)))
+        return;
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableSetupColumn("CPU");
+    if (hardware) {
+        ImGui::TableSetupColumn("IPC");
+        ImGui::TableSetupColumn("GHz");
+        ImGui::TableSetupColumn("Cache MPKI");
+        ImGui::TableSetupColumn("Branch miss/1k");
+    }
+    ImGui::TableSetupColumn("Switches/s");
+    ImGui::TableSetupColumn("Faults/s");
+    ImGui::TableSetupColumn("Migrations/s");
+    ImGui::TableHeadersRow();
+
+    ImGuiListClipper clipper;
+    clipper.Begin((int)info.cores.size());
+    while (clipper.Step()) {
+        for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+            const CorePerf& core = info.cores[row];
+            const uint64_t* c = core.counts;
+            int col = 0;
+            ImGui::TableNextRow();
+            ImGui::TableSetColumnIndex(col++);
+            ImGui::Text("cpu%d", core.cpu);
+            if (hardware) {
+                ImGui::TableSetColumnIndex(col++);
+                ImGui::Text("%.2f", ratio(c[PerfInstructions], c[PerfCycles]));
+                ImGui::TableSetColumnIndex(col++);
+                ImGui::Text("%.2f", perSecond(info, c[PerfCycles]) / 1e9f);
+                ImGui::TableSetColumnIndex(col++);
+                ImGui::Text("%.2f", 1000.0f * ratio(c[PerfCacheMisses], c[PerfInstructions]));
+                ImGui::TableSetColumnIndex(col++);
+                ImGui::Text("%.2f", 1000.0f * ratio(c[PerfBranchMisses], c[PerfInstructions]));
+            }
+            ImGui::TableSetColumnIndex(col++);
+            ImGui::Text("%.0f", perSecond(info, c[PerfContextSwitches]));
+            ImGui::TableSetColumnIndex(col++);
+            ImGui::Text("%.0f", perSecond(info, c[PerfPageFaults]));
+            ImGui::TableSetColumnIndex(col++);
+            ImGui::Text("%.0f", perSecond(info, c[PerfMigrations]));
+        }
+    }
+    ImGui::EndTable();
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ------------------------------
+// PERFORMANCE COUNTERS
+// ------------------------------
+//
+// Optional, live host only: perf_event_open counter groups on every cpu.
+// The hardware group (cycles, instructions, cache and branch misses) is
+// opened where the PMU allows it; the software group (context switches,
+// page faults, migrations) always is. Each group is read with a single
+// read() per round, and counts are scaled when the kernel multiplexes the
+// PMU between groups.
+
+enum PerfCounter : uint8_t {
+    PerfCycles, PerfInstructions, PerfCacheMisses, PerfBranchMisses,
+    PerfContextSwitches, PerfPageFaults, PerfMigrations,
+    PerfCounters
+};
+
+struct CorePerf {
+    int cpu = 0;
+    uint64_t counts[PerfCounters] = {};  // increments over the interval
+};
+
+struct PerfInfo {
+    bool found = false;
+    uint8_t available = 0;               // bit per PerfCounter that has a counter open
+    float intervalMs = 0.0f;
+    std::vector<CorePerf> cores;
+    std::string status;                  // why counters are missing, or what is counted
+};
+
+const char* perfCounterName(PerfCounter counter);
+
+// Counters are opened on the first read after enabling and closed when disabled
+void setPerfEnabled(bool enabled);
+bool perfEnabled();
+
+// Increments are relative to the previous call's timeMs
+PerfInfo readPerf(int64_t timeMs);
+
+// IPC, miss rates and software event rates per core
+void renderPerfTab();
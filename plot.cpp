@@ -0,0 +1,120 @@
+#include "plot.h"
+#include <algorithm>
+
+void PlotHistory::push(float value) {
+    uint64_t index = firstIndex + values.size();
+    values.push_back(value);
+    if (bucketSize > 0) addToBuckets(index, value);
+
+    // Drop the oldest sample, and its bucket once it's fully out of range
+    if (values.size() > capacity) {
+        values.pop_front();
+        firstIndex++;
+        if (bucketSize > 0 && !buckets.empty() && firstIndex / bucketSize > firstBucket) {
+            buckets.pop_front();
+            firstBucket++;
+        }
+    }
+}
+
+void PlotHistory::clear() {
+    firstIndex += values.size();
+    values.clear();
+    buckets.clear();
+    bucketSize = 0;
+}
+
+void PlotHistory::addToBuckets(uint64_t index, float value) {
+    uint64_t bucket = index / bucketSize;
+    if (buckets.empty() || bucket > firstBucket + buckets.size() - 1) {
+        if (buckets.empty()) firstBucket = bucket;
+        buckets.push_back({value, value, index, index});
+        return;
+    }
+
+    Bucket& b = buckets.back();
+    if (value < b.min) { b.min = value; b.minAt = index; }
+    if (value > b.max) { b.max = value; b.maxAt = index; }
+}
+
+// Min/max over absolute sample indices [from, to)
+PlotHistory::Bucket PlotHistory::scanBucket(uint64_t from, uint64_t to) const {
+    Bucket b = {values[from - firstIndex], values[from - firstIndex], from, from};
+    for (uint64_t i = from + 1; i < to; ++i) {
+        float v = values[i - firstIndex];
+        if (v < b.min) { b.min = v; b.minAt = i; }
+        if (v > b.max) { b.max = v; b.maxAt = i; }
+    }
+    return b;
+}
+
+void PlotHistory::rebuildBuckets(uint64_t size) {
+    // Growing by powers of two: merge neighbouring buckets instead of rescanning
+    if (bucketSize > 0 && size > bucketSize && !buckets.empty()) {
+        while (bucketSize < size) {
+            std::deque<Bucket> merged;
+            for (size_t i = 0; i < buckets.size(); ++i) {
+                // Buckets 2k and 2k+1 become bucket k of the doubled size
+                const Bucket& b = buckets[i];
+                if (!merged.empty() && (firstBucket + i) % 2 == 1) {
+                    Bucket& m = merged.back();
+                    if (b.min < m.min) { m.min = b.min; m.minAt = b.minAt; }
+                    if (b.max > m.max) { m.max = b.max; m.maxAt = b.maxAt; }
+                } else {
+                    merged.push_back(b);
+                }
+            }
+            firstBucket /= 2;
+            buckets.swap(merged);
+            bucketSize *= 2;
+        }
+        return;
+    }
+
+    // Shrinking (the plot got wider): rescan everything
+    bucketSize = size;
+    buckets.clear();
+    uint64_t end = firstIndex + values.size();
+    for (uint64_t start = firstIndex; start < end;) {
+        uint64_t stop = std::min(end, (start / size + 1) * size);
+        if (buckets.empty()) firstBucket = start / size;
+        buckets.push_back(scanBucket(start, stop));
+        start = stop;
+    }
+}
+
+void PlotHistory::plot(const char* label, float scaleMin, float scaleMax, ImVec2 size, const char* overlay) {
+    float width = size.x > 0.0f ? size.x : ImGui::CalcItemWidth();
+    size_t pixels = (size_t)std::max(1.0f, width);
+
+    // Short histories are drawn as they are
+    if (values.size() <= pixels * 2) {
+        bucketSize = 0;
+        buckets.clear();
+        plotBuffer.assign(values.begin(), values.end());
+        ImGui::PlotLines(label, plotBuffer.data(), (int)plotBuffer.size(), 0, overlay, scaleMin, scaleMax, size);
+        return;
+    }
+
+    // Smallest power-of-two bucket that gives at most one bucket per pixel
+    uint64_t wanted = 1;
+    while (values.size() / wanted > pixels) wanted *= 2;
+    if (wanted != bucketSize) rebuildBuckets(wanted);
+
+    // The front bucket may still include samples that were dropped
+    uint64_t frontEnd = std::min<uint64_t>((firstBucket + 1) * bucketSize, firstIndex + values.size());
+    buckets.front() = scanBucket(firstIndex, frontEnd);
+
+    // Two points per bucket, min and max in the order they happened
+    plotBuffer.clear();
+    for (const Bucket& b : buckets) {
+        if (b.minAt <= b.maxAt) {
+            plotBuffer.push_back(b.min);
+            plotBuffer.push_back(b.max);
+        } else {
+            plotBuffer.push_back(b.max);
+            plotBuffer.push_back(b.min);
+        }
+    }
+    ImGui::PlotLines(label, plotBuffer.data(), (int)plotBuffer.size(), 0, overlay, scaleMin, scaleMax, size);
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <imgui.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+// Rolling sample history that is drawn with about two points per pixel.
+//
+// Samples are grouped into power-of-two sized buckets aligned to their
+// absolute sample index; each bucket keeps its min and max (in the order they
+// happened) so short spikes stay visible. Buckets are updated as samples are
+// pushed and merged pairwise when the history outgrows the plot, so drawing
+// costs O(plot width) no matter how long the history is.
+class PlotHistory {
+public:
+    explicit PlotHistory(size_t capacity = 100) : capacity(capacity) {}
+
+    void push(float value);
+    void clear();
+
+    bool empty() const { return values.empty(); }
+    size_t size() const { return values.size(); }
+    float back() const { return values.back(); }
+    const std::deque<float>& samples() const { return values; }
+
+    // Same arguments as ImGui::PlotLines; size.x == 0 uses the item width
+    void plot(const char* label, float scaleMin, float scaleMax, ImVec2 size, const char* overlay = nullptr);
+
+private:
+    struct Bucket {
+        float min, max;
+        uint64_t minAt, maxAt; // absolute sample index of min and max
+    };
+
+    void addToBuckets(uint64_t index, float value);
+    void rebuildBuckets(uint64_t bucketSize);
+    Bucket scanBucket(uint64_t from, uint64_t to) const;
+
+    std::deque<float> values;
+    size_t capacity;
+    uint64_t firstIndex = 0;   // absolute index of values.front()
+
+    uint64_t bucketSize = 0;   // 0 = no envelope cached
+    uint64_t firstBucket = 0;  // absolute bucket number of buckets.front()
+    std::deque<Bucket> buckets;
+    std::vector<float> plotBuffer;
+};
@@ -1,6 +1,9 @@
 #include "header.h"
+#include "snapshot.h"
+#include "clock.h"
+#include "procfs.h"
+#include "profiler.h"
 #include <imgui.h>
-#include <dirent.h>
 #include <cstring>
 #include <cctype>
 #include <vector>
@@ -10,6 +13,7 @@
 #include <algorithm>
 #include <cstdio>
 #include <cstdlib>
+#include <cmath>
 #include <ctime>
 #include <unistd.h>
 
@@ -17,238 +21,618 @@
 // Structs & Globals
 // -----------------------------
 
-// Holds individual process information
-struct ProcInfo {
-    std::string name;
-    char state = '?';
-    unsigned long long lastCpuTime = 0;
-    float cpuPercent = 0.0f;
-    float memPercent = 0.0f;
+// Counters of /proc/[pid]/io, in ProcessIo order
+static const int ioCounterCount = 6;
+static const char* const ioCounterKeys[ioCounterCount] = {"read_bytes:", "write_bytes:", "rchar:", "wchar:",
+                                                          "syscr:", "syscw:"};
+static float ProcessIo::* const ioRateFields[ioCounterCount] = {
+    &ProcessIo::readBytes, &ProcessIo::writeBytes, &ProcessIo::rchar,
+    &ProcessIo::wchar, &ProcessIo::syscr, &ProcessIo::syscw};
+
+// Membership rarely changes, so each pid's cgroup is re-read only every this many rounds
+static const int cgroupRefreshRounds = 16;
+
+// CPU time, smoothed usage, fault, switch and I/O counters and the cgroup of each pid in the previous collection round
+struct ProcCpu {
+    unsigned long long utime;
+    unsigned long long stime;
+    unsigned long long startTime;         // ticks after boot; another one under the same pid is a new process
+    float userPercent;
+    float systemPercent;
+    unsigned long long minorFaults;
+    unsigned long long majorFaults;
+    unsigned long long voluntarySwitches;
+    unsigned long long involuntarySwitches;
+    bool ioRead;                          // io was read that round
+    unsigned long long io[ioCounterCount];
+    std::string cgroup;
 };
 
-// Global state
-static std::unordered_map<int, ProcInfo> processesCpuData;
+// The fields of /proc/[pid]/stat the table uses
+struct ProcStat {
+    char state;
+    unsigned long long minflt;
+    unsigned long long majflt;
+    unsigned long long utime;
+    unsigned long long stime;
+    int priority;
+    int nice;
+    int threads;
+    int processor;
+    int policy;
+    unsigned long long startTime;
+};
+
+static std::unordered_map<int, ProcCpu> lastProcCpu;
+static std::unordered_map<int, ProcCpu> lastThreadCpu;  // by tid, for the expanded processes only
+static double lastProcCpuSeconds = 0.0;
+static bool havePrevious = false;  // lastProcCpu holds a round to compute rates against
+static unsigned collectRound = 0;
 static std::unordered_set<int> selectedPids;
-static unsigned long long lastTotalCpu = 0;
-static double lastSampleTime = 0.0;
 static const int clockTicksPerSecond = sysconf(_SC_CLK_TCK);
-static const int cpuCount = sysconf(_SC_NPROCESSORS_ONLN); // ✅ Add this
+
+float processCpuSmoothingSeconds = 0.0f;
+bool processIoEnabled = false;
+std::unordered_set<int> expandedProcesses;
 
 
 // -----------------------------
 // Utilities
 // -----------------------------
 
-// Return current monotonic time in seconds
-double getTimeSeconds() {
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    return ts.tv_sec + ts.tv_nsec / 1e9;
-}
-
-// Parse /proc/stat and return the sum of all CPU time fields
-unsigned long long readTotalCpuTime() {
-    FILE* file = fopen("/proc/stat", "r");
-    if (!file) return 0;
-
-    char line[512];
-    if (!fgets(line, sizeof(line), file)) {
-        fclose(file);
-        return 0;
+// Fields of a /proc/[pid]/stat line (numbered as in proc(5)). The name in
+// field 2 may hold spaces and parentheses, so fields count from the last ')';
+// false if the line ends before stime
+static bool parseProcStat(const char* text, ProcStat& stat) {
+    stat = {'?', 0, 0, 0, 0, 0, 0, 0, -1, 0, 0};
+    const char* p = strrchr(text, ')');
+    if (!p || p[1] != ' ') return false;
+    p += 2;
+    stat.state = *p++;
+    int field = 4;
+    for (; field <= 41; field++) {
+        char* end;
+        long long value = strtoll(p, &end, 10);
+        if (end == p) break;
+        p = end;
+        switch (field) {
+        case 10: stat.minflt = value; break;
+        case 12: stat.majflt = value; break;
+        case 14: stat.utime = value; break;
+        case 15: stat.stime = value; break;
+        case 18: stat.priority = (int)value; break;
+        case 19: stat.nice = (int)value; break;
+        case 20: stat.threads = (int)value; break;
+        case 22: stat.startTime = value; break;
+        case 39: stat.processor = (int)value; break;
+        case 41: stat.policy = (int)value; break;
+        }
     }
-    fclose(file);
-
-    unsigned long long user, nice, system, idle, iowait, irq, softirq, steal;
-    int scanned = sscanf(line, "cpu  %llu %llu %llu %llu %llu %llu %llu %llu",
-                         &user, &nice, &system, &idle, &iowait, &irq, &softirq, &steal);
-    return (scanned >= 8) ? user + nice + system + idle + iowait + irq + softirq + steal : 0;
+    return field > 15;
 }
 
-// Parse /proc/[pid]/stat to extract total CPU time used by a process
+// Parse /proc/[pid]/stat to extract total CPU time used by a process, in clock ticks
 unsigned long long readProcessCpuTime(int pid) {
     char path[64];
     snprintf(path, sizeof(path), "/proc/%d/stat", pid);
-    FILE* file = fopen(path, "r");
-    if (!file) return 0;
+    std::string contents;
+    if (!procReadFile(path, contents)) return 0;
 
-    char buffer[1024];
-    if (!fgets(buffer, sizeof(buffer), file)) {
-        fclose(file);
-        return 0;
-    }
-    fclose(file);
-
-    char* openParen = strchr(buffer, '(');
-    char* closeParen = strrchr(buffer, ')');
-    if (!openParen || !closeParen || closeParen <= openParen) return 0;
-
-    char* afterName = closeParen + 2;
-    const int utimeIndex = 13, stimeIndex = 14;
-    unsigned long long utime = 0, stime = 0;
-    int index = 0;
-
-    char* saveptr = nullptr;
-    char* token = strtok_r(afterName, " ", &saveptr);
-    while (token) {
-        if (index == utimeIndex) utime = strtoull(token, nullptr, 10);
-        if (index == stimeIndex) {
-            stime = strtoull(token, nullptr, 10);
-            break;
-        }
-        token = strtok_r(nullptr, " ", &saveptr);
-        index++;
+    ProcStat stat;
+    if (!parseProcStat(contents.c_str(), stat)) return 0;
+    return stat.utime + stat.stime;
+}
+
+// The counters of /proc/[pid]/io; false when it can't be read (other users'
+// processes need ptrace access)
+static bool readProcessIo(int pid, std::string& contents, unsigned long long (&io)[ioCounterCount]) {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/io", pid);
+    if (!procReadFile(path, contents)) return false;
+    for (int i = 0; i < ioCounterCount; i++) {
+        const char* p = strstr(contents.c_str(), ioCounterKeys[i]);
+        // "write_bytes:" also ends "cancelled_write_bytes:", which comes after it
+        io[i] = p ? strtoull(p + strlen(ioCounterKeys[i]), nullptr, 10) : 0;
     }
+    return true;
+}
 
-    return utime + stime;
+// The unified hierarchy's line of /proc/[pid]/cgroup ("0::/system.slice/sshd.service");
+// empty on a v1-only host
+static void readProcessCgroup(int pid, std::string& contents, std::string& cgroup) {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/cgroup", pid);
+    cgroup.clear();
+    if (!procReadFile(path, contents)) return;
+    size_t line = contents.compare(0, 3, "0::") == 0 ? 0 : contents.find("\n0::");
+    if (line == std::string::npos) return;
+    if (line > 0) line++;
+    size_t end = contents.find('\n', line);
+    cgroup.assign(contents, line + 3, end == std::string::npos ? std::string::npos : end - line - 3);
+}
+
+// VmRSS as a percent of total system memory
+static float memoryPercent(const std::string& status) {
+    static const long totalMemKb = sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGE_SIZE) / 1024;
+    return (totalMemKb > 0) ? (float)procStatusField(status, "\nVmRSS:") * 100.0f / totalMemKb : 0.0f;
 }
 
 // Parse /proc/[pid]/status to read memory usage in kB, return percent of total system memory
 float readProcessMemoryPercent(int pid) {
     char path[64];
     snprintf(path, sizeof(path), "/proc/%d/status", pid);
-    FILE* file = fopen(path, "r");
-    if (!file) return 0.0f;
+    std::string contents;
+    if (!procReadFile(path, contents)) return 0.0f;
+    return memoryPercent(contents);
+}
+
+// -----------------------------
+// Collection
+// -----------------------------
+
+// Percent of one cpu that `ticks` of CPU time is over `seconds`
+static float ticksPercent(unsigned long long ticks, double seconds) {
+    return (float)(ticks * 100.0 / clockTicksPerSecond / seconds);
+}
+
+// Smoothed user and system % from the ticks gained since `old` (null on the
+// first round, and for a pid or tid reused by a new process or thread, which
+// the callers tell by its start time)
+static void updateCpuPercent(ProcCpu& cpu, const ProcCpu* old, double elapsed, float weight) {
+    if (!old || cpu.utime < old->utime || cpu.stime < old->stime) return;
+    float user = ticksPercent(cpu.utime - old->utime, elapsed);
+    float system = ticksPercent(cpu.stime - old->stime, elapsed);
+    cpu.userPercent = old->userPercent + weight * (user - old->userPercent);
+    cpu.systemPercent = old->systemPercent + weight * (system - old->systemPercent);
+}
+
+// The threads of one process. Their stat line has the name too, so each
+// thread costs one read rather than two with comm
+static void readProcessThreads(int pid, std::string& contents, bool canCalculate, double elapsed, float weight,
+                               std::unordered_map<int, ProcCpu>& threadTimes, std::vector<ThreadSample>& threads) {
+    static std::vector<std::string> entries;
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/task", pid);
+    if (!procListDir(path, entries)) return;
+
+    for (const std::string& entry : entries) {
+        ThreadSample t;
+        t.tid = atoi(entry.c_str());
+        if (t.tid <= 0) continue;
+        snprintf(path, sizeof(path), "/proc/%d/task/%d/stat", pid, t.tid);
+        ProcStat stat;
+        if (!procReadFile(path, contents) || !parseProcStat(contents.c_str(), stat)) continue;
+        size_t open = contents.find('('), close = contents.rfind(')');
+        if (open != std::string::npos && close > open) t.name = contents.substr(open + 1, close - open - 1);
+        t.state = stat.state;
+        t.processor = stat.processor;
+        t.cpuTime = stat.utime + stat.stime;
+
+        ProcCpu cpu = {stat.utime, stat.stime, stat.startTime, 0.0f, 0.0f, 0, 0, 0, 0, false, {}};
+        auto last = lastThreadCpu.find(t.tid);
+        bool reused = last != lastThreadCpu.end() && last->second.startTime != cpu.startTime;
+        updateCpuPercent(cpu, canCalculate && last != lastThreadCpu.end() && !reused ? &last->second : nullptr, elapsed, weight);
+        t.userPercent = cpu.userPercent;
+        t.systemPercent = cpu.systemPercent;
+        t.cpuPercent = t.userPercent + t.systemPercent;
+        threadTimes[t.tid] = cpu;
+        threads.push_back(std::move(t));
+    }
+    std::sort(threads.begin(), threads.end(), [](const ThreadSample& a, const ThreadSample& b) { return a.tid < b.tid; });
+}
+
+// Reads every process under /proc. CPU % is the utime and stime a process
+// gained since the previous call over the time between the calls (100% is
+// one cpu busy), so it doesn't depend on how often the UI draws
+std::vector<ProcessSample> collectProcesses() {
+    PROFILE_ZONE("collectProcesses");
+    std::vector<ProcessSample> processes;
+    std::unordered_map<int, ProcCpu> cpuTimes, threadTimes;
+    cpuTimes.reserve(lastProcCpu.size());
+
+    // An archive's rounds carry their own time; live, the monotonic clock
+    double now = isArchiveOpen() ? archiveRoundTimeMs() / 1000.0 : getTimeSeconds();
+    double elapsed = now - lastProcCpuSeconds;
+    bool canCalculate = havePrevious && elapsed > 0.0;
+    // Time-based EWMA weight, so the average spans the same time at any sample interval
+    float weight = processCpuSmoothingSeconds > 0.0f && canCalculate
+                       ? (float)(1.0 - std::exp(-elapsed / processCpuSmoothingSeconds))
+                       : 1.0f;
+
+    // Whatever the background reader has for the rows the table asked for
+    static std::unordered_map<int, SmapsMemory> smaps;
+    smapsResults(smaps);
+
+    std::vector<std::string> entries;
+    if (!procListDir("/proc", entries)) return processes;
+
+    std::string contents;
+    for (const std::string& entry : entries) {
+        if (entry.empty() || !std::all_of(entry.begin(), entry.end(), ::isdigit)) continue;
+
+        ProcessSample p;
+        p.pid = atoi(entry.c_str());
+
+        // Read process name
+        p.name = "unknown";
+        char commPath[64];
+        snprintf(commPath, sizeof(commPath), "/proc/%d/comm", p.pid);
+        if (procReadFile(commPath, contents) && !contents.empty()) {
+            p.name = contents.substr(0, contents.find('\n'));
+        }
+
+        // State, CPU time, faults and scheduling from one read of stat
+        char path[64];
+        snprintf(path, sizeof(path), "/proc/%d/stat", p.pid);
+        ProcStat stat;
+        if (!procReadFile(path, contents) || !parseProcStat(contents.c_str(), stat)) stat.state = '?';
+        ProcCpu cpu = {stat.utime, stat.stime, stat.startTime, 0.0f, 0.0f, stat.minflt, stat.majflt, 0, 0, false, {}};
+        p.state = stat.state;
+        p.cpuTime = cpu.utime + cpu.stime;
+        p.threads = stat.threads;
+        p.priority = stat.priority;
+        p.nice = stat.nice;
+        p.processor = stat.processor;
+        p.policy = stat.policy;
+
+        // Memory and context switches from one read of status
+        snprintf(path, sizeof(path), "/proc/%d/status", p.pid);
+        if (procReadFile(path, contents)) {
+            p.memPercent = memoryPercent(contents);
+            cpu.voluntarySwitches = procStatusField(contents, "\nvoluntary_ctxt_switches:");
+            cpu.involuntarySwitches = procStatusField(contents, "\nnonvoluntary_ctxt_switches:");
+        }
+
+        // A pid taken by a new process since the previous round has no counters to compare with,
+        // even when the new process already used more CPU time than the old one
+        auto last = lastProcCpu.find(p.pid);
+        bool reused = last != lastProcCpu.end() && last->second.startTime != cpu.startTime;
+        const ProcCpu* old = canCalculate && last != lastProcCpu.end() && !reused ? &last->second : nullptr;
+        updateCpuPercent(cpu, old, elapsed, weight);
+        p.userPercent = cpu.userPercent;
+        p.systemPercent = cpu.systemPercent;
+        p.cpuPercent = p.userPercent + p.systemPercent;
+
+        // Fault and switch rates over the interval, like I/O; counters never go back for the same process
+        if (old) {
+            auto rate = [elapsed](unsigned long long now, unsigned long long before) {
+                return now >= before ? (float)((now - before) / elapsed) : 0.0f;
+            };
+            p.minorFaults = rate(cpu.minorFaults, old->minorFaults);
+            p.majorFaults = rate(cpu.majorFaults, old->majorFaults);
+            p.voluntarySwitches = rate(cpu.voluntarySwitches, old->voluntarySwitches);
+            p.involuntarySwitches = rate(cpu.involuntarySwitches, old->involuntarySwitches);
+        }
+
+        // I/O costs one more file per process, so it is only read while its columns are shown
+        if (processIoEnabled && readProcessIo(p.pid, contents, cpu.io)) {
+            cpu.ioRead = true;
+            p.ioFound = true;
+            if (old && old->ioRead) {
+                for (int i = 0; i < ioCounterCount; i++)
+                    if (cpu.io[i] >= old->io[i]) p.io.*ioRateFields[i] = (float)((cpu.io[i] - old->io[i]) / elapsed);
+            }
+        }
+
+        // Threads likewise, and only of the processes expanded in the table
+        if (expandedProcesses.count(p.pid))
+            readProcessThreads(p.pid, contents, canCalculate, elapsed, weight, threadTimes, p.tasks);
+
+        // A new pid, or a reused one, reads its cgroup at once; the others in turn,
+        // a 1/cgroupRefreshRounds share each round
+        if (last == lastProcCpu.end() || reused || (p.pid + collectRound) % cgroupRefreshRounds == 0)
+            readProcessCgroup(p.pid, contents, cpu.cgroup);
+        else
+            cpu.cgroup = std::move(last->second.cgroup);  // lastProcCpu is replaced below
+        p.cgroup = cpu.cgroup;
+
+        // A reused pid's smaps result belongs to the process that exited
+        auto memory = smaps.find(p.pid);
+        if (memory != smaps.end() && reused) {
+            forgetSmaps(p.pid);
+            smaps.erase(memory);
+        } else if (memory != smaps.end()) {
+            p.smaps = memory->second;
+        }
+
+        cpuTimes[p.pid] = std::move(cpu);
+        processes.push_back(std::move(p));
+    }
 
-    char line[256];
-    unsigned long vmrss = 0;
-    while (fgets(line, sizeof(line), file)) {
-        if (sscanf(line, "VmRSS: %lu kB", &vmrss) == 1) break;
+    std::sort(processes.begin(), processes.end(),
+              [](const ProcessSample& a, const ProcessSample& b) { return a.pid < b.pid; });
+
+    // A process that exited can't stay expanded, or a new one reusing its pid would be
+    for (auto it = expandedProcesses.begin(); it != expandedProcesses.end();) {
+        auto found = std::lower_bound(processes.begin(), processes.end(), *it,
+                                      [](const ProcessSample& p, int pid) { return p.pid < pid; });
+        it = found != processes.end() && found->pid == *it ? std::next(it) : expandedProcesses.erase(it);
     }
-    fclose(file);
 
-    long totalMemKb = sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGE_SIZE) / 1024;
-    return (totalMemKb > 0) ? (float)vmrss * 100.0f / totalMemKb : 0.0f;
+    // Only keep pids that still exist
+    lastProcCpu.swap(cpuTimes);
+    lastThreadCpu.swap(threadTimes);
+    lastProcCpuSeconds = now;
+    havePrevious = true;
+    collectRound++;
+    return processes;
 }
 
 // -----------------------------
 // Main UI: Process Table
 // -----------------------------
 
+enum ProcessColumn {
+    ColPid, ColName, ColState, ColCpu, ColUser, ColSystem, ColMemory,
+    ColPss, ColUss, ColShared, ColSwap,
+    ColReadBytes, ColWriteBytes, ColRchar, ColWchar, ColSyscr, ColSyscw,
+    ColThreads, ColPriority, ColNice, ColProcessor, ColPolicy,
+    ColMinorFaults, ColMajorFaults, ColVoluntarySwitches, ColInvoluntarySwitches,
+    ColCgroup,
+    ColCount
+};
+
+static float ProcessSample::* const schedRateFields[] = {
+    &ProcessSample::minorFaults, &ProcessSample::majorFaults,
+    &ProcessSample::voluntarySwitches, &ProcessSample::involuntarySwitches};
+
+// sched_setscheduler(2) policy numbers
+static const char* policyName(int policy) {
+    switch (policy) {
+    case 0: return "OTHER";
+    case 1: return "FIFO";
+    case 2: return "RR";
+    case 3: return "BATCH";
+    case 5: return "IDLE";
+    case 6: return "DEADLINE";
+    default: return "?";
+    }
+}
+
+static uint64_t SmapsMemory::* const smapsColumnFields[] = {
+    &SmapsMemory::pssKB, &SmapsMemory::ussKB, &SmapsMemory::sharedKB, &SmapsMemory::swapKB};
+
+static float sortKey(const ProcessSample& p, int column) {
+    switch (column) {
+    case ColCpu: return p.cpuPercent;
+    case ColUser: return p.userPercent;
+    case ColSystem: return p.systemPercent;
+    case ColMemory: return p.memPercent;
+    case ColState: return (float)p.state;
+    case ColThreads: return (float)p.threads;
+    case ColPriority: return (float)p.priority;
+    case ColNice: return (float)p.nice;
+    case ColProcessor: return (float)p.processor;
+    case ColPolicy: return (float)p.policy;
+    default:
+        if (column >= ColMinorFaults && column <= ColInvoluntarySwitches)
+            return p.*schedRateFields[column - ColMinorFaults];
+        if (column >= ColPss && column <= ColSwap)
+            return p.smaps.found ? (float)(p.smaps.*smapsColumnFields[column - ColPss]) : -1.0f;
+        if (column >= ColReadBytes && column <= ColSyscw)
+            return p.ioFound ? p.io.*ioRateFields[column - ColReadBytes] : -1.0f;
+        return (float)p.pid;
+    }
+}
+
+// Row order for the table's sort column; snapshots are sorted by pid already
+static void sortProcesses(const std::vector<ProcessSample>& processes, const ImGuiTableSortSpecs* specs,
+                          std::vector<int>& order) {
+    order.resize(processes.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = (int)i;
+    if (!specs || specs->SpecsCount == 0) return;
+    const ImGuiTableColumnSortSpecs& spec = specs->Specs[0];
+    bool descending = spec.SortDirection == ImGuiSortDirection_Descending;
+    int column = (int)spec.ColumnUserID;
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        const ProcessSample& x = processes[a];
+        const ProcessSample& y = processes[b];
+        if (column == ColName) return descending ? y.name < x.name : x.name < y.name;
+        if (column == ColCgroup) return descending ? y.cgroup < x.cgroup : x.cgroup < y.cgroup;
+        return descending ? sortKey(y, column) < sortKey(x, column) : sortKey(x, column) < sortKey(y, column);
+    });
+}
+
 void renderProcessesWindow(const char* id, ImVec2 size, ImVec2 position) {
+    PROFILE_ZONE("renderProcessesWindow");
     static char filter[256] = "";
 
+    // Stay off (and empty) unless the table below shows those columns this frame
+    processIoEnabled = false;
+    static std::vector<int> smapsPids;
+    smapsPids.clear();
+
     ImGui::SetNextWindowSize(size, ImGuiCond_FirstUseEver);
     ImGui::SetNextWindowPos(position, ImGuiCond_FirstUseEver);
 
     if (!ImGui::Begin(id)) {
         ImGui::End();
+        if (!isReplaying()) requestSmaps(smapsPids);
         return;
     }
 
     ImGui::InputText("Filter", filter, sizeof(filter));
+    // A replay shows CPU % as it was recorded
+    if (!isReplaying())
+        ImGui::SliderFloat("CPU % smoothing", &processCpuSmoothingSeconds, 0.0f, 30.0f,
+                           processCpuSmoothingSeconds > 0.0f ? "%.0f s" : "off");
 
-    unsigned long long totalCpu = readTotalCpuTime();
-    double now = getTimeSeconds();
-    double dt = now - lastSampleTime;
-    bool canCalculate = (lastSampleTime > 0.0 && dt >= 0.5);
+    std::string filterLower = filter;
+    std::transform(filterLower.begin(), filterLower.end(), filterLower.begin(), ::tolower);
 
     if (ImGui::BeginTabBar("ProcessTabs")) {
         if (ImGui::BeginTabItem("Processes")) {
-            if (ImGui::BeginTable("ProcessTable", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY)) {
-                ImGui::TableSetupColumn("PID");
-                ImGui::TableSetupColumn("Name");
-                ImGui::TableSetupColumn("State");
-                ImGui::TableSetupColumn("CPU %");
-                ImGui::TableSetupColumn("Memory %");
+            ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY |
+                                    ImGuiTableFlags_Sortable | ImGuiTableFlags_Hideable | ImGuiTableFlags_Resizable;
+            if (ImGui::BeginTable("ProcessTable", ColCount, flags)) {
+                ImGuiTableColumnFlags rate = ImGuiTableColumnFlags_PreferSortDescending;
+                ImGuiTableColumnFlags ioRate = rate | ImGuiTableColumnFlags_DefaultHide;
+                ImGui::TableSetupScrollFreeze(0, 1);
+                ImGui::TableSetupColumn("PID", ImGuiTableColumnFlags_DefaultSort, 0.0f, ColPid);
+                ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_None, 0.0f, ColName);
+                ImGui::TableSetupColumn("State", ImGuiTableColumnFlags_None, 0.0f, ColState);
+                ImGui::TableSetupColumn("CPU %", rate, 0.0f, ColCpu);
+                ImGui::TableSetupColumn("User %", rate, 0.0f, ColUser);
+                ImGui::TableSetupColumn("System %", rate, 0.0f, ColSystem);
+                ImGui::TableSetupColumn("Memory %", rate, 0.0f, ColMemory);
+                ImGui::TableSetupColumn("PSS", rate, 0.0f, ColPss);
+                ImGui::TableSetupColumn("USS", rate, 0.0f, ColUss);
+                ImGui::TableSetupColumn("Shared", rate | ImGuiTableColumnFlags_DefaultHide, 0.0f, ColShared);
+                ImGui::TableSetupColumn("Swap", rate | ImGuiTableColumnFlags_DefaultHide, 0.0f, ColSwap);
+                ImGui::TableSetupColumn("Disk read/s", ioRate, 0.0f, ColReadBytes);
+                ImGui::TableSetupColumn("Disk write/s", ioRate, 0.0f, ColWriteBytes);
+                ImGui::TableSetupColumn("Read/s", ioRate, 0.0f, ColRchar);
+                ImGui::TableSetupColumn("Write/s", ioRate, 0.0f, ColWchar);
+                ImGui::TableSetupColumn("Read calls/s", ioRate, 0.0f, ColSyscr);
+                ImGui::TableSetupColumn("Write calls/s", ioRate, 0.0f, ColSyscw);
+                ImGuiTableColumnFlags hidden = ImGuiTableColumnFlags_DefaultHide;
+                ImGui::TableSetupColumn("Threads", rate | hidden, 0.0f, ColThreads);
+                ImGui::TableSetupColumn("Priority", hidden, 0.0f, ColPriority);
+                ImGui::TableSetupColumn("Nice", hidden, 0.0f, ColNice);
+                ImGui::TableSetupColumn("Last CPU", hidden, 0.0f, ColProcessor);
+                ImGui::TableSetupColumn("Policy", hidden, 0.0f, ColPolicy);
+                ImGui::TableSetupColumn("Minor faults/s", rate | hidden, 0.0f, ColMinorFaults);
+                ImGui::TableSetupColumn("Major faults/s", rate | hidden, 0.0f, ColMajorFaults);
+                ImGui::TableSetupColumn("Voluntary switches/s", rate | hidden, 0.0f, ColVoluntarySwitches);
+                ImGui::TableSetupColumn("Involuntary switches/s", rate | hidden, 0.0f, ColInvoluntarySwitches);
+                ImGui::TableSetupColumn("Cgroup", hidden, 0.0f, ColCgroup);
                 ImGui::TableHeadersRow();
 
-                DIR* proc = opendir("/proc");
-                if (proc) {
-                    struct dirent* entry;
-                    while ((entry = readdir(proc)) != nullptr) {
-                        if (entry->d_type != DT_DIR) continue;
-                        if (!std::all_of(entry->d_name, entry->d_name + strlen(entry->d_name), ::isdigit)) continue;
-
-                        int pid = atoi(entry->d_name);
-
-                        // Read process name
-                        std::string name = "unknown";
-                        char commPath[64];
-                        snprintf(commPath, sizeof(commPath), "/proc/%d/comm", pid);
-                        if (FILE* commFile = fopen(commPath, "r")) {
-                            char buf[256];
-                            if (fgets(buf, sizeof(buf), commFile)) {
-                                buf[strcspn(buf, "\n")] = '\0';
-                                name = buf;
-                            }
-                            fclose(commFile);
-                        }
-
-                        // Read process state
-                        char statPath[64];
-                        snprintf(statPath, sizeof(statPath), "/proc/%d/stat", pid);
-                        char state = '?';
-                        if (FILE* statFile = fopen(statPath, "r")) {
-                            int dummy;
-                            char dummyComm[256];
-                            fscanf(statFile, "%d %255s %c", &dummy, dummyComm, &state);
-                            fclose(statFile);
-                        }
+                // The I/O columns are hidden by default; right-click the header to show them
+                for (int col = ColReadBytes; col <= ColSyscw; col++)
+                    if (ImGui::TableGetColumnFlags(col) & ImGuiTableColumnFlags_IsEnabled) processIoEnabled = true;
+                bool smapsShown = false;
+                for (int col = ColPss; col <= ColSwap; col++)
+                    if (ImGui::TableGetColumnFlags(col) & ImGuiTableColumnFlags_IsEnabled) smapsShown = true;
+
+                const std::vector<ProcessSample>& processes = currentSnapshot().processes;
+                static std::vector<int> order;
+                static uint64_t orderSequence = 0;
+                ImGuiTableSortSpecs* specs = ImGui::TableGetSortSpecs();
+                if (order.size() != processes.size() || orderSequence != snapshotSequence() ||
+                    (specs && specs->SpecsDirty)) {
+                    sortProcesses(processes, specs, order);
+                    orderSequence = snapshotSequence();
+                    if (specs) specs->SpecsDirty = false;
+                }
 
-                        // Apply filter
-                        std::string nameLower = name;
+                // Apply filter; an expanded process is followed by its threads, busiest first
+                struct TableRow {
+                    int process;
+                    int thread;  // index into tasks, or -1 for the process itself
+                };
+                static std::vector<TableRow> rows;
+                static std::vector<int> threadOrder;
+                rows.clear();
+                for (int index : order) {
+                    const ProcessSample& p = processes[index];
+                    if (!filterLower.empty()) {
+                        std::string nameLower = p.name;
                         std::transform(nameLower.begin(), nameLower.end(), nameLower.begin(), ::tolower);
-                        std::string filterLower = filter;
-                        std::transform(filterLower.begin(), filterLower.end(), filterLower.begin(), ::tolower);
-
-                        if (!filterLower.empty() &&
-                            nameLower.find(filterLower) == std::string::npos &&
-                            std::to_string(pid).find(filterLower) == std::string::npos)
+                        if (nameLower.find(filterLower) == std::string::npos &&
+                            std::to_string(p.pid).find(filterLower) == std::string::npos)
                             continue;
-
-                        // Read CPU & memory
-                        unsigned long long currCpu = readProcessCpuTime(pid);
-                        float cpuPercent = 0.0f;
-                        float memPercent = readProcessMemoryPercent(pid);
-
-                        auto& procInfo = processesCpuData[pid];
-                        if (canCalculate && currCpu >= procInfo.lastCpuTime && totalCpu > lastTotalCpu) {
-                        unsigned long long deltaProc = currCpu - procInfo.lastCpuTime;
-                        unsigned long long deltaTotal = totalCpu - lastTotalCpu;
-                        cpuPercent = (deltaProc / (float)deltaTotal) * 100.0f * cpuCount;
                     }
+                    rows.push_back({index, -1});
+                    if (p.tasks.empty() || !expandedProcesses.count(p.pid)) continue;
+                    threadOrder.resize(p.tasks.size());
+                    for (size_t i = 0; i < threadOrder.size(); i++) threadOrder[i] = (int)i;
+                    std::stable_sort(threadOrder.begin(), threadOrder.end(), [&p](int a, int b) {
+                        return p.tasks[a].cpuPercent > p.tasks[b].cpuPercent;
+                    });
+                    for (int thread : threadOrder) rows.push_back({index, thread});
+                }
 
+                // smaps_rollup is read in the background for the selected and the visible rows
+                if (smapsShown) smapsPids.assign(selectedPids.begin(), selectedPids.end());
 
-
-                        // Update proc info
-                        procInfo.name = name;
-                        procInfo.state = state;
-                        procInfo.cpuPercent = cpuPercent;
-                        procInfo.memPercent = memPercent;
-                        procInfo.lastCpuTime = currCpu;
+                ImGuiListClipper clipper;
+                clipper.Begin((int)rows.size());
+                while (clipper.Step()) {
+                    for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+                        const ProcessSample& p = processes[rows[row].process];
 
                         // Render table row
                         ImGui::TableNextRow();
+                        if (rows[row].thread >= 0) {
+                            const ThreadSample& t = p.tasks[rows[row].thread];
+                            ImGui::TableSetColumnIndex(ColPid); ImGui::TextDisabled("  %d", t.tid);
+                            ImGui::TableSetColumnIndex(ColName); ImGui::Text("  %s", t.name.c_str());
+                            ImGui::TableSetColumnIndex(ColState); ImGui::Text("%c", t.state);
+                            ImGui::TableSetColumnIndex(ColCpu); ImGui::Text("%.2f%%", t.cpuPercent);
+                            ImGui::TableSetColumnIndex(ColUser); ImGui::Text("%.2f%%", t.userPercent);
+                            ImGui::TableSetColumnIndex(ColSystem); ImGui::Text("%.2f%%", t.systemPercent);
+                            if (ImGui::TableSetColumnIndex(ColProcessor)) ImGui::Text("%d", t.processor);
+                            continue;
+                        }
+                        if (smapsShown) smapsPids.push_back(p.pid);
                         ImGui::TableSetColumnIndex(0);
 
-                        bool isSelected = selectedPids.count(pid) > 0;
-                        if (ImGui::Selectable(std::to_string(pid).c_str(), isSelected, ImGuiSelectableFlags_SpanAllColumns)) {
+                        // Overlap lets the expand button in the name column take its clicks
+                        bool isSelected = selectedPids.count(p.pid) > 0;
+                        if (ImGui::Selectable(std::to_string(p.pid).c_str(), isSelected,
+                                              ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowItemOverlap)) {
                             if (isSelected)
-                                selectedPids.erase(pid);
+                                selectedPids.erase(p.pid);
                             else
-                                selectedPids.insert(pid);
+                                selectedPids.insert(p.pid);
                         }
 
-                        ImGui::TableSetColumnIndex(1); ImGui::Text("%s", name.c_str());
-                        ImGui::TableSetColumnIndex(2); ImGui::Text("%c", state);
-                        ImGui::TableSetColumnIndex(3); ImGui::Text("%.2f%%", cpuPercent);
-                        ImGui::TableSetColumnIndex(4); ImGui::Text("%.2f%%", memPercent);
+                        ImGui::TableSetColumnIndex(1);
+                        // The threads are read from the next snapshot on, and not at all in a replay
+                        bool expanded = expandedProcesses.count(p.pid) > 0;
+                        if (p.threads > 1 && (!isReplaying() || !p.tasks.empty())) {
+                            ImGui::PushID(p.pid);
+                            if (ImGui::SmallButton(expanded ? "-" : "+")) {
+                                if (expanded)
+                                    expandedProcesses.erase(p.pid);
+                                else
+                                    expandedProcesses.insert(p.pid);
+                            }
+                            ImGui::PopID();
+                            ImGui::SameLine();
+                        }
+                        ImGui::Text("%s", p.name.c_str());
+                        ImGui::TableSetColumnIndex(2); ImGui::Text("%c", p.state);
+                        ImGui::TableSetColumnIndex(3); ImGui::Text("%.2f%%", p.cpuPercent);
+                        ImGui::TableSetColumnIndex(4); ImGui::Text("%.2f%%", p.userPercent);
+                        ImGui::TableSetColumnIndex(5); ImGui::Text("%.2f%%", p.systemPercent);
+                        ImGui::TableSetColumnIndex(6); ImGui::Text("%.2f%%", p.memPercent);
+                        for (int col = ColPss; col <= ColSwap; col++) {
+                            if (!ImGui::TableSetColumnIndex(col)) continue;
+                            if (!p.smaps.found) ImGui::TextDisabled("-");
+                            else ImGui::Text("%s", formatBytes(p.smaps.*smapsColumnFields[col - ColPss] * 1024).c_str());
+                        }
+                        for (int col = ColReadBytes; col <= ColSyscw; col++) {
+                            if (!ImGui::TableSetColumnIndex(col)) continue;
+                            if (!p.ioFound) ImGui::TextDisabled("-");
+                            else if (col >= ColSyscr) ImGui::Text("%.0f", p.io.*ioRateFields[col - ColReadBytes]);
+                            else ImGui::Text("%s/s", formatBytes((uint64_t)(p.io.*ioRateFields[col - ColReadBytes])).c_str());
+                        }
+                        if (ImGui::TableSetColumnIndex(ColThreads)) ImGui::Text("%d", p.threads);
+                        if (ImGui::TableSetColumnIndex(ColPriority)) ImGui::Text("%d", p.priority);
+                        if (ImGui::TableSetColumnIndex(ColNice)) ImGui::Text("%d", p.nice);
+                        if (ImGui::TableSetColumnIndex(ColProcessor)) ImGui::Text("%d", p.processor);
+                        if (ImGui::TableSetColumnIndex(ColPolicy)) ImGui::Text("%s", policyName(p.policy));
+                        for (int col = ColMinorFaults; col <= ColInvoluntarySwitches; col++)
+                            if (ImGui::TableSetColumnIndex(col)) ImGui::Text("%.0f", p.*schedRateFields[col - ColMinorFaults]);
+                        if (ImGui::TableSetColumnIndex(ColCgroup)) ImGui::Text("%s", p.cgroup.c_str());
                     }
-                    closedir(proc);
-                } else {
-                    ImGui::Text("Failed to open /proc");
                 }
 
+                if (currentSnapshot().processes.empty()) ImGui::Text("Failed to open /proc");
+
                 ImGui::EndTable();
             }
             ImGui::EndTabItem();
         }
+        if (ImGui::BeginTabItem("Cgroups")) {
+            renderCgroupsTab();
+            ImGui::EndTabItem();
+        }
         ImGui::EndTabBar();
     }
 
     ImGui::End();
-
-    // ✅ Fixed: Only update after rendering
-    lastTotalCpu = totalCpu;
-    lastSampleTime = now;
+    if (!isReplaying()) requestSmaps(smapsPids);
 }
@@ -0,0 +1,437 @@
+#include "procfs.h"
+#include "encoding.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <unordered_set>
+
+// ------------------------------
+// LIVE HOST
+// ------------------------------
+
+bool readRealFile(const char* path, std::string& out) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    // /proc files report size 0, so read until EOF
+    out.clear();
+    char buf[4096];
+    ssize_t n;
+    while ((n = read(fd, buf, sizeof(buf))) > 0) out.append(buf, n);
+    close(fd);
+    return n == 0;
+}
+
+uint64_t procStatusField(const std::string& text, const char* key) {
+    size_t found = text.find(key);
+    return found == std::string::npos ? 0 : strtoull(text.c_str() + found + strlen(key), nullptr, 10);
+}
+
+bool ProcSource::listSubdirs(const std::string& path, std::vector<std::string>& names) {
+    std::vector<std::string> entries, unused;
+    if (!listDir(path, entries)) return false;
+    names.clear();
+    for (std::string& entry : entries)
+        if (listDir(path + "/" + entry, unused)) names.push_back(std::move(entry));
+    return true;
+}
+
+class LiveProcSource : public ProcSource {
+public:
+    std::string root;
+
+    bool readFile(const std::string& path, std::string& out) override {
+        return readRealFile(resolve(path), out);
+    }
+
+    // For held files; -1 if it can't be opened
+    int openFile(const std::string& path) {
+        return open(resolve(path), O_RDONLY | O_CLOEXEC);
+    }
+
+    bool listDir(const std::string& path, std::vector<std::string>& names) override {
+        DIR* dir = opendir(resolve(path));
+        if (!dir) return false;
+
+        names.clear();
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != nullptr) {
+            if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, "..")) continue;
+            names.push_back(entry->d_name);
+        }
+        closedir(dir);
+        return true;
+    }
+
+    bool listSubdirs(const std::string& path, std::vector<std::string>& names) override {
+        DIR* dir = opendir(resolve(path));
+        if (!dir) return false;
+
+        names.clear();
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != nullptr) {
+            if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, "..")) continue;
+            // procfs, sysfs and cgroupfs fill in d_type; a filesystem holding a --root tree may not
+            bool isDir = entry->d_type == DT_DIR;
+            struct stat st;
+            if (entry->d_type == DT_UNKNOWN)
+                isDir = fstatat(dirfd(dir), entry->d_name, &st, 0) == 0 && S_ISDIR(st.st_mode);
+            if (isDir) names.push_back(entry->d_name);
+        }
+        closedir(dir);
+        return true;
+    }
+
+private:
+    std::string rooted;  // reused so the common no-root case doesn't allocate
+
+    const char* resolve(const std::string& path) {
+        if (root.empty()) return path.c_str();
+        rooted.assign(root);
+        rooted.append(path);
+        return rooted.c_str();
+    }
+};
+
+static LiveProcSource liveSource;
+static ProcSource* activeSource = &liveSource;
+static uint64_t sourceGeneration = 1;
+
+ProcSource* liveProcSource() {
+    return &liveSource;
+}
+
+void setProcSource(ProcSource* source) {
+    activeSource = source ? source : &liveSource;
+    sourceGeneration++;
+}
+
+void setProcRoot(const std::string& root) {
+    liveSource.root = root;
+    while (!liveSource.root.empty() && liveSource.root.back() == '/') liveSource.root.pop_back();
+    sourceGeneration++;
+}
+
+const std::string& procRoot() {
+    return liveSource.root;
+}
+
+uint64_t procSourceGeneration() {
+    return sourceGeneration;
+}
+
+// ------------------------------
+// CAPTURE
+// ------------------------------
+
+static const char archiveMagic[4] = {'S', 'M', 'C', 'A'};
+static const uint8_t archiveVersion = 1;
+
+struct Capture {
+    FILE* file = nullptr;
+    bool inRound = false;
+    uint64_t rounds = 0;
+    uint64_t bytes = 0;
+    std::vector<uint8_t> buffer;  // current round, written at captureEndRound
+    std::unordered_set<std::string> seen;  // kind + path of the entries in buffer
+};
+
+static Capture capture;
+
+bool startCapture(const std::string& path) {
+    stopCapture();
+    capture.file = fopen(path.c_str(), "wb");
+    if (!capture.file) return false;
+
+    fwrite(archiveMagic, 1, 4, capture.file);
+    fwrite(&archiveVersion, 1, 1, capture.file);
+    capture.rounds = 0;
+    capture.bytes = 5;
+
+    // Collectors look for their files again, so the first round holds those reads too
+    sourceGeneration++;
+    return true;
+}
+
+void stopCapture() {
+    if (!capture.file) return;
+    if (capture.inRound) captureEndRound();
+    fclose(capture.file);
+    capture.file = nullptr;
+}
+
+bool isCapturing() {
+    return capture.file != nullptr;
+}
+
+uint64_t captureRounds() {
+    return capture.rounds;
+}
+
+uint64_t captureBytes() {
+    return capture.bytes;
+}
+
+void captureBeginRound(int64_t timeMs) {
+    if (!capture.file) return;
+    capture.buffer.clear();
+    capture.seen.clear();
+    capture.buffer.push_back('R');
+    putVarint(capture.buffer, (uint64_t)timeMs);
+    capture.inRound = true;
+}
+
+void captureEndRound() {
+    if (!capture.file || !capture.inRound) return;
+    capture.buffer.push_back('E');
+    fwrite(capture.buffer.data(), 1, capture.buffer.size(), capture.file);
+    fflush(capture.file);
+    capture.bytes += capture.buffer.size();
+    capture.rounds++;
+    capture.inRound = false;
+}
+
+// Only the first read of a path in a round is kept; later reads replay it
+static void captureEntry(char kind, const std::string& path, const char* data, size_t len) {
+    if (!capture.seen.insert(kind + path).second) return;
+    capture.buffer.push_back((uint8_t)kind);
+    putString(capture.buffer, path);
+    putVarint(capture.buffer, len);
+    capture.buffer.insert(capture.buffer.end(), data, data + len);
+}
+
+// ------------------------------
+// READ FUNCTIONS
+// ------------------------------
+
+bool procReadFile(const std::string& path, std::string& out) {
+    bool ok = activeSource->readFile(path, out);
+    if (ok && capture.inRound) captureEntry('F', path, out.data(), out.size());
+    return ok;
+}
+
+bool procListDir(const std::string& path, std::vector<std::string>& names) {
+    bool ok = activeSource->listDir(path, names);
+    if (ok && capture.inRound) {
+        std::string joined;
+        for (const std::string& n : names) {
+            joined += n;
+            joined += '\n';
+        }
+        captureEntry('D', path, joined.data(), joined.size());
+    }
+    return ok;
+}
+
+// Not captured: an archive answers from the listings of the subdirectories themselves
+bool procListSubdirs(const std::string& path, std::vector<std::string>& names) {
+    return activeSource->listSubdirs(path, names);
+}
+
+bool procExists(const std::string& path) {
+    std::string unusedData;
+    std::vector<std::string> unusedNames;
+    return procReadFile(path, unusedData) || procListDir(path, unusedNames);
+}
+
+// ------------------------------
+// HELD FILES
+// ------------------------------
+
+void procCloseHandle(ProcHandle& handle) {
+    if (handle.fd >= 0) close(handle.fd);
+    handle.fd = -1;
+}
+
+void raiseFdLimit() {
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+static void reopenHandle(ProcHandle& handle) {
+    procCloseHandle(handle);
+    handle.generation = sourceGeneration;
+    handle.attribute = handle.path.compare(0, 5, "/sys/") == 0 && handle.path.compare(0, 8, "/sys/fs/") != 0;
+    // Out of fds (EMFILE) just means this one is read by path
+    if (activeSource == &liveSource) handle.fd = liveSource.openFile(handle.path);
+}
+
+bool procOpenHandle(const std::string& path, ProcHandle& handle) {
+    handle.path = path;
+    reopenHandle(handle);
+    std::string data;
+    return procReadHandle(handle, data);
+}
+
+bool procReadHandle(ProcHandle& handle, std::string& out) {
+    if (handle.generation != sourceGeneration) reopenHandle(handle);
+
+    bool ok;
+    if (handle.fd >= 0) {
+        // sysfs and procfs regenerate the contents on every read from offset 0
+        out.clear();
+        char buf[4096];
+        off_t offset = 0;
+        ssize_t n;
+        while ((n = pread(handle.fd, buf, sizeof(buf), offset)) > 0) {
+            out.append(buf, n);
+            offset += n;
+            // A sysfs attribute is generated whole, so a short read is the end of it. A /proc
+            // or cgroup seq_file returns only whole records per read (/proc/self/smaps comes in
+            // reads of 4037, 3907, 3958... bytes), so those are read until pread returns 0
+            if (handle.attribute && (size_t)n < sizeof(buf)) {
+                n = 0;
+                break;
+            }
+        }
+        ok = n == 0;
+    } else {
+        ok = activeSource->readFile(handle.path, out);
+    }
+    if (ok && capture.inRound) captureEntry('F', handle.path, out.data(), out.size());
+    return ok;
+}
+
+// ------------------------------
+// ARCHIVE SOURCE
+// ------------------------------
+
+class ArchiveProcSource : public ProcSource {
+public:
+    struct Entry {
+        const uint8_t* data;
+        size_t len;
+    };
+
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    std::vector<uint64_t> roundOffsets;
+    size_t round = 0;
+    int64_t roundTimeMs = 0;
+    std::unordered_map<std::string, Entry> entries;  // kind + path, of the current round
+
+    ~ArchiveProcSource() {
+        if (data) munmap((void*)data, size);
+    }
+
+    bool open(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < 5) {
+            close(fd);
+            return false;
+        }
+        void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) return false;
+        data = (const uint8_t*)p;
+        size = st.st_size;
+        if (memcmp(data, archiveMagic, 4) != 0 || data[4] != archiveVersion) return false;
+
+        // Index the complete rounds
+        Cursor in{data + 5, data + size};
+        while (in.ok && in.p < in.end && *in.p == 'R') {
+            uint64_t offset = in.p - data;
+            in.byte();
+            in.varint();
+            while (in.ok && in.p < in.end && *in.p != 'E') {
+                in.byte();
+                in.str();
+                uint64_t len = in.varint();
+                if ((uint64_t)(in.end - in.p) < len) in.ok = false;
+                else in.p += len;
+            }
+            if (!in.ok || in.byte() != 'E') break;
+            roundOffsets.push_back(offset);
+        }
+        return !roundOffsets.empty() && loadRound(0);
+    }
+
+    bool loadRound(size_t index) {
+        if (index >= roundOffsets.size()) return false;
+        round = index;
+        entries.clear();
+
+        Cursor in{data + roundOffsets[index], data + size};
+        in.byte();
+        roundTimeMs = (int64_t)in.varint();
+        while (in.p < in.end && *in.p != 'E') {
+            char kind = (char)in.byte();
+            std::string path = in.str();
+            uint64_t len = in.varint();
+            entries[kind + path] = Entry{in.p, (size_t)len};
+            in.p += len;
+        }
+        return true;
+    }
+
+    bool readFile(const std::string& path, std::string& out) override {
+        auto it = entries.find('F' + path);
+        if (it == entries.end()) return false;
+        out.assign((const char*)it->second.data, it->second.len);
+        return true;
+    }
+
+    bool listDir(const std::string& path, std::vector<std::string>& names) override {
+        auto it = entries.find('D' + path);
+        if (it == entries.end()) return false;
+        names.clear();
+        const char* p = (const char*)it->second.data;
+        const char* end = p + it->second.len;
+        while (p < end) {
+            const char* nl = (const char*)memchr(p, '\n', end - p);
+            if (!nl) nl = end;
+            names.emplace_back(p, nl - p);
+            p = nl + 1;
+        }
+        return true;
+    }
+};
+
+static ArchiveProcSource* archive = nullptr;
+
+bool openArchive(const std::string& path) {
+    ArchiveProcSource* source = new ArchiveProcSource();
+    if (!source->open(path)) {
+        delete source;
+        return false;
+    }
+    if (archive) {
+        setProcSource(nullptr);
+        delete archive;
+    }
+    archive = source;
+    setProcSource(archive);
+    return true;
+}
+
+bool isArchiveOpen() {
+    return archive != nullptr;
+}
+
+bool archiveNextRound() {
+    return archive && archive->loadRound(archive->round + 1);
+}
+
+int64_t archiveRoundTimeMs() {
+    return archive ? archive->roundTimeMs : 0;
+}
+
+size_t archiveRoundIndex() {
+    return archive ? archive->round : 0;
+}
+
+size_t archiveRoundCount() {
+    return archive ? archive->roundOffsets.size() : 0;
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ------------------------------
+// /proc AND /sys ACCESS
+// ------------------------------
+//
+// Every collector reads /proc and /sys through these functions, so they can
+// run against the live host, a capture archive, or any other ProcSource.
+
+// Where the collectors' files come from
+class ProcSource {
+public:
+    virtual ~ProcSource() {}
+
+    // Whole file contents; false if the file can't be read
+    virtual bool readFile(const std::string& path, std::string& out) = 0;
+
+    // Entry names of a directory (without "." and ".."); false if it can't be listed
+    virtual bool listDir(const std::string& path, std::vector<std::string>& names) = 0;
+
+    // The entries that are directories themselves; by default those that listDir can
+    // list in turn (so in an archive, the ones listed in the same round)
+    virtual bool listSubdirs(const std::string& path, std::vector<std::string>& names);
+};
+
+// Reads through the active source (and into the capture, if one is running)
+bool procReadFile(const std::string& path, std::string& out);
+bool procListDir(const std::string& path, std::vector<std::string>& names);
+bool procListSubdirs(const std::string& path, std::vector<std::string>& names);
+bool procExists(const std::string& path);
+
+// Straight from the filesystem, bypassing the active source and the capture: for the
+// monitor's own /proc/self, and for threads other than the one collecting
+bool readRealFile(const char* path, std::string& out);
+
+// Number after `key` in a "Key:   value" file (status, io, smaps_rollup), 0 if missing;
+// keys past the first line start with "\n" so they only match a whole name
+uint64_t procStatusField(const std::string& text, const char* key);
+
+// nullptr restores the live host
+void setProcSource(ProcSource* source);
+ProcSource* liveProcSource();
+
+// Directory the live source reads /proc and /sys under (e.g. a fixture tree),
+// empty = the real filesystem root
+void setProcRoot(const std::string& root);
+const std::string& procRoot();
+
+// Increments whenever the active source or the root changes (or a capture
+// starts), so collectors that discover their files once know to look again
+uint64_t procSourceGeneration();
+
+// ------------------------------
+// HELD FILES
+// ------------------------------
+//
+// For files re-read every round (thousands of sysfs counters on a big machine):
+// on the live host the file stays open and is re-read with pread, skipping the
+// path lookup; other sources read the path as usual. Reads are captured like
+// procReadFile, and a handle reopens itself after the source changes.
+
+struct ProcHandle {
+    std::string path;
+    int fd = -1;              // -1 = read by path (not live, or out of fds)
+    uint64_t generation = 0;  // procSourceGeneration() the fd belongs to
+    bool attribute = false;   // a sysfs attribute, whose first short read is the whole file
+};
+
+// Points the handle at `path`; false if the file can't be read
+bool procOpenHandle(const std::string& path, ProcHandle& handle);
+bool procReadHandle(ProcHandle& handle, std::string& out);
+void procCloseHandle(ProcHandle& handle);
+
+// Lifts the soft fd limit to the hard one, for collectors that hold thousands of files
+void raiseFdLimit();
+
+// ------------------------------
+// CAPTURE ARCHIVE
+// ------------------------------
+//
+// Archive layout:
+//   header : "SMCA" | u8 version
+//   round  : 'R' | varint timeMs | entry* | 'E'
+//   entry  : kind ('F' file, 'D' directory listing)
+//            | varint pathLen | path | varint dataLen | data
+// A directory listing is its entry names separated by '\n'. Paths that could
+// not be read are left out, and only the first read of a path in a round is kept.
+
+// Saves the raw bytes of every file read in a round to `path`
+bool startCapture(const std::string& path);
+void stopCapture();
+bool isCapturing();
+
+// Frame the reads of one collection round
+void captureBeginRound(int64_t timeMs);
+void captureEndRound();
+
+uint64_t captureRounds();
+uint64_t captureBytes();
+
+// Makes an archive the active source, positioned on its first round
+bool openArchive(const std::string& path);
+bool isArchiveOpen();
+
+// Moves to the next round; false when the archive is exhausted
+bool archiveNextRound();
+
+// Capture time of the current round, and round position/count
+int64_t archiveRoundTimeMs();
+size_t archiveRoundIndex();
+size_t archiveRoundCount();
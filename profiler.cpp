@@ -0,0 +1,200 @@
+#include "profiler.h"
+#include <imgui.h>
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// ------------------------------
+// ZONE STATE
+// ------------------------------
+
+bool profilerEnabled = false;
+bool showProfiler = false;
+
+// Durations kept per zone for the rolling percentiles
+static const size_t zoneWindow = 512;
+
+// Trace events kept for export (~8 MB)
+static const size_t traceCapacity = 262144;
+
+struct ZoneStats {
+    std::vector<float> durationsUs;  // ring of the last zoneWindow durations
+    size_t next = 0;
+    uint64_t calls = 0;
+    double maxUs = 0.0;
+};
+
+struct TraceEvent {
+    const char* name;
+    uint32_t tid;
+    int64_t startNs;
+    int64_t durationNs;
+};
+
+struct Profiler {
+    std::mutex mutex;  // zones may finish on collector threads
+    std::unordered_map<const char*, ZoneStats> zones;
+    std::vector<TraceEvent> events;  // ring of the last traceCapacity events
+    size_t nextEvent = 0;
+    int64_t enabledAtNs = 0;
+};
+
+static Profiler profiler;
+
+int64_t profilerNowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static uint32_t currentThreadId() {
+    thread_local uint32_t tid = (uint32_t)syscall(SYS_gettid);
+    return tid;
+}
+
+void profilerRecord(const char* name, int64_t startNs, int64_t endNs) {
+    uint32_t tid = currentThreadId();
+    float us = (endNs - startNs) / 1000.0f;
+
+    std::lock_guard<std::mutex> lock(profiler.mutex);
+    ZoneStats& zone = profiler.zones[name];
+    if (zone.durationsUs.size() < zoneWindow) zone.durationsUs.push_back(us);
+    else zone.durationsUs[zone.next] = us;
+    zone.next = (zone.next + 1) % zoneWindow;
+    zone.calls++;
+    zone.maxUs = std::max(zone.maxUs, (double)us);
+
+    TraceEvent event{name, tid, startNs, endNs - startNs};
+    if (profiler.events.size() < traceCapacity) profiler.events.push_back(event);
+    else profiler.events[profiler.nextEvent] = event;
+    profiler.nextEvent = (profiler.nextEvent + 1) % traceCapacity;
+}
+
+void setProfilerEnabled(bool enabled) {
+    if (enabled && !profilerEnabled) profilerReset();  // calls/s and percentiles start fresh
+    profilerEnabled = enabled;
+}
+
+void profilerReset() {
+    std::lock_guard<std::mutex> lock(profiler.mutex);
+    profiler.zones.clear();
+    profiler.events.clear();
+    profiler.nextEvent = 0;
+    profiler.enabledAtNs = profilerNowNs();
+}
+
+// ------------------------------
+// CHROME TRACE EXPORT
+// ------------------------------
+
+bool profilerExportTrace(const std::string& path) {
+    std::vector<TraceEvent> events;
+    {
+        std::lock_guard<std::mutex> lock(profiler.mutex);
+        events = profiler.events;
+    }
+    std::sort(events.begin(), events.end(),
+              [](const TraceEvent& a, const TraceEvent& b) { return a.startNs < b.startNs; });
+
+    FILE* out = fopen(path.c_str(), "w");
+    if (!out) return false;
+
+    // Complete ("X") events in microseconds; zone names are literals without quotes
+    fprintf(out, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    int pid = (int)getpid();
+    for (size_t i = 0; i < events.size(); i++) {
+        const TraceEvent& e = events[i];
+        fprintf(out, "{\"name\": \"%s\", \"ph\": \"X\", \"pid\": %d, \"tid\": %u, \"ts\": %.3f, \"dur\": %.3f}%s\n",
+                e.name, pid, e.tid, e.startNs / 1000.0, e.durationNs / 1000.0, i + 1 < events.size() ? "," : "");
+    }
+    fprintf(out, "]}\n");
+    return fclose(out) == 0;
+}
+
+// ------------------------------
+// OVERLAY
+// ------------------------------
+
+struct ZoneRow {
+    const char* name;
+    uint64_t calls;
+    float p50, p99, maxUs;
+};
+
+void renderProfilerWindow(const char* id, ImVec2 size, ImVec2 position) {
+    ImGui::SetNextWindowSize(size, ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowPos(position, ImGuiCond_FirstUseEver);
+
+    // Closing the overlay also stops recording
+    bool open = ImGui::Begin(id, &showProfiler);
+    if (!showProfiler) setProfilerEnabled(false);
+    if (!open) {
+        ImGui::End();
+        return;
+    }
+
+    bool enabled = profilerEnabled;
+    if (ImGui::Checkbox("Record zones", &enabled)) setProfilerEnabled(enabled);
+    ImGui::SameLine();
+    if (ImGui::Button("Reset")) profilerReset();
+    ImGui::SameLine();
+
+    static char exportMessage[256] = "";
+    if (ImGui::Button("Export Chrome Trace")) {
+        char path[64];
+        snprintf(path, sizeof(path), "sysmon-trace-%ld.json", (long)time(nullptr));
+        if (profilerExportTrace(path))
+            snprintf(exportMessage, sizeof(exportMessage), "Wrote %s", path);
+        else
+            snprintf(exportMessage, sizeof(exportMessage), "Could not write %s", path);
+    }
+    if (exportMessage[0]) ImGui::TextUnformatted(exportMessage);
+
+    // Percentiles of each zone's recent durations, slowest p99 first
+    std::vector<ZoneRow> rows;
+    double seconds = 0.0;
+    {
+        std::lock_guard<std::mutex> lock(profiler.mutex);
+        seconds = (profilerNowNs() - profiler.enabledAtNs) / 1e9;
+        std::vector<float> sorted;
+        for (const auto& [name, zone] : profiler.zones) {
+            sorted = zone.durationsUs;
+            std::sort(sorted.begin(), sorted.end());
+            rows.push_back({name, zone.calls, sorted[sorted.size() / 2],
+                            sorted[std::min(sorted.size() - 1, sorted.size() * 99 / 100)], (float)zone.maxUs});
+        }
+    }
+    std::sort(rows.begin(), rows.end(), [](const ZoneRow& a, const ZoneRow& b) { return a.p99 > b.p99; });
+
+    ImGui::Text("Last %zu calls per zone", zoneWindow);
+    if (ImGui::BeginTable("ProfilerZones", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_ScrollY)) {
+        ImGui::TableSetupColumn("Zone");
+        ImGui::TableSetupColumn("Calls/s");
+        ImGui::TableSetupColumn("p50 (ms)");
+        ImGui::TableSetupColumn("p99 (ms)");
+        ImGui::TableSetupColumn("Max (ms)");
+        ImGui::TableHeadersRow();
+
+        for (const ZoneRow& row : rows) {
+            ImGui::TableNextRow();
+            ImGui::TableSetColumnIndex(0);
+            ImGui::TextUnformatted(row.name);
+            ImGui::TableSetColumnIndex(1);
+            ImGui::Text("%.1f", seconds > 0 ? row.calls / seconds : 0.0);
+            ImGui::TableSetColumnIndex(2);
+            ImGui::Text("%.3f", row.p50 / 1000.0f);
+            ImGui::TableSetColumnIndex(3);
+            ImGui::Text("%.3f", row.p99 / 1000.0f);
+            ImGui::TableSetColumnIndex(4);
+            ImGui::Text("%.3f", row.maxUs / 1000.0f);
+        }
+        ImGui::EndTable();
+    }
+
+    ImGui::End();
+}
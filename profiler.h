@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// ------------------------------
+// SELF-PROFILER
+// ------------------------------
+//
+// PROFILE_ZONE("name") times the rest of the enclosing scope. Zones are
+// aggregated into rolling p50/p99 figures for the profiler overlay and kept
+// in a ring of recent events that can be exported as a Chrome trace
+// (chrome://tracing or ui.perfetto.dev).
+//
+// While the profiler is off a zone costs one test of profilerEnabled on entry
+// (and the same local flag on exit). Building with -DSYSMON_NO_PROFILER
+// compiles the zones out entirely. Names must be string literals: zones are
+// keyed by pointer.
+
+extern bool profilerEnabled;
+
+// Monotonic time in ns for zone timestamps
+int64_t profilerNowNs();
+
+// Adds one finished zone (called by ProfileZone)
+void profilerRecord(const char* name, int64_t startNs, int64_t endNs);
+
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* zoneName) : active(profilerEnabled) {
+        if (active) {
+            name = zoneName;
+            startNs = profilerNowNs();
+        }
+    }
+    ~ProfileZone() {
+        if (active) profilerRecord(name, startNs, profilerNowNs());
+    }
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    bool active;
+    const char* name = nullptr;
+    int64_t startNs = 0;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#ifdef SYSMON_NO_PROFILER
+#define PROFILE_ZONE(name) ((void)0)
+#else
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#endif
+
+// Turns zone recording on or off (the overlay checkbox and --profile);
+// turning it on starts fresh statistics
+void setProfilerEnabled(bool enabled);
+
+// Whether main() draws the profiler overlay
+extern bool showProfiler;
+
+// Forgets all zone statistics and trace events
+void profilerReset();
+
+// Writes the recorded events as Chrome trace-event JSON; false if the file can't be written
+bool profilerExportTrace(const std::string& path);
+
+struct ImVec2;
+
+// Per-zone p50/p99 table with record, reset and export controls
+void renderProfilerWindow(const char* id, ImVec2 size, ImVec2 position);
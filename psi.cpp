@@ -0,0 +1,264 @@
+#include "psi.h"
+#include "clock.h"
+#include "plot.h"
+#include "procfs.h"
+#include "profiler.h"
+#include "snapshot.h"
+#include <imgui.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+static const char* const resourceNames[PsiResources] = {"cpu", "memory", "io"};
+
+const char* psiResourceName(PsiResource resource) {
+    return resource < PsiResources ? resourceNames[resource] : "?";
+}
+
+static std::string pressurePath(int resource) {
+    return std::string("/proc/pressure/") + resourceNames[resource];
+}
+
+// ------------------------------
+// TRIGGERS
+// ------------------------------
+
+struct PsiTriggers {
+    std::thread thread;
+    int wakeFd = -1;                       // eventfd that stops the thread
+    int fds[PsiResources] = {-1, -1, -1};
+    std::atomic<uint64_t> events[PsiResources] = {};
+    std::atomic<int64_t> lastEventMs[PsiResources] = {};
+    std::string status = "off";
+};
+
+static PsiTriggers triggers;
+
+static void triggerLoop() {
+    pollfd fds[PsiResources + 1];
+    fds[0] = {triggers.wakeFd, POLLIN, 0};
+    for (int r = 0; r < PsiResources; r++) fds[r + 1] = {triggers.fds[r], POLLPRI, 0};
+
+    while (true) {
+        if (poll(fds, PsiResources + 1, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[0].revents) break;
+        for (int r = 0; r < PsiResources; r++) {
+            short revents = fds[r + 1].revents;
+            // POLLERR means the trigger was destroyed (the cgroup or file went away); stop watching it
+            if (revents & POLLERR) fds[r + 1].fd = -1;
+            else if (revents & POLLPRI) {
+                triggers.events[r]++;
+                triggers.lastEventMs[r] = systemClock()->wallMs();
+            }
+        }
+    }
+}
+
+bool startPsiTriggers(uint32_t stallUs, uint32_t windowUs) {
+    if (psiTriggersActive()) return true;
+    // The kernel only reports on the real host
+    if (isArchiveOpen() || !procRoot().empty()) {
+        triggers.status = "off (not the live host)";
+        return false;
+    }
+
+    char spec[64];
+    snprintf(spec, sizeof(spec), "some %u %u", stallUs, windowUs);
+    int registered = 0;
+    int error = 0;
+    for (int r = 0; r < PsiResources; r++) {
+        int fd = open(pressurePath(r).c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+        // The terminating nul is part of the trigger string
+        if (fd >= 0 && write(fd, spec, strlen(spec) + 1) < 0) {
+            error = errno;
+            close(fd);
+            fd = -1;
+        } else if (fd < 0) {
+            error = errno;
+        }
+        triggers.fds[r] = fd;
+        if (fd >= 0) registered++;
+    }
+
+    if (registered == 0) {
+        triggers.status = std::string("unavailable (") + strerror(error) + ")";
+        return false;
+    }
+    triggers.wakeFd = eventfd(0, EFD_CLOEXEC);
+    if (triggers.wakeFd < 0) {
+        stopPsiTriggers();
+        triggers.status = "unavailable (eventfd)";
+        return false;
+    }
+    char status[96];
+    snprintf(status, sizeof(status), "stalls of %u ms per %u ms window", stallUs / 1000, windowUs / 1000);
+    triggers.status = status;
+    triggers.thread = std::thread(triggerLoop);
+    return true;
+}
+
+void stopPsiTriggers() {
+    if (triggers.thread.joinable()) {
+        uint64_t one = 1;
+        if (write(triggers.wakeFd, &one, sizeof(one)) < 0) {}
+        triggers.thread.join();
+    }
+    if (triggers.wakeFd >= 0) close(triggers.wakeFd);
+    triggers.wakeFd = -1;
+    // Closing the file removes the trigger
+    for (int& fd : triggers.fds) {
+        if (fd >= 0) close(fd);
+        fd = -1;
+    }
+    triggers.status = "off";
+}
+
+bool psiTriggersActive() {
+    return triggers.thread.joinable();
+}
+
+// ------------------------------
+// READING
+// ------------------------------
+
+struct PsiFiles {
+    ProcHandle handles[PsiResources];
+    bool opened = false;
+    int64_t lastTimeMs = 0;
+    uint64_t lastSome[PsiResources] = {};
+    uint64_t lastFull[PsiResources] = {};
+};
+
+static PsiFiles files;
+
+static float fieldAfter(const char* line, const char* key) {
+    const char* p = strstr(line, key);
+    return p ? strtof(p + strlen(key), nullptr) : 0.0f;
+}
+
+// "some avg10=0.12 avg60=0.05 avg300=0.01 total=123456"
+static bool parseLine(const char* text, const char* prefix, PsiLine& line) {
+    const char* p = strstr(text, prefix);
+    if (!p) return false;
+    // Every line has all four keys, so the first match after the prefix is on this line
+    line.avg10 = fieldAfter(p, "avg10=");
+    line.avg60 = fieldAfter(p, "avg60=");
+    line.avg300 = fieldAfter(p, "avg300=");
+    const char* total = strstr(p, "total=");
+    line.totalUs = total ? strtoull(total + 6, nullptr, 10) : 0;
+    return true;
+}
+
+// Stalled microseconds over elapsed ms, as a percentage
+static float stallBetween(uint64_t last, uint64_t now, double intervalMs) {
+    if (intervalMs <= 0.0 || last == 0 || now < last) return 0.0f;
+    return std::min(100.0f, (float)((now - last) / (intervalMs * 10.0)));
+}
+
+PsiInfo readPsi(int64_t timeMs) {
+    PROFILE_ZONE("readPsi");
+    if (!files.opened) {
+        for (int r = 0; r < PsiResources; r++) procOpenHandle(pressurePath(r), files.handles[r]);
+        files.opened = true;
+    }
+
+    double intervalMs = files.lastTimeMs > 0 ? (double)(timeMs - files.lastTimeMs) : 0.0;
+    files.lastTimeMs = timeMs;
+
+    PsiInfo info;
+    static std::string buffer;
+    for (int r = 0; r < PsiResources; r++) {
+        PsiStats& stats = info.resources[r];
+        if (!procReadHandle(files.handles[r], buffer) || !parseLine(buffer.c_str(), "some ", stats.some)) {
+            files.lastSome[r] = files.lastFull[r] = 0;
+            continue;
+        }
+        stats.found = true;
+        stats.hasFull = parseLine(buffer.c_str(), "full ", stats.full);
+        stats.some.stallPercent = stallBetween(files.lastSome[r], stats.some.totalUs, intervalMs);
+        stats.full.stallPercent = stallBetween(files.lastFull[r], stats.full.totalUs, intervalMs);
+        files.lastSome[r] = stats.some.totalUs;
+        files.lastFull[r] = stats.full.totalUs;
+        stats.triggerEvents = triggers.events[r];
+    }
+    return info;
+}
+
+// ------------------------------
+// UI RENDERING FUNCTION FOR PRESSURE PANELS
+// ------------------------------
+
+// Ten minutes at the default sample interval
+static const int maxPsiSamples = 1200;
+
+struct PsiGraph {
+    PlotHistory some{maxPsiSamples};
+    PlotHistory full{maxPsiSamples};
+    uint64_t lastSequence = 0;
+    uint64_t lastEpoch = 0;
+};
+
+static PsiGraph graphs[PsiResources];
+
+void renderPsiPanel(PsiResource resource) {
+    PROFILE_ZONE("renderPsiPanel");
+    const PsiStats& stats = currentSnapshot().psi.resources[resource];
+    PsiGraph& graph = graphs[resource];
+
+    if (snapshotEpoch() != graph.lastEpoch) {
+        graph.lastEpoch = snapshotEpoch();
+        graph.some.clear();
+        graph.full.clear();
+    }
+    if (snapshotSequence() != graph.lastSequence) {
+        graph.lastSequence = snapshotSequence();
+        graph.some.push(stats.some.stallPercent);
+        graph.full.push(stats.full.stallPercent);
+    }
+
+    ImGui::PushID(resource);
+    ImGui::Separator();
+    if (!stats.found) {
+        ImGui::Text("No %s pressure data (/proc/pressure/%s needs CONFIG_PSI).", resourceNames[resource],
+                    resourceNames[resource]);
+        ImGui::PopID();
+        return;
+    }
+
+    ImGui::Text("%s pressure: some %.1f%%", resourceNames[resource], stats.some.stallPercent);
+    if (stats.hasFull) {
+        ImGui::SameLine();
+        ImGui::Text("full %.1f%%", stats.full.stallPercent);
+    }
+    ImGui::TextDisabled("avg10/60/300  some %.2f / %.2f / %.2f", stats.some.avg10, stats.some.avg60, stats.some.avg300);
+    if (stats.hasFull)
+        ImGui::TextDisabled("              full %.2f / %.2f / %.2f", stats.full.avg10, stats.full.avg60, stats.full.avg300);
+
+    char overlay[32];
+    snprintf(overlay, sizeof(overlay), "some %.1f%%", stats.some.stallPercent);
+    graph.some.plot("Stall % (some)", 0.0f, 100.0f, ImVec2(0, 50), overlay);
+    if (stats.hasFull) {
+        snprintf(overlay, sizeof(overlay), "full %.1f%%", stats.full.stallPercent);
+        graph.full.plot("Stall % (full)", 0.0f, 100.0f, ImVec2(0, 50), overlay);
+    }
+
+    // Trigger wake-ups are a live-host feature, so a replay shows only the recorded count
+    int64_t lastMs = triggers.lastEventMs[resource];
+    if (psiTriggersActive() && lastMs > 0 && !isReplaying())
+        ImGui::Text("Trigger: %llu stall events, last %.0f s ago (%s)", (unsigned long long)stats.triggerEvents,
+                    (systemClock()->wallMs() - lastMs) / 1000.0, triggers.status.c_str());
+    else
+        ImGui::Text("Trigger: %llu stall events (%s)", (unsigned long long)stats.triggerEvents, triggers.status.c_str());
+    ImGui::PopID();
+}
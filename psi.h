@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+
+// ------------------------------
+// PRESSURE STALL INFORMATION
+// ------------------------------
+//
+// From /proc/pressure/{cpu,memory,io}: the share of wall time in which some
+// (or all, "full") runnable tasks were stalled waiting for the resource.
+// The kernel's avg10/60/300 are running averages; stallPercent is computed
+// from the `total` counters over the sample interval.
+//
+// Triggers are the kernel's event interface on the same files: a background
+// thread registers "some <stall us> <window us>" on each one and poll()s for
+// POLLPRI, so a stall is counted the moment the kernel reports it instead of
+// at the next sample.
+
+enum PsiResource : uint8_t { PsiCpu, PsiMemory, PsiIo, PsiResources };
+
+struct PsiLine {
+    float avg10 = 0.0f;
+    float avg60 = 0.0f;
+    float avg300 = 0.0f;
+    uint64_t totalUs = 0;
+    float stallPercent = 0.0f;  // over the sample interval
+};
+
+struct PsiStats {
+    bool found = false;
+    bool hasFull = false;       // the cpu file only has a full line since 5.13
+    PsiLine some;
+    PsiLine full;
+    uint64_t triggerEvents = 0; // trigger wake-ups since triggers started
+};
+
+struct PsiInfo {
+    PsiStats resources[PsiResources];
+};
+
+const char* psiResourceName(PsiResource resource);
+
+// Reads the held pressure files; stallPercent is relative to the previous call's timeMs
+PsiInfo readPsi(int64_t timeMs);
+
+// Registers a trigger on every pressure file and polls them on a thread.
+// Unprivileged processes need a window that is a multiple of 2 s (Linux 6.5+)
+bool startPsiTriggers(uint32_t stallUs = 100000, uint32_t windowUs = 2000000);
+void stopPsiTriggers();
+bool psiTriggersActive();
+
+// some/full percentages, averages, trigger count and a stall graph for one resource
+void renderPsiPanel(PsiResource resource);
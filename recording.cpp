@@ -0,0 +1,1093 @@
+#include "snapshot.h"
+#include "encoding.h"
+#include "procfs.h"
+#include "profiler.h"
+#include <imgui.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/*
+Recording file layout:
+
+    header  : "SMRC" | u8 version
+    frame   : u8 kind | varint payloadLen | payload      (kind 1 = key, 2 = delta)
+    index   : u8 kind 3 | varint payloadLen | payload    (written on stop)
+    trailer : u64 index offset | "SMIX"
+
+Key frames hold a full snapshot. Delta frames store integer counters as
+zigzag varint differences to the previous frame and only the process rows
+and fields that changed. A key frame is written every keyframeInterval
+frames and the index lists their time and file offset, so a seek decodes at
+most keyframeInterval frames. Recordings without a trailer (the monitor was
+killed) are indexed by scanning the frame headers on open.
+
+Per-core CPU is stored as the share of each state in half-percent steps,
+one byte per state and core, rather than as raw counters.
+
+Versions, each adding to the one before; only the current one is read:
+    2   per-core CPU states
+    3   per-core frequency and idle-state residency
+    4   hardware inventory (vendor, kernel, topology, caches)
+    5   pressure stall information
+    6   scheduler load and run-queue delay
+    7   interrupt and softirq increments, source names when they change
+    8   perf counter increments per cpu
+    9   hypervisor and the steal time window
+    10  process CPU % as user and system shares
+    11  per-process I/O rates
+    12  smaps_rollup memory of the rows that had it
+    13  per-process threads, priority, last cpu, policy, fault and switch rates
+    14  threads of the expanded processes; the row field mask became a varint
+    15  cgroup tree (paths when the tree changes) and each process's cgroup
+*/
+
+static const char recordingMagic[4] = {'S', 'M', 'R', 'C'};
+static const uint8_t recordingVersion = 15;
+static const char indexMagic[4] = {'S', 'M', 'I', 'X'};
+static const int keyframeInterval = 64;
+
+enum FrameKind : uint8_t { FrameKey = 1, FrameDelta = 2, FrameIndex = 3 };
+
+// ------------------------------
+// SNAPSHOT CODEC
+// ------------------------------
+
+static long long int CPUStats::* const cpuFields[] = {
+    &CPUStats::user, &CPUStats::nice, &CPUStats::system, &CPUStats::idle, &CPUStats::iowait,
+    &CPUStats::irq, &CPUStats::softirq, &CPUStats::steal, &CPUStats::guest, &CPUStats::guestNice};
+
+static float CpuStates::* const stateFields[] = {
+    &CpuStates::user, &CpuStates::nice, &CpuStates::system, &CpuStates::iowait, &CpuStates::irq,
+    &CpuStates::softirq, &CpuStates::steal, &CpuStates::guest, &CpuStates::idle};
+
+static PsiLine PsiStats::* const psiLines[] = {&PsiStats::some, &PsiStats::full};
+
+static uint64_t CpuSched::* const schedCounters[] = {
+    &CpuSched::runTimeNs, &CpuSched::runDelayNs, &CpuSched::timeslices};
+
+static int TaskStats::* const taskFields[] = {
+    &TaskStats::total, &TaskStats::running, &TaskStats::sleeping,
+    &TaskStats::uninterruptible, &TaskStats::stopped, &TaskStats::zombie};
+
+static uint64_t NetStats::* const netFields[] = {
+    &NetStats::rx_bytes, &NetStats::rx_packets, &NetStats::rx_errs, &NetStats::rx_drop,
+    &NetStats::rx_fifo, &NetStats::rx_frame, &NetStats::rx_compressed, &NetStats::rx_multicast,
+    &NetStats::tx_bytes, &NetStats::tx_packets, &NetStats::tx_errs, &NetStats::tx_drop,
+    &NetStats::tx_fifo, &NetStats::tx_colls, &NetStats::tx_carrier, &NetStats::tx_compressed};
+
+// Which fields of a process row follow in a delta frame
+enum ProcessField : uint16_t {
+    ProcName = 1, ProcState = 2, ProcCpuTime = 4, ProcCpuPercent = 8, ProcMemPercent = 16, ProcIo = 32, ProcSmaps = 64,
+    ProcSched = 128, ProcThreads = 256, ProcCgroup = 512, ProcAll = 1023
+};
+
+static float ProcessIo::* const ioFields[] = {
+    &ProcessIo::readBytes, &ProcessIo::writeBytes, &ProcessIo::rchar,
+    &ProcessIo::wchar, &ProcessIo::syscr, &ProcessIo::syscw};
+
+static bool sameIo(const ProcessSample& a, const ProcessSample& b) {
+    if (a.ioFound != b.ioFound) return false;
+    for (auto f : ioFields)
+        if (a.io.*f != b.io.*f) return false;
+    return true;
+}
+
+static int ProcessSample::* const schedFields[] = {
+    &ProcessSample::threads, &ProcessSample::priority, &ProcessSample::nice,
+    &ProcessSample::processor, &ProcessSample::policy};
+
+static float ProcessSample::* const schedRates[] = {
+    &ProcessSample::minorFaults, &ProcessSample::majorFaults,
+    &ProcessSample::voluntarySwitches, &ProcessSample::involuntarySwitches};
+
+static bool sameSched(const ProcessSample& a, const ProcessSample& b) {
+    for (auto f : schedFields)
+        if (a.*f != b.*f) return false;
+    for (auto f : schedRates)
+        if (a.*f != b.*f) return false;
+    return true;
+}
+
+static bool sameThreads(const std::vector<ThreadSample>& a, const std::vector<ThreadSample>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++)
+        if (a[i].tid != b[i].tid || a[i].name != b[i].name || a[i].state != b[i].state ||
+            a[i].processor != b[i].processor || a[i].cpuTime != b[i].cpuTime ||
+            a[i].userPercent != b[i].userPercent || a[i].systemPercent != b[i].systemPercent)
+            return false;
+    return true;
+}
+
+static bool sameSmaps(const SmapsMemory& a, const SmapsMemory& b) {
+    return a.found == b.found && a.pssKB == b.pssKB && a.ussKB == b.ussKB && a.sharedKB == b.sharedKB &&
+           a.swapKB == b.swapKB;
+}
+
+static bool sameHost(const HostInfo& a, const HostInfo& b) {
+    if (a.caches.size() != b.caches.size()) return false;
+    for (size_t i = 0; i < a.caches.size(); ++i)
+        if (a.caches[i].level != b.caches[i].level || a.caches[i].type != b.caches[i].type ||
+            a.caches[i].sizeKB != b.caches[i].sizeKB || a.caches[i].sharedBy != b.caches[i].sharedBy)
+            return false;
+    return a.osName == b.osName && a.user == b.user && a.hostname == b.hostname && a.cpuModel == b.cpuModel &&
+           a.cpuVendor == b.cpuVendor && a.kernel == b.kernel && a.hypervisor == b.hypervisor && a.sockets == b.sockets && a.cores == b.cores &&
+           a.threads == b.threads && a.numaNodes == b.numaNodes && a.memTotalGB == b.memTotalGB;
+}
+
+static bool sameIrqLayout(const IrqInfo& a, const IrqInfo& b) {
+    if (a.cpus != b.cpus || a.sources.size() != b.sources.size()) return false;
+    for (size_t i = 0; i < a.sources.size(); ++i)
+        if (a.sources[i].name != b.sources[i].name || a.sources[i].label != b.sources[i].label ||
+            a.sources[i].soft != b.sources[i].soft)
+            return false;
+    return true;
+}
+
+static uint64_t CgroupStats::* const cgroupCounters[] = {
+    &CgroupStats::usageUsec, &CgroupStats::userUsec, &CgroupStats::systemUsec, &CgroupStats::periods,
+    &CgroupStats::throttledPeriods, &CgroupStats::throttledUsec, &CgroupStats::memoryBytes,
+    &CgroupStats::memoryMaxBytes, &CgroupStats::memoryHighEvents, &CgroupStats::memoryMaxEvents,
+    &CgroupStats::oomKills, &CgroupStats::ioReadBytes, &CgroupStats::ioWriteBytes, &CgroupStats::ioReads,
+    &CgroupStats::ioWrites, &CgroupStats::pids};
+
+static float CgroupStats::* const cgroupRates[] = {
+    &CgroupStats::cpuPercent, &CgroupStats::throttledPercent, &CgroupStats::ioReadRate, &CgroupStats::ioWriteRate};
+
+static bool sameCgroupTree(const std::vector<CgroupStats>& a, const std::vector<CgroupStats>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i)
+        if (a[i].path != b[i].path || a[i].depth != b[i].depth || a[i].hasMemory != b[i].hasMemory ||
+            a[i].hasPids != b[i].hasPids)
+            return false;
+    return true;
+}
+
+static bool sameInterfaces(const std::vector<NetInterface>& a, const std::vector<NetInterface>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i)
+        if (a[i].name != b[i].name || a[i].ipv4 != b[i].ipv4) return false;
+    return true;
+}
+
+static bool sameNetKeys(const std::map<std::string, NetStats>& a, const std::map<std::string, NetStats>& b) {
+    if (a.size() != b.size()) return false;
+    for (auto i = a.begin(), j = b.begin(); i != a.end(); ++i, ++j)
+        if (i->first != j->first) return false;
+    return true;
+}
+
+// Encodes `s`; prev == nullptr writes a key frame
+static void encodeSnapshot(const Snapshot& s, const Snapshot* prev, std::vector<uint8_t>& out) {
+    static const Snapshot empty;
+    const Snapshot& base = prev ? *prev : empty;
+
+    putSigned(out, s.timeMs - base.timeMs);
+
+    bool hostSame = prev && sameHost(s.host, base.host);
+    out.push_back(hostSame);
+    if (!hostSame) {
+        putString(out, s.host.osName);
+        putString(out, s.host.user);
+        putString(out, s.host.hostname);
+        putString(out, s.host.cpuModel);
+        putString(out, s.host.cpuVendor);
+        putString(out, s.host.kernel);
+        putString(out, s.host.hypervisor);
+        putVarint(out, s.host.sockets);
+        putVarint(out, s.host.cores);
+        putVarint(out, s.host.threads);
+        putVarint(out, s.host.numaNodes);
+        putFloat(out, s.host.memTotalGB);
+        putVarint(out, s.host.caches.size());
+        for (const CacheLevel& cache : s.host.caches) {
+            putVarint(out, cache.level);
+            putString(out, cache.type);
+            putVarint(out, cache.sizeKB);
+            putVarint(out, cache.sharedBy);
+        }
+    }
+
+    for (auto f : taskFields) putSigned(out, (int64_t)(s.tasks.*f) - (base.tasks.*f));
+    for (auto f : cpuFields) putSigned(out, (int64_t)(s.cpu.*f - base.cpu.*f));
+    putFloat(out, s.cpuPercent);
+    for (auto f : stateFields) putFloat(out, s.cpuStates.*f);
+    putVarint(out, s.coreStates.size());
+    for (const CpuStates& core : s.coreStates)
+        for (auto f : stateFields) out.push_back((uint8_t)std::lround(std::clamp(core.*f, 0.0f, 100.0f) * 2.0f));
+
+    putFloat(out, s.steal.windowSeconds);
+    putFloat(out, s.steal.percent);
+    putFloat(out, s.steal.guestPercent);
+    putVarint(out, s.steal.corePercent.size());
+    for (float percent : s.steal.corePercent) out.push_back((uint8_t)std::lround(std::clamp(percent, 0.0f, 100.0f) * 2.0f));
+    putSigned(out, s.steal.worstCore);
+    out.push_back(s.steal.noisyNeighbour);
+
+    // Frequencies in whole MHz, idle residency in half percent
+    out.push_back(s.freq.found);
+    if (s.freq.found) {
+        putVarint(out, s.freq.governors.size());
+        for (const std::string& g : s.freq.governors) putString(out, g);
+        putVarint(out, s.freq.idleStates.size());
+        for (const std::string& name : s.freq.idleStates) putString(out, name);
+        putFloat(out, s.freq.avgMHz);
+        putVarint(out, s.freq.cores.size());
+        for (const CoreFreq& core : s.freq.cores) {
+            putVarint(out, core.cpu);
+            putVarint(out, (uint64_t)std::lround(core.avgMHz));
+            putVarint(out, (uint64_t)std::lround(core.curMHz));
+            out.push_back(core.governor);
+            for (float pct : core.idlePercent) out.push_back((uint8_t)std::lround(std::clamp(pct, 0.0f, 100.0f) * 2.0f));
+        }
+    }
+
+    // Pressure totals as differences, like the /proc/stat counters
+    for (int r = 0; r < PsiResources; r++) {
+        const PsiStats& psi = s.psi.resources[r];
+        const PsiStats& old = base.psi.resources[r];
+        out.push_back(psi.found | psi.hasFull << 1);
+        if (!psi.found) continue;
+        for (auto l : psiLines) {
+            putFloat(out, (psi.*l).avg10);
+            putFloat(out, (psi.*l).avg60);
+            putFloat(out, (psi.*l).avg300);
+            putFloat(out, (psi.*l).stallPercent);
+            putSigned(out, (int64_t)((psi.*l).totalUs - (old.*l).totalUs));
+        }
+        putSigned(out, (int64_t)(psi.triggerEvents - old.triggerEvents));
+    }
+
+    // Scheduler counters as differences; per-cpu ones to the same row of the previous frame
+    out.push_back(s.sched.loadFound);
+    putFloat(out, s.sched.load1);
+    putFloat(out, s.sched.load5);
+    putFloat(out, s.sched.load15);
+    putVarint(out, s.sched.runnable);
+    putVarint(out, s.sched.threads);
+    putSigned(out, (int64_t)(s.sched.counters.ctxt - base.sched.counters.ctxt));
+    putSigned(out, (int64_t)(s.sched.counters.forks - base.sched.counters.forks));
+    putVarint(out, s.sched.counters.procsRunning);
+    putVarint(out, s.sched.counters.procsBlocked);
+    putFloat(out, s.sched.ctxtPerSec);
+    putFloat(out, s.sched.forksPerSec);
+    putFloat(out, s.sched.delayMsPerSec);
+    putFloat(out, s.sched.waitUs);
+    putVarint(out, s.sched.cpus.size());
+    for (size_t i = 0; i < s.sched.cpus.size(); ++i) {
+        const CpuSched& cpu = s.sched.cpus[i];
+        static const CpuSched none;
+        const CpuSched& old = i < base.sched.cpus.size() ? base.sched.cpus[i] : none;
+        putVarint(out, cpu.cpu);
+        for (auto f : schedCounters) putSigned(out, (int64_t)(cpu.*f - old.*f));
+        putFloat(out, cpu.delayMsPerSec);
+        putFloat(out, cpu.waitUs);
+    }
+
+    out.push_back(s.irq.found);
+    if (s.irq.found) {
+        putFloat(out, s.irq.intervalMs);
+        bool layoutSame = prev && sameIrqLayout(s.irq, base.irq);
+        out.push_back(layoutSame);
+        if (!layoutSame) {
+            putVarint(out, s.irq.cpus.size());
+            for (int cpu : s.irq.cpus) putVarint(out, cpu);
+            putVarint(out, s.irq.sources.size());
+            for (const IrqSource& source : s.irq.sources) {
+                putString(out, source.name);
+                putString(out, source.label);
+                out.push_back(source.soft);
+            }
+        }
+        for (const IrqSource& source : s.irq.sources) {
+            out.push_back(source.storm);
+            for (uint32_t d : source.deltas) putVarint(out, d);
+        }
+        putSigned(out, s.irq.netRxCpu);
+        putFloat(out, s.irq.netRxShare);
+        out.push_back(s.irq.netRxImbalance);
+    }
+
+    // Only the counters that were open are written
+    putString(out, s.perf.status);
+    out.push_back(s.perf.found);
+    if (s.perf.found) {
+        out.push_back(s.perf.available);
+        putFloat(out, s.perf.intervalMs);
+        putVarint(out, s.perf.cores.size());
+        for (const CorePerf& core : s.perf.cores) {
+            putVarint(out, core.cpu);
+            for (int c = 0; c < PerfCounters; c++)
+                if (s.perf.available & (1 << c)) putVarint(out, core.counts[c]);
+        }
+    }
+
+    // Counters are differences to the previous frame while the tree stays the same
+    out.push_back(s.cgroups.found);
+    if (s.cgroups.found) {
+        putFloat(out, s.cgroups.intervalMs);
+        bool treeSame = prev && sameCgroupTree(s.cgroups.groups, base.cgroups.groups);
+        out.push_back(treeSame);
+        if (!treeSame) {
+            putVarint(out, s.cgroups.groups.size());
+            for (const CgroupStats& g : s.cgroups.groups) {
+                putString(out, g.path);
+                putVarint(out, g.depth);
+                out.push_back(g.hasMemory | g.hasPids << 1);
+            }
+        }
+        for (size_t i = 0; i < s.cgroups.groups.size(); i++) {
+            const CgroupStats& g = s.cgroups.groups[i];
+            for (auto f : cgroupCounters)
+                putSigned(out, (int64_t)(g.*f - (treeSame ? base.cgroups.groups[i].*f : 0)));
+            for (auto f : cgroupRates) putFloat(out, g.*f);
+        }
+    }
+
+    putFloat(out, s.memUsedMB);
+    putFloat(out, s.memTotalMB);
+    putFloat(out, s.swap.usedMB);
+    putFloat(out, s.swap.totalMB);
+    putString(out, s.swap.errorMessage);
+
+    out.push_back(s.disk.ok);
+    putFloat(out, s.disk.usedPercent);
+    putFloat(out, s.disk.totalGB);
+    putFloat(out, s.disk.usedGB);
+    putFloat(out, s.disk.availGB);
+
+    // Interface counters as deltas when the interface set didn't change
+    bool netSame = prev && sameNetKeys(s.net, base.net);
+    out.push_back(netSame);
+    if (!netSame) putVarint(out, s.net.size());
+    auto prevNet = base.net.begin();
+    for (const auto& [iface, ns] : s.net) {
+        if (!netSame) putString(out, iface);
+        for (auto f : netFields) putSigned(out, (int64_t)(ns.*f - (netSame ? prevNet->second.*f : 0)));
+        if (netSame) ++prevNet;
+    }
+
+    bool ifSame = prev && sameInterfaces(s.interfaces, base.interfaces);
+    out.push_back(ifSame);
+    if (!ifSame) {
+        putVarint(out, s.interfaces.size());
+        for (const NetInterface& n : s.interfaces) {
+            putString(out, n.name);
+            putString(out, n.ipv4);
+        }
+    }
+
+    out.push_back(s.thermalFound);
+    putFloat(out, s.temperatureC);
+    out.push_back(s.fan.active);
+    putSigned(out, s.fan.speedRPM);
+    putSigned(out, s.fan.level);
+
+    // Processes: pid deltas, then only the fields that differ from the previous row
+    putVarint(out, s.processes.size());
+    size_t j = 0;
+    int lastPid = 0;
+    for (const ProcessSample& p : s.processes) {
+        while (j < base.processes.size() && base.processes[j].pid < p.pid) j++;
+        const ProcessSample* old = (j < base.processes.size() && base.processes[j].pid == p.pid) ? &base.processes[j] : nullptr;
+
+        uint16_t mask = ProcAll;
+        if (old) {
+            mask = 0;
+            if (p.name != old->name) mask |= ProcName;
+            if (p.state != old->state) mask |= ProcState;
+            if (p.cpuTime != old->cpuTime) mask |= ProcCpuTime;
+            if (p.userPercent != old->userPercent || p.systemPercent != old->systemPercent) mask |= ProcCpuPercent;
+            if (p.memPercent != old->memPercent) mask |= ProcMemPercent;
+            if (!sameIo(p, *old)) mask |= ProcIo;
+            if (!sameSmaps(p.smaps, old->smaps)) mask |= ProcSmaps;
+            if (!sameSched(p, *old)) mask |= ProcSched;
+            if (!sameThreads(p.tasks, old->tasks)) mask |= ProcThreads;
+            if (p.cgroup != old->cgroup) mask |= ProcCgroup;
+        }
+
+        putVarint(out, (uint64_t)(p.pid - lastPid));
+        lastPid = p.pid;
+        putVarint(out, mask);
+        if (mask & ProcName) putString(out, p.name);
+        if (mask & ProcState) out.push_back((uint8_t)p.state);
+        if (mask & ProcCpuTime) putSigned(out, (int64_t)(p.cpuTime - (old ? old->cpuTime : 0)));
+        if (mask & ProcCpuPercent) {
+            putFloat(out, p.userPercent);
+            putFloat(out, p.systemPercent);
+        }
+        if (mask & ProcMemPercent) putFloat(out, p.memPercent);
+        if (mask & ProcIo) {
+            out.push_back(p.ioFound);
+            if (p.ioFound)
+                for (auto f : ioFields) putFloat(out, p.io.*f);
+        }
+        if (mask & ProcSmaps) {
+            out.push_back(p.smaps.found);
+            if (p.smaps.found) {
+                putVarint(out, p.smaps.pssKB);
+                putVarint(out, p.smaps.ussKB);
+                putVarint(out, p.smaps.sharedKB);
+                putVarint(out, p.smaps.swapKB);
+            }
+        }
+        if (mask & ProcSched) {
+            for (auto f : schedFields) putSigned(out, p.*f);
+            for (auto f : schedRates) putFloat(out, p.*f);
+        }
+        if (mask & ProcThreads) {
+            putVarint(out, p.tasks.size());
+            int lastTid = 0;
+            for (const ThreadSample& t : p.tasks) {
+                putVarint(out, (uint64_t)(t.tid - lastTid));
+                lastTid = t.tid;
+                putString(out, t.name);
+                out.push_back((uint8_t)t.state);
+                putSigned(out, t.processor);
+                putVarint(out, t.cpuTime);
+                putFloat(out, t.userPercent);
+                putFloat(out, t.systemPercent);
+            }
+        }
+        if (mask & ProcCgroup) putString(out, p.cgroup);
+    }
+}
+
+// Decodes a frame written by encodeSnapshot with the same `prev`
+static bool decodeSnapshot(Cursor& in, const Snapshot* prev, Snapshot& s) {
+    static const Snapshot empty;
+    const Snapshot& base = prev ? *prev : empty;
+
+    s.timeMs = base.timeMs + in.svarint();
+
+    if (in.byte()) {
+        s.host = base.host;
+    } else {
+        s.host.osName = in.str();
+        s.host.user = in.str();
+        s.host.hostname = in.str();
+        s.host.cpuModel = in.str();
+        s.host.cpuVendor = in.str();
+        s.host.kernel = in.str();
+        s.host.hypervisor = in.str();
+        s.host.sockets = (int)in.varint();
+        s.host.cores = (int)in.varint();
+        s.host.threads = (int)in.varint();
+        s.host.numaNodes = (int)in.varint();
+        s.host.memTotalGB = in.f32();
+        uint64_t caches = in.varint();
+        s.host.caches.clear();
+        for (uint64_t i = 0; i < caches && in.ok; ++i) {
+            CacheLevel cache;
+            cache.level = (int)in.varint();
+            cache.type = in.str();
+            cache.sizeKB = (int)in.varint();
+            cache.sharedBy = (int)in.varint();
+            s.host.caches.push_back(cache);
+        }
+    }
+
+    for (auto f : taskFields) s.tasks.*f = (int)((base.tasks.*f) + in.svarint());
+    for (auto f : cpuFields) s.cpu.*f = base.cpu.*f + in.svarint();
+    s.cpuPercent = in.f32();
+    for (auto f : stateFields) s.cpuStates.*f = in.f32();
+    uint64_t cores = in.varint();
+    s.coreStates.clear();
+    for (uint64_t i = 0; i < cores && in.ok; ++i) {
+        CpuStates core;
+        for (auto f : stateFields) core.*f = in.byte() / 2.0f;
+        s.coreStates.push_back(core);
+    }
+
+    s.steal = StealInfo();
+    s.steal.windowSeconds = in.f32();
+    s.steal.percent = in.f32();
+    s.steal.guestPercent = in.f32();
+    uint64_t stealCores = in.varint();
+    for (uint64_t i = 0; i < stealCores && in.ok; ++i) s.steal.corePercent.push_back(in.byte() / 2.0f);
+    s.steal.worstCore = (int)in.svarint();
+    s.steal.noisyNeighbour = in.byte();
+
+    s.freq = CpuFreqInfo();
+    s.freq.found = in.byte();
+    if (s.freq.found) {
+        uint64_t n = in.varint();
+        for (uint64_t i = 0; i < n && in.ok; ++i) s.freq.governors.push_back(in.str());
+        n = in.varint();
+        for (uint64_t i = 0; i < n && in.ok; ++i) s.freq.idleStates.push_back(in.str());
+        s.freq.avgMHz = in.f32();
+        n = in.varint();
+        for (uint64_t i = 0; i < n && in.ok; ++i) {
+            CoreFreq core;
+            core.cpu = (int)in.varint();
+            core.avgMHz = (float)in.varint();
+            core.curMHz = (float)in.varint();
+            core.governor = in.byte();
+            core.idlePercent.resize(s.freq.idleStates.size());
+            for (float& pct : core.idlePercent) pct = in.byte() / 2.0f;
+            s.freq.cores.push_back(std::move(core));
+        }
+    }
+
+    for (int r = 0; r < PsiResources; r++) {
+        PsiStats& psi = s.psi.resources[r];
+        const PsiStats& old = base.psi.resources[r];
+        uint8_t flags = in.byte();
+        psi = PsiStats();
+        psi.found = flags & 1;
+        psi.hasFull = flags & 2;
+        if (!psi.found) continue;
+        for (auto l : psiLines) {
+            (psi.*l).avg10 = in.f32();
+            (psi.*l).avg60 = in.f32();
+            (psi.*l).avg300 = in.f32();
+            (psi.*l).stallPercent = in.f32();
+            (psi.*l).totalUs = (old.*l).totalUs + in.svarint();
+        }
+        psi.triggerEvents = old.triggerEvents + in.svarint();
+    }
+
+    s.sched = SchedInfo();
+    s.sched.loadFound = in.byte();
+    s.sched.load1 = in.f32();
+    s.sched.load5 = in.f32();
+    s.sched.load15 = in.f32();
+    s.sched.runnable = (int)in.varint();
+    s.sched.threads = (int)in.varint();
+    s.sched.counters.ctxt = base.sched.counters.ctxt + in.svarint();
+    s.sched.counters.forks = base.sched.counters.forks + in.svarint();
+    s.sched.counters.procsRunning = (int)in.varint();
+    s.sched.counters.procsBlocked = (int)in.varint();
+    s.sched.ctxtPerSec = in.f32();
+    s.sched.forksPerSec = in.f32();
+    s.sched.delayMsPerSec = in.f32();
+    s.sched.waitUs = in.f32();
+    uint64_t schedCpus = in.varint();
+    for (uint64_t i = 0; i < schedCpus && in.ok; ++i) {
+        static const CpuSched none;
+        const CpuSched& old = i < base.sched.cpus.size() ? base.sched.cpus[i] : none;
+        CpuSched cpu;
+        cpu.cpu = (int)in.varint();
+        for (auto f : schedCounters) cpu.*f = old.*f + in.svarint();
+        cpu.delayMsPerSec = in.f32();
+        cpu.waitUs = in.f32();
+        s.sched.cpus.push_back(cpu);
+    }
+    s.sched.schedstatFound = !s.sched.cpus.empty();
+
+    s.irq = IrqInfo();
+    s.irq.found = in.byte();
+    if (s.irq.found) {
+        s.irq.intervalMs = in.f32();
+        if (in.byte()) {
+            s.irq.cpus = base.irq.cpus;
+            for (const IrqSource& old : base.irq.sources) {
+                IrqSource source;
+                source.name = old.name;
+                source.label = old.label;
+                source.soft = old.soft;
+                s.irq.sources.push_back(std::move(source));
+            }
+        } else {
+            uint64_t n = in.varint();
+            for (uint64_t i = 0; i < n && in.ok; ++i) s.irq.cpus.push_back((int)in.varint());
+            n = in.varint();
+            for (uint64_t i = 0; i < n && in.ok; ++i) {
+                IrqSource source;
+                source.name = in.str();
+                source.label = in.str();
+                source.soft = in.byte();
+                s.irq.sources.push_back(std::move(source));
+            }
+        }
+        for (IrqSource& source : s.irq.sources) {
+            source.storm = in.byte();
+            source.deltas.resize(s.irq.cpus.size());
+            for (uint32_t& d : source.deltas) {
+                d = (uint32_t)in.varint();
+                source.total += d;
+            }
+        }
+        s.irq.netRxCpu = (int)in.svarint();
+        s.irq.netRxShare = in.f32();
+        s.irq.netRxImbalance = in.byte();
+    }
+
+    s.perf = PerfInfo();
+    s.perf.status = in.str();
+    s.perf.found = in.byte();
+    if (s.perf.found) {
+        s.perf.available = in.byte();
+        s.perf.intervalMs = in.f32();
+        uint64_t n = in.varint();
+        for (uint64_t i = 0; i < n && in.ok; ++i) {
+            CorePerf core;
+            core.cpu = (int)in.varint();
+            for (int c = 0; c < PerfCounters; c++)
+                if (s.perf.available & (1 << c)) core.counts[c] = in.varint();
+            s.perf.cores.push_back(core);
+        }
+    }
+
+    s.cgroups = CgroupInfo();
+    s.cgroups.found = in.byte();
+    if (s.cgroups.found) {
+        s.cgroups.intervalMs = in.f32();
+        bool treeSame = in.byte();
+        if (treeSame) {
+            s.cgroups.groups = base.cgroups.groups;
+        } else {
+            uint64_t n = in.varint();
+            for (uint64_t i = 0; i < n && in.ok; ++i) {
+                CgroupStats g;
+                g.path = in.str();
+                g.depth = (int)in.varint();
+                uint8_t flags = in.byte();
+                g.hasMemory = flags & 1;
+                g.hasPids = flags & 2;
+                s.cgroups.groups.push_back(std::move(g));
+            }
+        }
+        for (CgroupStats& g : s.cgroups.groups) {
+            for (auto f : cgroupCounters) g.*f = (treeSame ? g.*f : 0) + in.svarint();
+            for (auto f : cgroupRates) g.*f = in.f32();
+        }
+    }
+
+    s.memUsedMB = in.f32();
+    s.memTotalMB = in.f32();
+    s.swap.usedMB = in.f32();
+    s.swap.totalMB = in.f32();
+    s.swap.errorMessage = in.str();
+
+    s.disk.ok = in.byte();
+    s.disk.usedPercent = in.f32();
+    s.disk.totalGB = in.f32();
+    s.disk.usedGB = in.f32();
+    s.disk.availGB = in.f32();
+
+    s.net.clear();
+    if (in.byte()) {
+        for (const auto& [iface, old] : base.net) {
+            NetStats ns;
+            for (auto f : netFields) ns.*f = old.*f + in.svarint();
+            s.net[iface] = ns;
+        }
+    } else {
+        uint64_t n = in.varint();
+        for (uint64_t i = 0; i < n && in.ok; ++i) {
+            std::string iface = in.str();
+            NetStats ns;
+            for (auto f : netFields) ns.*f = in.svarint();
+            s.net[iface] = ns;
+        }
+    }
+
+    if (in.byte()) {
+        s.interfaces = base.interfaces;
+    } else {
+        s.interfaces.clear();
+        uint64_t n = in.varint();
+        for (uint64_t i = 0; i < n && in.ok; ++i) {
+            NetInterface ni;
+            ni.name = in.str();
+            ni.ipv4 = in.str();
+            s.interfaces.push_back(ni);
+        }
+    }
+
+    s.thermalFound = in.byte();
+    s.temperatureC = in.f32();
+    s.fan.active = in.byte();
+    s.fan.speedRPM = (int)in.svarint();
+    s.fan.level = (int)in.svarint();
+
+    uint64_t count = in.varint();
+    s.processes.clear();
+    s.processes.reserve(count);
+    size_t j = 0;
+    int pid = 0;
+    for (uint64_t i = 0; i < count && in.ok; ++i) {
+        ProcessSample p;
+        pid += (int)in.varint();
+        p.pid = pid;
+        while (j < base.processes.size() && base.processes[j].pid < pid) j++;
+        if (j < base.processes.size() && base.processes[j].pid == pid) p = base.processes[j];
+
+        uint16_t mask = (uint16_t)in.varint();
+        if (mask & ProcName) p.name = in.str();
+        if (mask & ProcState) p.state = (char)in.byte();
+        if (mask & ProcCpuTime) p.cpuTime += in.svarint();
+        if (mask & ProcCpuPercent) {
+            p.userPercent = in.f32();
+            p.systemPercent = in.f32();
+            p.cpuPercent = p.userPercent + p.systemPercent;
+        }
+        if (mask & ProcMemPercent) p.memPercent = in.f32();
+        if (mask & ProcIo) {
+            p.ioFound = in.byte();
+            p.io = ProcessIo();
+            if (p.ioFound)
+                for (auto f : ioFields) p.io.*f = in.f32();
+        }
+        if (mask & ProcSmaps) {
+            p.smaps = SmapsMemory();
+            p.smaps.found = in.byte();
+            if (p.smaps.found) {
+                p.smaps.pssKB = in.varint();
+                p.smaps.ussKB = in.varint();
+                p.smaps.sharedKB = in.varint();
+                p.smaps.swapKB = in.varint();
+            }
+        }
+        if (mask & ProcSched) {
+            for (auto f : schedFields) p.*f = (int)in.svarint();
+            for (auto f : schedRates) p.*f = in.f32();
+        }
+        if (mask & ProcThreads) {
+            uint64_t threads = in.varint();
+            p.tasks.clear();
+            int tid = 0;
+            for (uint64_t k = 0; k < threads && in.ok; k++) {
+                ThreadSample t;
+                tid += (int)in.varint();
+                t.tid = tid;
+                t.name = in.str();
+                t.state = (char)in.byte();
+                t.processor = (int)in.svarint();
+                t.cpuTime = in.varint();
+                t.userPercent = in.f32();
+                t.systemPercent = in.f32();
+                t.cpuPercent = t.userPercent + t.systemPercent;
+                p.tasks.push_back(std::move(t));
+            }
+        }
+        if (mask & ProcCgroup) p.cgroup = in.str();
+        s.processes.push_back(std::move(p));
+    }
+    return in.ok;
+}
+
+// ------------------------------
+// RECORDING
+// ------------------------------
+
+struct KeyframeEntry {
+    int64_t timeMs;
+    uint64_t offset;
+};
+
+struct Recorder {
+    FILE* file = nullptr;
+    std::string path;
+    uint64_t offset = 0;
+    uint64_t frames = 0;
+    int64_t lastTimeMs = 0;
+    Snapshot prev;
+    std::vector<KeyframeEntry> index;
+    std::vector<uint8_t> buffer;
+};
+
+static Recorder recorder;
+
+bool startRecording(const std::string& path) {
+    stopRecording();
+    recorder.file = fopen(path.c_str(), "wb");
+    if (!recorder.file) return false;
+
+    fwrite(recordingMagic, 1, 4, recorder.file);
+    fwrite(&recordingVersion, 1, 1, recorder.file);
+    recorder.path = path;
+    recorder.offset = 5;
+    recorder.frames = 0;
+    recorder.index.clear();
+    return true;
+}
+
+bool isRecording() {
+    return recorder.file != nullptr;
+}
+
+static void writeFrame(FrameKind kind, const std::vector<uint8_t>& payload) {
+    std::vector<uint8_t> header;
+    header.push_back(kind);
+    putVarint(header, payload.size());
+    fwrite(header.data(), 1, header.size(), recorder.file);
+    fwrite(payload.data(), 1, payload.size(), recorder.file);
+    recorder.offset += header.size() + payload.size();
+}
+
+void recordSnapshot(const Snapshot& snap) {
+    PROFILE_ZONE("recordSnapshot");
+    if (!recorder.file) return;
+
+    bool key = recorder.frames % keyframeInterval == 0;
+    if (key) recorder.index.push_back({snap.timeMs, recorder.offset});
+
+    recorder.buffer.clear();
+    encodeSnapshot(snap, key ? nullptr : &recorder.prev, recorder.buffer);
+    writeFrame(key ? FrameKey : FrameDelta, recorder.buffer);
+
+    // Flush at key frames so a crash loses at most one key interval
+    if (key) fflush(recorder.file);
+
+    recorder.prev = snap;
+    recorder.lastTimeMs = snap.timeMs;
+    recorder.frames++;
+}
+
+void stopRecording() {
+    if (!recorder.file) return;
+
+    // Index: end time, then (time, offset) of every key frame as deltas
+    uint64_t indexOffset = recorder.offset;
+    std::vector<uint8_t> payload;
+    putSigned(payload, recorder.lastTimeMs);
+    putVarint(payload, recorder.index.size());
+    int64_t lastTime = 0;
+    uint64_t lastOffset = 0;
+    for (const KeyframeEntry& k : recorder.index) {
+        putSigned(payload, k.timeMs - lastTime);
+        putVarint(payload, k.offset - lastOffset);
+        lastTime = k.timeMs;
+        lastOffset = k.offset;
+    }
+    writeFrame(FrameIndex, payload);
+    fwrite(&indexOffset, 1, 8, recorder.file);
+    fwrite(indexMagic, 1, 4, recorder.file);
+
+    fclose(recorder.file);
+    recorder.file = nullptr;
+}
+
+// ------------------------------
+// REPLAY
+// ------------------------------
+
+struct Replay {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    std::string path;
+    std::vector<KeyframeEntry> index;
+    int64_t startMs = 0;
+    int64_t endMs = 0;
+
+    uint64_t nextOffset = 0;      // next frame to decode
+    bool haveCurrent = false;
+    Snapshot current;
+
+    double positionMs = 0.0;      // replay clock
+    bool playing = true;
+    float speed = 1.0f;
+    bool seekPending = false;
+};
+
+static Replay replay;
+
+bool isReplaying() {
+    return replay.data != nullptr;
+}
+
+// Frame header at `offset`; returns false at the end of the frames
+static bool readFrameHeader(uint64_t offset, uint8_t& kind, Cursor& payload) {
+    Cursor in{replay.data + offset, replay.data + replay.size};
+    kind = in.byte();
+    uint64_t len = in.varint();
+    if (!in.ok || (kind != FrameKey && kind != FrameDelta) || (uint64_t)(in.end - in.p) < len) return false;
+    payload = Cursor{in.p, in.p + len};
+    return true;
+}
+
+static bool loadIndex() {
+    // Index written by stopRecording
+    if (replay.size >= 17 && memcmp(replay.data + replay.size - 4, indexMagic, 4) == 0) {
+        uint64_t indexOffset;
+        memcpy(&indexOffset, replay.data + replay.size - 12, 8);
+        // A truncated or corrupt file can still end in the magic, so the offsets are
+        // checked before use: the index and every frame lie between the header and the trailer
+        bool inside = indexOffset >= 5 && indexOffset < replay.size - 12;
+        Cursor in{replay.data + (inside ? indexOffset : 0), replay.data + replay.size - 12};
+        if (inside && in.byte() == FrameIndex) {
+            in.varint();
+            replay.endMs = in.svarint();
+            uint64_t n = in.varint();
+            int64_t time = 0;
+            uint64_t offset = 0;
+            for (uint64_t i = 0; i < n && in.ok; ++i) {
+                time += in.svarint();
+                offset += in.varint();
+                if (offset < 5 || offset >= indexOffset) in.ok = false;
+                replay.index.push_back({time, offset});
+            }
+            if (in.ok && !replay.index.empty()) return true;
+        }
+        replay.index.clear();
+    }
+
+    // No trailer, or a bad one: walk the frame headers, decoding only the time field
+    uint64_t offset = 5;
+    int64_t time = 0;
+    uint8_t kind;
+    Cursor payload{nullptr, nullptr};
+    while (offset < replay.size && readFrameHeader(offset, kind, payload)) {
+        int64_t t = payload.svarint();
+        time = kind == FrameKey ? t : time + t;
+        if (kind == FrameKey) replay.index.push_back({time, offset});
+        replay.endMs = time;
+        offset = payload.end - replay.data;
+    }
+    return !replay.index.empty();
+}
+
+bool openReplay(const std::string& path) {
+    if (replay.data) munmap((void*)replay.data, replay.size);
+    replay = Replay();
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < 5) {
+        close(fd);
+        return false;
+    }
+    void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return false;
+
+    replay.data = (const uint8_t*)p;
+    replay.size = st.st_size;
+    if (memcmp(replay.data, recordingMagic, 4) != 0 || replay.data[4] != recordingVersion || !loadIndex()) {
+        munmap(p, st.st_size);
+        replay = Replay();
+        return false;
+    }
+
+    replay.path = path;
+    replay.startMs = replay.index.front().timeMs;
+    replay.positionMs = replay.startMs;
+    replay.nextOffset = replay.index.front().offset;
+    return true;
+}
+
+// Decodes the next frame if it is due at the replay position
+static bool stepReplay() {
+    uint8_t kind;
+    Cursor payload{nullptr, nullptr};
+    if (replay.nextOffset >= replay.size || !readFrameHeader(replay.nextOffset, kind, payload)) return false;
+
+    // Peek the frame time before decoding the whole frame
+    Cursor peek = payload;
+    int64_t t = peek.svarint();
+    int64_t time = kind == FrameKey ? t : replay.current.timeMs + t;
+    if (time > replay.positionMs || (kind == FrameDelta && !replay.haveCurrent)) return false;
+
+    Snapshot next;
+    if (!decodeSnapshot(payload, kind == FrameKey ? nullptr : &replay.current, next)) return false;
+    replay.current = std::move(next);
+    replay.haveCurrent = true;
+    replay.nextOffset = payload.end - replay.data;
+    return true;
+}
+
+// Restarts decoding from the last key frame at or before positionMs
+static void seekReplay() {
+    auto it = std::upper_bound(replay.index.begin(), replay.index.end(), (int64_t)replay.positionMs,
+                               [](int64_t t, const KeyframeEntry& k) { return t < k.timeMs; });
+    if (it != replay.index.begin()) --it;
+    replay.nextOffset = it->offset;
+    replay.haveCurrent = false;
+}
+
+bool advanceReplay(double dtSeconds, Snapshot& out, bool& jumped) {
+    if (!replay.data) return false;
+
+    jumped = replay.seekPending;
+    if (replay.seekPending) {
+        replay.seekPending = false;
+        seekReplay();
+    } else if (replay.playing) {
+        replay.positionMs += dtSeconds * 1000.0 * replay.speed;
+        if (replay.positionMs >= replay.endMs) {
+            replay.positionMs = replay.endMs;
+            replay.playing = false;
+        }
+    }
+
+    bool changed = false;
+    while (stepReplay()) changed = true;
+    if (changed) out = replay.current;
+    return changed;
+}
+
+// ------------------------------
+// UI RENDERING FUNCTION FOR RECORD/REPLAY WINDOW
+// ------------------------------
+
+void renderReplayWindow(const char* id, ImVec2 size, ImVec2 position) {
+    PROFILE_ZONE("renderReplayWindow");
+    if (!isRecording() && !isReplaying() && !isCapturing() && !isArchiveOpen()) return;
+
+    ImGui::SetNextWindowSize(size, ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowPos(position, ImGuiCond_FirstUseEver);
+
+    if (!ImGui::Begin(id)) {
+        ImGui::End();
+        return;
+    }
+
+    if (isCapturing()) {
+        ImGui::TextColored(ImVec4(1, 0.3f, 0.3f, 1), "Capturing raw /proc and /sys reads");
+        ImGui::Text("Rounds: %llu  Size: %.2f MB", (unsigned long long)captureRounds(),
+                    captureBytes() / (1024.0 * 1024.0));
+        if (ImGui::Button("Stop Capture")) stopCapture();
+    }
+
+    if (isArchiveOpen()) {
+        ImGui::Text("Collectors read a capture archive: round %zu / %zu",
+                    archiveRoundIndex() + 1, archiveRoundCount());
+    }
+
+    if (isRecording()) {
+        ImGui::TextColored(ImVec4(1, 0.3f, 0.3f, 1), "Recording to %s", recorder.path.c_str());
+        ImGui::Text("Frames: %llu  Size: %.2f MB", (unsigned long long)recorder.frames,
+                    recorder.offset / (1024.0 * 1024.0));
+        if (ImGui::Button("Stop Recording")) stopRecording();
+        ImGui::End();
+        return;
+    }
+
+    if (!isReplaying()) {
+        ImGui::End();
+        return;
+    }
+
+    ImGui::Text("Replaying %s", replay.path.c_str());
+
+    if (ImGui::Button(replay.playing ? "Pause" : "Play")) {
+        if (!replay.playing && replay.positionMs >= replay.endMs) {
+            replay.positionMs = replay.startMs; // play again from the start
+            replay.seekPending = true;
+        }
+        replay.playing = !replay.playing;
+    }
+    ImGui::SameLine();
+    ImGui::SliderFloat("Speed", &replay.speed, 0.25f, 64.0f, "%.2fx", ImGuiSliderFlags_Logarithmic);
+
+    float seconds = (float)((replay.positionMs - replay.startMs) / 1000.0);
+    float total = (float)((replay.endMs - replay.startMs) / 1000.0);
+    if (ImGui::SliderFloat("Position (s)", &seconds, 0.0f, total, "%.1f s")) {
+        replay.positionMs = replay.startMs + seconds * 1000.0;
+        replay.seekPending = true;
+    }
+
+    time_t shown = (time_t)(replay.current.timeMs / 1000);
+    char when[64];
+    strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", localtime(&shown));
+    ImGui::Text("Snapshot time: %s", replay.haveCurrent ? when : "-");
+
+    ImGui::End();
+}
@@ -0,0 +1,199 @@
+#include "scheduler.h"
+#include "plot.h"
+#include "procfs.h"
+#include "profiler.h"
+#include "snapshot.h"
+#include <imgui.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+// ------------------------------
+// READING
+// ------------------------------
+
+struct SchedFiles {
+    ProcHandle loadavg;
+    ProcHandle schedstat;
+    bool opened = false;
+    int64_t lastTimeMs = 0;
+    ProcStatCounters lastCounters = {};
+    std::vector<CpuSched> lastCpus;
+};
+
+static SchedFiles files;
+
+// "0.52 0.58 0.59 4/712 12345"
+static bool parseLoadavg(const char* p, SchedInfo& info) {
+    char* end;
+    info.load1 = strtof(p, &end);
+    if (end == p) return false;
+    info.load5 = strtof(end, &end);
+    info.load15 = strtof(end, &end);
+    info.runnable = (int)strtol(end, &end, 10);
+    if (*end == '/') info.threads = (int)strtol(end + 1, &end, 10);
+    return true;
+}
+
+// "cpuN yld_count sched_switch sched_count sched_goidle ttwu_count ttwu_local run_time run_delay pcount";
+// the domain lines in between are skipped
+static void parseSchedstat(const char* line, std::vector<CpuSched>& cpus) {
+    while (line && *line) {
+        if (strncmp(line, "cpu", 3) == 0) {
+            char* end;
+            CpuSched cpu;
+            cpu.cpu = (int)strtol(line + 3, &end, 10);
+            const char* p = end;
+            uint64_t fields[9] = {};
+            int n = 0;
+            for (; n < 9; n++) {
+                fields[n] = strtoull(p, &end, 10);
+                if (end == p) break;
+                p = end;
+            }
+            if (n == 9) {
+                cpu.runTimeNs = fields[6];
+                cpu.runDelayNs = fields[7];
+                cpu.timeslices = fields[8];
+                cpus.push_back(cpu);
+            }
+        }
+        line = strchr(line, '\n');
+        if (line) line++;
+    }
+}
+
+// Counter difference per second; 0 across a reset or without an interval
+static float ratePerSec(uint64_t last, uint64_t now, double intervalMs) {
+    if (intervalMs <= 0.0 || last == 0 || now < last) return 0.0f;
+    return (float)((now - last) * 1000.0 / intervalMs);
+}
+
+SchedInfo readSched(const ProcStatCounters& counters, int64_t timeMs) {
+    PROFILE_ZONE("readSched");
+    // Held open; a read of schedstat still runs to the end, past the first few KB of cpus
+    if (!files.opened) {
+        procOpenHandle("/proc/loadavg", files.loadavg);
+        procOpenHandle("/proc/schedstat", files.schedstat);
+        files.opened = true;
+    }
+
+    double intervalMs = files.lastTimeMs > 0 ? (double)(timeMs - files.lastTimeMs) : 0.0;
+    files.lastTimeMs = timeMs;
+
+    SchedInfo info;
+    static std::string buffer;
+    if (procReadHandle(files.loadavg, buffer)) info.loadFound = parseLoadavg(buffer.c_str(), info);
+
+    info.counters = counters;
+    info.ctxtPerSec = ratePerSec(files.lastCounters.ctxt, counters.ctxt, intervalMs);
+    info.forksPerSec = ratePerSec(files.lastCounters.forks, counters.forks, intervalMs);
+    files.lastCounters = counters;
+
+    info.cpus.reserve(files.lastCpus.size());
+    if (procReadHandle(files.schedstat, buffer)) parseSchedstat(buffer.c_str(), info.cpus);
+    info.schedstatFound = !info.cpus.empty();
+
+    uint64_t delayNs = 0, slices = 0;
+    for (size_t i = 0; i < info.cpus.size(); i++) {
+        CpuSched& cpu = info.cpus[i];
+        if (i >= files.lastCpus.size() || files.lastCpus[i].cpu != cpu.cpu) continue;
+        const CpuSched& last = files.lastCpus[i];
+        // ns per second of wall time, as ms per second
+        cpu.delayMsPerSec = ratePerSec(last.runDelayNs, cpu.runDelayNs, intervalMs) / 1e6f;
+        if (cpu.runDelayNs >= last.runDelayNs && cpu.timeslices > last.timeslices) {
+            uint64_t d = cpu.runDelayNs - last.runDelayNs, n = cpu.timeslices - last.timeslices;
+            cpu.waitUs = (float)(d / 1000.0 / n);
+            delayNs += d;
+            slices += n;
+        }
+        info.delayMsPerSec += cpu.delayMsPerSec;
+    }
+    if (slices > 0) info.waitUs = (float)(delayNs / 1000.0 / slices);
+    files.lastCpus = info.cpus;
+    return info;
+}
+
+// ------------------------------
+// UI RENDERING FUNCTION FOR SCHEDULER PANEL
+// ------------------------------
+
+// Ten minutes at the default sample interval
+static const int maxSchedSamples = 1200;
+
+static PlotHistory loadHistory(maxSchedSamples);
+static PlotHistory delayHistory(maxSchedSamples);
+static float loadScale = 1.0f;
+static float delayScale = 10.0f;
+static uint64_t lastSchedSequence = 0;
+static uint64_t lastSchedEpoch = 0;
+
+void renderSchedPanel() {
+    PROFILE_ZONE("renderSchedPanel");
+    const Snapshot& snap = currentSnapshot();
+    const SchedInfo& sched = snap.sched;
+
+    if (snapshotEpoch() != lastSchedEpoch) {
+        lastSchedEpoch = snapshotEpoch();
+        loadHistory.clear();
+        delayHistory.clear();
+    }
+    if (snapshotSequence() != lastSchedSequence) {
+        lastSchedSequence = snapshotSequence();
+        loadHistory.push(sched.load1);
+        delayHistory.push(sched.delayMsPerSec);
+    }
+
+    if (sched.loadFound)
+        ImGui::Text("Load average: %.2f %.2f %.2f  (%d runnable of %d tasks)", sched.load1, sched.load5, sched.load15,
+                    sched.runnable, sched.threads);
+
+    // More runnable tasks than cpus means something is waiting for a cpu
+    int cpus = std::max(1, snap.host.threads);
+    float queue = (float)sched.counters.procsRunning / cpus;
+    ImVec4 color = queue > 1.0f ? ImVec4(1.0f, 0.4f, 0.3f, 1.0f) : ImGui::GetStyleColorVec4(ImGuiCol_Text);
+    ImGui::TextColored(color, "Run queue: %d running, %d blocked on I/O (%.2f per cpu)", sched.counters.procsRunning,
+                       sched.counters.procsBlocked, queue);
+    ImGui::Text("Context switches: %.0f/s  Forks: %.1f/s", sched.ctxtPerSec, sched.forksPerSec);
+
+    if (!ImGui::CollapsingHeader("Scheduler")) return;
+
+    loadScale = std::max({loadScale, sched.load1 * 1.2f, (float)cpus});
+    char overlay[48];
+    snprintf(overlay, sizeof(overlay), "load %.2f", sched.load1);
+    loadHistory.plot("Load (1 min)", 0.0f, loadScale, ImVec2(0, 50), overlay);
+
+    if (!sched.schedstatFound) {
+        ImGui::TextDisabled("No /proc/schedstat (kernel built without CONFIG_SCHEDSTATS).");
+        return;
+    }
+
+    delayScale = std::max(delayScale, sched.delayMsPerSec * 1.2f);
+    snprintf(overlay, sizeof(overlay), "%.1f ms/s, %.1f us per slice", sched.delayMsPerSec, sched.waitUs);
+    delayHistory.plot("Run-queue delay", 0.0f, delayScale, ImVec2(0, 50), overlay);
+
+    if (ImGui::BeginTable("SchedCpus", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_ScrollY,
+                          ImVec2(0, 200))) {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("CPU");
+        ImGui::TableSetupColumn("Delay ms/s");
+        ImGui::TableSetupColumn("Wait per slice");
+        ImGui::TableHeadersRow();
+
+        ImGuiListClipper clipper;
+        clipper.Begin((int)sched.cpus.size());
+        while (clipper.Step()) {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+                const CpuSched& cpu = sched.cpus[row];
+                ImGui::TableNextRow();
+                ImGui::TableSetColumnIndex(0);
+                ImGui::Text("cpu%d", cpu.cpu);
+                ImGui::TableSetColumnIndex(1);
+                ImGui::Text("%.2f", cpu.delayMsPerSec);
+                ImGui::TableSetColumnIndex(2);
+                ImGui::Text("%.1f us", cpu.waitUs);
+            }
+        }
+        ImGui::EndTable();
+    }
+}
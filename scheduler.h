@@ -0,0 +1,43 @@
+#pragma once
+#include "header.h"
+#include <cstdint>
+#include <vector>
+
+// ------------------------------
+// SCHEDULER LOAD AND RUN-QUEUE LATENCY
+// ------------------------------
+//
+// Load averages from /proc/loadavg, the /proc/stat scheduler counters (read
+// with the cpu lines) and, when the kernel has CONFIG_SCHEDSTATS, per-cpu
+// run time, run-queue delay and timeslice counts from /proc/schedstat.
+// Rates are over the interval since the previous read.
+
+struct CpuSched {
+    int cpu = 0;
+    uint64_t runTimeNs = 0;       // time spent running tasks
+    uint64_t runDelayNs = 0;      // time tasks spent waiting on this run queue
+    uint64_t timeslices = 0;      // tasks run on this cpu
+    float delayMsPerSec = 0.0f;   // run-queue wait per second of wall time
+    float waitUs = 0.0f;          // mean wait per timeslice
+};
+
+struct SchedInfo {
+    bool loadFound = false;
+    float load1 = 0.0f, load5 = 0.0f, load15 = 0.0f;
+    int runnable = 0;             // runnable tasks, from the loadavg "4/712" field
+    int threads = 0;              // all tasks, same field
+    ProcStatCounters counters = {};
+    float ctxtPerSec = 0.0f;
+    float forksPerSec = 0.0f;
+
+    bool schedstatFound = false;
+    std::vector<CpuSched> cpus;
+    float delayMsPerSec = 0.0f;   // summed over the cpus
+    float waitUs = 0.0f;          // mean wait per timeslice over all cpus
+};
+
+// `counters` come from the readCpuStats() call of the same round
+SchedInfo readSched(const ProcStatCounters& counters, int64_t timeMs);
+
+// Load, run queue and scheduling delay under the task counts of the System window
+void renderSchedPanel();
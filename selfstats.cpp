@@ -0,0 +1,248 @@
+#include "selfstats.h"
+#include "clock.h"
+#include "history.h"
+#include "plot.h"
+#include "procfs.h"
+#include "profiler.h"
+#include "snapshot.h"
+#include <imgui.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+#include <dirent.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+// ------------------------------
+// /proc/self READS
+// ------------------------------
+
+// Number of entries in a directory (their numeric names go to `ids`), or -1 if it can't be listed
+static int countEntries(const char* path, std::vector<int>* ids = nullptr) {
+    DIR* dir = opendir(path);
+    if (!dir) return -1;
+
+    int count = 0;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (entry->d_name[0] == '.') continue;
+        count++;
+        if (ids) ids->push_back(atoi(entry->d_name));
+    }
+    closedir(dir);
+    return count;
+}
+
+static double seconds(const struct timeval& tv) {
+    return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+// Name, faults and CPU ticks of one thread from /proc/self/task/<tid>/stat
+static bool readThread(int tid, SelfThread& thread, unsigned long long& ticks, std::string& buffer) {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/self/task/%d/stat", tid);
+    if (!readRealFile(path, buffer)) return false;
+
+    // comm may contain spaces and parentheses, so fields are counted from the last ')'
+    size_t open = buffer.find('(');
+    size_t close = buffer.rfind(')');
+    if (open == std::string::npos || close == std::string::npos || close < open) return false;
+    thread.tid = tid;
+    thread.name = buffer.substr(open + 1, close - open - 1);
+
+    // Field 3 (state) follows ") "; minflt is field 10, majflt 12, utime 14, stime 15
+    const char* p = buffer.c_str() + close + 2;
+    unsigned long long fields[16] = {};
+    for (int field = 3; field <= 15 && *p; field++) {
+        while (*p == ' ') p++;
+        fields[field] = strtoull(p, nullptr, 10);
+        while (*p && *p != ' ') p++;
+    }
+    thread.minorFaults = fields[10];
+    thread.majorFaults = fields[12];
+    ticks = fields[14] + fields[15];
+
+    snprintf(path, sizeof(path), "/proc/self/task/%d/status", tid);
+    if (readRealFile(path, buffer)) {
+        thread.voluntaryCtx = procStatusField(buffer, "\nvoluntary_ctxt_switches:");
+        thread.involuntaryCtx = procStatusField(buffer, "\nnonvoluntary_ctxt_switches:");
+    }
+    return true;
+}
+
+// ------------------------------
+// COLLECTION
+// ------------------------------
+
+SelfStats collectSelfStats() {
+    PROFILE_ZONE("collectSelfStats");
+    // Totals of the previous call, for rates
+    static double lastTime = 0.0;
+    static SelfStats last;
+    static std::unordered_map<int, unsigned long long> lastThreadTicks;
+
+    SelfStats stats;
+    double now = getTimeSeconds();
+    double dt = lastTime > 0.0 ? now - lastTime : 0.0;
+
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return stats;
+    stats.ok = true;
+    stats.userSeconds = seconds(usage.ru_utime);
+    stats.systemSeconds = seconds(usage.ru_stime);
+    stats.minorFaults = usage.ru_minflt;
+    stats.majorFaults = usage.ru_majflt;
+    stats.voluntaryCtx = usage.ru_nvcsw;
+    stats.involuntaryCtx = usage.ru_nivcsw;
+
+    // statm: size resident shared ... in pages
+    std::string buffer;
+    if (readRealFile("/proc/self/statm", buffer)) {
+        const char* resident = strchr(buffer.c_str(), ' ');
+        if (resident) stats.rssMB = strtoull(resident, nullptr, 10) * sysconf(_SC_PAGESIZE) / (1024.0f * 1024.0f);
+    }
+
+    stats.openFds = countEntries("/proc/self/fd");
+
+    // The kernel only counts read- and write-family syscalls per process
+    if (readRealFile("/proc/self/io", buffer))
+        stats.syscalls = procStatusField(buffer, "syscr:") + procStatusField(buffer, "\nsyscw:");
+
+    if (dt > 0.0) {
+        stats.userPercent = 100.0f * (stats.userSeconds - last.userSeconds) / dt;
+        stats.systemPercent = 100.0f * (stats.systemSeconds - last.systemSeconds) / dt;
+        stats.faultsPerSec = (stats.minorFaults + stats.majorFaults - last.minorFaults - last.majorFaults) / dt;
+        stats.ctxSwitchesPerSec = (stats.voluntaryCtx + stats.involuntaryCtx - last.voluntaryCtx - last.involuntaryCtx) / dt;
+        stats.syscallsPerSec = (stats.syscalls - last.syscalls) / dt;
+    }
+
+    // Per-thread breakdown; a thread's CPU % is relative to its own previous sample
+    std::vector<int> tids;
+    countEntries("/proc/self/task", &tids);
+    std::sort(tids.begin(), tids.end());
+    static const double ticksPerSecond = sysconf(_SC_CLK_TCK);
+    std::unordered_map<int, unsigned long long> threadTicks;
+    for (int tid : tids) {
+        SelfThread thread;
+        unsigned long long ticks = 0;
+        if (!readThread(tid, thread, ticks, buffer)) continue;  // exited while listing
+
+        auto prev = lastThreadTicks.find(tid);
+        if (dt > 0.0 && prev != lastThreadTicks.end())
+            thread.cpuPercent = 100.0f * (ticks - prev->second) / ticksPerSecond / dt;
+        threadTicks[tid] = ticks;
+        stats.threads.push_back(std::move(thread));
+    }
+
+    lastTime = now;
+    lastThreadTicks = std::move(threadTicks);
+    last = stats;
+    return stats;
+}
+
+// ------------------------------
+// SAMPLING
+// ------------------------------
+
+static SelfStats currentStats;
+static uint64_t sequence = 0;
+
+const SelfStats& currentSelfStats() {
+    return currentStats;
+}
+
+uint64_t selfStatsSequence() {
+    return sequence;
+}
+
+void updateSelfStats() {
+    static double lastSample = 0.0;
+    double now = getTimeSeconds();
+    if (sequence > 0 && (now - lastSample) * 1000.0 < sampleIntervalMs) return;
+    lastSample = now;
+
+    currentStats = collectSelfStats();
+    sequence++;
+    if (!currentStats.ok) return;
+
+    // Kept in the history store so a new build can be compared with an older one
+    historyRecord("self.cpu_user_pct", currentStats.userPercent);
+    historyRecord("self.cpu_sys_pct", currentStats.systemPercent);
+    historyRecord("self.rss_mb", currentStats.rssMB);
+    historyRecord("self.faults_per_s", currentStats.faultsPerSec);
+    historyRecord("self.ctx_switches_per_s", currentStats.ctxSwitchesPerSec);
+    historyRecord("self.fds", currentStats.openFds);
+    historyRecord("self.syscalls_per_s", currentStats.syscallsPerSec);
+}
+
+// ------------------------------
+// UI RENDERING FUNCTION FOR SELF TAB
+// ------------------------------
+
+// One hour at the default sample interval
+static const int maxSelfSamples = 7200;
+
+static PlotHistory selfCpuHistory(maxSelfSamples);
+static PlotHistory selfRssHistory(maxSelfSamples);
+static uint64_t lastSelfSequence = 0;
+
+void renderSelfTab() {
+    PROFILE_ZONE("renderSelfTab");
+    const SelfStats& stats = currentSelfStats();
+    if (!stats.ok) {
+        ImGui::Text("Resource usage of the monitor is not available.");
+        return;
+    }
+
+    if (selfStatsSequence() != lastSelfSequence) {
+        lastSelfSequence = selfStatsSequence();
+        selfCpuHistory.push(stats.userPercent + stats.systemPercent);
+        selfRssHistory.push(stats.rssMB);
+    }
+
+    ImGui::Text("Resources used by this monitor");
+    ImGui::Separator();
+
+    ImGui::Text("CPU: %.1f%% user, %.1f%% system (%.1f s / %.1f s total)",
+                stats.userPercent, stats.systemPercent, stats.userSeconds, stats.systemSeconds);
+    ImGui::Text("RSS: %.1f MB", stats.rssMB);
+    ImGui::Text("Page faults: %ld minor, %ld major (%.0f/s)", stats.minorFaults, stats.majorFaults, stats.faultsPerSec);
+    ImGui::Text("Context switches: %ld voluntary, %ld involuntary (%.0f/s)",
+                stats.voluntaryCtx, stats.involuntaryCtx, stats.ctxSwitchesPerSec);
+    ImGui::Text("Open fds: %d", stats.openFds);
+    ImGui::Text("Read/write syscalls: %.0f/s", stats.syscallsPerSec);
+
+    static ImVec2 graphSize = ImVec2(0, 60);
+    if (!selfCpuHistory.empty()) {
+        char overlay[32];
+        snprintf(overlay, sizeof(overlay), "%.1f%%", selfCpuHistory.back());
+        selfCpuHistory.plot("CPU %", 0.0f, 100.0f, graphSize, overlay);
+        snprintf(overlay, sizeof(overlay), "%.1f MB", selfRssHistory.back());
+        selfRssHistory.plot("RSS", 0.0f, std::max(1.0f, stats.rssMB * 1.5f), graphSize, overlay);
+    }
+
+    if (ImGui::BeginTable("SelfThreads", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders)) {
+        ImGui::TableSetupColumn("TID");
+        ImGui::TableSetupColumn("Thread");
+        ImGui::TableSetupColumn("CPU %");
+        ImGui::TableSetupColumn("Faults");
+        ImGui::TableSetupColumn("Ctx switches (vol/invol)");
+        ImGui::TableHeadersRow();
+
+        for (const SelfThread& thread : stats.threads) {
+            ImGui::TableNextRow();
+            ImGui::TableSetColumnIndex(0);
+            ImGui::Text("%d", thread.tid);
+            ImGui::TableSetColumnIndex(1);
+            ImGui::TextUnformatted(thread.name.c_str());
+            ImGui::TableSetColumnIndex(2);
+            ImGui::Text("%.1f", thread.cpuPercent);
+            ImGui::TableSetColumnIndex(3);
+            ImGui::Text("%llu", thread.minorFaults + thread.majorFaults);
+            ImGui::TableSetColumnIndex(4);
+            ImGui::Text("%llu / %llu", thread.voluntaryCtx, thread.involuntaryCtx);
+        }
+        ImGui::EndTable();
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ------------------------------
+// MONITOR SELF-ACCOUNTING
+// ------------------------------
+//
+// What the monitor itself costs: CPU time, memory, faults, context switches,
+// fds and syscalls, from getrusage and the real /proc/self. These never go
+// through the ProcSource, so --root and --archive still measure this process.
+
+struct SelfThread {
+    int tid = 0;
+    std::string name;
+    float cpuPercent = 0.0f;               // user + system since the previous sample
+    unsigned long long minorFaults = 0;
+    unsigned long long majorFaults = 0;
+    unsigned long long voluntaryCtx = 0;
+    unsigned long long involuntaryCtx = 0;
+};
+
+struct SelfStats {
+    bool ok = false;
+    double userSeconds = 0.0;              // CPU time since the monitor started
+    double systemSeconds = 0.0;
+    float userPercent = 0.0f;              // of one core, since the previous sample
+    float systemPercent = 0.0f;
+    float rssMB = 0.0f;
+    long minorFaults = 0;
+    long majorFaults = 0;
+    long voluntaryCtx = 0;
+    long involuntaryCtx = 0;
+    float faultsPerSec = 0.0f;             // minor + major
+    float ctxSwitchesPerSec = 0.0f;        // voluntary + involuntary
+    int openFds = 0;
+    unsigned long long syscalls = 0;       // read- and write-family syscalls (/proc/self/io)
+    float syscallsPerSec = 0.0f;
+    std::vector<SelfThread> threads;       // sorted by tid
+};
+
+// Reads the current figures; rates are since the previous call
+SelfStats collectSelfStats();
+
+// Called once per frame: samples every sampleIntervalMs and records the
+// self.* history series
+void updateSelfStats();
+
+// The latest sample, and a counter that increments with each one
+const SelfStats& currentSelfStats();
+uint64_t selfStatsSequence();
+
+// Totals, rates, graphs and the per-thread table
+void renderSelfTab();
@@ -0,0 +1,134 @@
+#include "smaps.h"
+#include "procfs.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+
+static const int smapsPidsPerRound = 32;
+static const int smapsRoundBudgetMs = 10;
+static const int smapsRoundIntervalMs = 1000;
+
+// ------------------------------
+// READING
+// ------------------------------
+
+// "Pss:                 123 kB" and so on, one line per field
+static SmapsMemory readSmapsRollup(const std::string& root, int pid, std::string& text) {
+    SmapsMemory memory;
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/smaps_rollup", pid);
+    // The reader thread can't share the live source's path buffer, so it reads the path itself
+    if (!readRealFile((root + path).c_str(), text) || text.empty()) return memory;
+    memory.found = true;
+    memory.pssKB = procStatusField(text, "\nPss:");
+    memory.ussKB = procStatusField(text, "\nPrivate_Clean:") + procStatusField(text, "\nPrivate_Dirty:");
+    memory.sharedKB = procStatusField(text, "\nShared_Clean:") + procStatusField(text, "\nShared_Dirty:");
+    memory.swapKB = procStatusField(text, "\nSwap:");
+    return memory;
+}
+
+// ------------------------------
+// READER THREAD
+// ------------------------------
+
+struct SmapsReader {
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stop = false;
+    std::string root;                               // procRoot() when the pids were requested
+    std::vector<int> wanted;                        // sorted
+    std::unordered_map<int, SmapsMemory> results;   // only pids in `wanted`
+    size_t cursor = 0;                              // next index of `wanted` to read
+    uint64_t forgets = 0;                           // forgetSmaps() calls, so a batch read across one is dropped
+};
+
+static SmapsReader reader;
+
+static void readerLoop() {
+    std::string text;
+    std::vector<int> batch;
+    std::vector<std::pair<int, SmapsMemory>> read;
+    std::unique_lock<std::mutex> lock(reader.mutex);
+    while (!reader.stop) {
+        if (reader.wanted.empty()) {
+            reader.wake.wait_for(lock, std::chrono::milliseconds(smapsRoundIntervalMs));
+            continue;
+        }
+
+        // Take the next pids round-robin, so a long list is refreshed over several rounds
+        batch.clear();
+        for (size_t i = 0; i < reader.wanted.size() && (int)batch.size() < smapsPidsPerRound; i++)
+            batch.push_back(reader.wanted[(reader.cursor + i) % reader.wanted.size()]);
+        std::string root = reader.root;
+        uint64_t forgets = reader.forgets;
+        lock.unlock();
+
+        read.clear();
+        auto start = std::chrono::steady_clock::now();
+        for (int pid : batch) {
+            read.push_back({pid, readSmapsRollup(root, pid, text)});
+            if (std::chrono::steady_clock::now() - start > std::chrono::milliseconds(smapsRoundBudgetMs)) break;
+        }
+
+        // A batch that may have read a process since replaced under its pid is read again
+        lock.lock();
+        if (forgets != reader.forgets) read.clear();
+        for (const auto& [pid, memory] : read)
+            if (std::binary_search(reader.wanted.begin(), reader.wanted.end(), pid)) reader.results[pid] = memory;
+        if (!reader.wanted.empty()) reader.cursor = (reader.cursor + read.size()) % reader.wanted.size();
+        if (!reader.stop) reader.wake.wait_for(lock, std::chrono::milliseconds(smapsRoundIntervalMs));
+    }
+}
+
+void requestSmaps(const std::vector<int>& requested) {
+    // Called every frame, so the common case (nothing changed) doesn't allocate
+    static std::vector<int> pids;
+    pids.clear();
+    if (!isArchiveOpen()) pids.assign(requested.begin(), requested.end());
+    std::sort(pids.begin(), pids.end());
+    pids.erase(std::unique(pids.begin(), pids.end()), pids.end());
+
+    std::lock_guard<std::mutex> lock(reader.mutex);
+    if (pids == reader.wanted && reader.root == procRoot()) return;
+    bool added = pids.size() > reader.wanted.size();
+    reader.wanted = pids;
+    reader.root = procRoot();
+    reader.cursor = 0;
+    for (auto it = reader.results.begin(); it != reader.results.end();)
+        it = std::binary_search(reader.wanted.begin(), reader.wanted.end(), it->first) ? std::next(it)
+                                                                                       : reader.results.erase(it);
+    if (reader.wanted.empty()) return;
+
+    if (!reader.thread.joinable()) {
+        reader.stop = false;
+        reader.thread = std::thread(readerLoop);
+    } else if (added) {
+        // New rows (a scroll or a selection) shouldn't wait for the next round
+        reader.wake.notify_one();
+    }
+}
+
+void smapsResults(std::unordered_map<int, SmapsMemory>& out) {
+    std::lock_guard<std::mutex> lock(reader.mutex);
+    out = reader.results;
+}
+
+void forgetSmaps(int pid) {
+    std::lock_guard<std::mutex> lock(reader.mutex);
+    reader.results.erase(pid);
+    reader.forgets++;
+}
+
+void stopSmapsReader() {
+    {
+        std::lock_guard<std::mutex> lock(reader.mutex);
+        reader.stop = true;
+    }
+    reader.wake.notify_one();
+    if (reader.thread.joinable()) reader.thread.join();
+}
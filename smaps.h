@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// ------------------------------
+// PROPORTIONAL MEMORY (smaps_rollup)
+// ------------------------------
+//
+// VmRSS counts every shared page in full for each process that maps it, so a
+// pool of forked workers looks many times bigger than it is. smaps_rollup
+// has the proportional (PSS) and private (USS) sizes, but reading it walks
+// the page tables under the process's mmap lock. It is read on a background
+// thread, only for the pids the process table asks for (selected and visible
+// rows), and at most smapsPidsPerRound pids or smapsRoundBudgetMs per round.
+
+struct SmapsMemory {
+    bool found = false;
+    uint64_t pssKB = 0;              // Pss: private pages plus a share of each shared page
+    uint64_t ussKB = 0;              // Private_Clean + Private_Dirty
+    uint64_t sharedKB = 0;           // Shared_Clean + Shared_Dirty
+    uint64_t swapKB = 0;
+};
+
+// Replaces the set of pids to keep fresh; starts the reader on first use.
+// Ignored when the snapshots don't come from a readable /proc (an archive)
+void requestSmaps(const std::vector<int>& pids);
+
+// Latest result of every requested pid that has been read
+void smapsResults(std::unordered_map<int, SmapsMemory>& out);
+
+// Drops the result of a pid now used by another process
+void forgetSmaps(int pid);
+
+void stopSmapsReader();
@@ -0,0 +1,120 @@
+#include "snapshot.h"
+#include "clock.h"
+#include "history.h"
+#include "inventory.h"
+#include "procfs.h"
+#include "profiler.h"
+
+// ------------------------------
+// SNAPSHOT STATE
+// ------------------------------
+
+int sampleIntervalMs = 500;
+
+static Snapshot current;
+static uint64_t sequence = 0;
+static uint64_t epoch = 0;
+
+const Snapshot& currentSnapshot() {
+    return current;
+}
+
+uint64_t snapshotSequence() {
+    return sequence;
+}
+
+uint64_t snapshotEpoch() {
+    return epoch;
+}
+
+// ------------------------------
+// LIVE COLLECTION
+// ------------------------------
+
+Snapshot collectSnapshot() {
+    PROFILE_ZONE("collectSnapshot");
+    // Counters of the previous round, for CPU usage deltas
+    static CPUStats lastCpu = {};
+    static std::vector<CPUStats> lastCores;
+
+    Snapshot snap;
+    snap.timeMs = isArchiveOpen() ? archiveRoundTimeMs() : historyNowMs();
+
+    // Frame this round's /proc and /sys reads when capturing
+    captureBeginRound(snap.timeMs);
+
+    snap.host = hostInventory();
+    snap.tasks = getTaskStats();
+
+    ProcStatCounters counters = {};
+#ifdef __linux__
+    snap.cpu = readCpuStats(&snap.cores, &counters);
+    snap.cpuPercent = cpuUsageBetween(lastCpu, snap.cpu);
+    snap.cpuStates = cpuStatesBetween(lastCpu, snap.cpu);
+    snap.coreStates.resize(snap.cores.size());
+    for (size_t i = 0; i < snap.cores.size(); i++)
+        snap.coreStates[i] = cpuStatesBetween(i < lastCores.size() ? lastCores[i] : CPUStats{}, snap.cores[i]);
+    lastCpu = snap.cpu;
+    lastCores = snap.cores;
+#else
+    snap.cpuPercent = getCpuUsagePercent();
+#endif
+    snap.steal = trackSteal(snap.cpuStates, snap.coreStates, snap.timeMs);
+
+    snap.freq = readCpuFreq(snap.timeMs);
+    snap.psi = readPsi(snap.timeMs);
+    snap.sched = readSched(counters, snap.timeMs);
+    snap.irq = readInterrupts(snap.timeMs);
+    snap.perf = readPerf(snap.timeMs);
+    snap.cgroups = readCgroups(snap.timeMs);
+
+    std::tie(snap.memUsedMB, snap.memTotalMB) = getMemoryUsageMB();
+    snap.swap = getSwapInfo();
+    snap.disk = getDiskStats();
+    snap.net = readNetworkStats();
+    snap.interfaces = getNetworkInterfaces();
+    snap.thermalFound = thermalSensorFound();
+    snap.temperatureC = readTemperatureC();
+    snap.fan = getFanInfo();
+    snap.processes = collectProcesses();
+
+    captureEndRound();
+    return snap;
+}
+
+void updateSnapshot() {
+    PROFILE_ZONE("updateSnapshot");
+    static double lastFrame = getTimeSeconds();
+    static double lastCollect = 0.0;
+
+    double now = getTimeSeconds();
+    double dt = now - lastFrame;
+    lastFrame = now;
+
+    if (isReplaying()) {
+        Snapshot snap;
+        bool jumped = false;
+        if (advanceReplay(dt, snap, jumped)) {
+            current = std::move(snap);
+            sequence++;
+            if (jumped) epoch++;
+        }
+        return;
+    }
+
+    if (sequence > 0 && (now - lastCollect) * 1000.0 < sampleIntervalMs) return;
+    lastCollect = now;
+
+    // A capture archive feeds the collectors one round per sample interval,
+    // and stays on its last round when exhausted
+    bool fromArchive = isArchiveOpen();
+    if (fromArchive && sequence > 0 && !archiveNextRound()) return;
+
+    current = collectSnapshot();
+    sequence++;
+
+    // Archived rounds come from another host and a --root tree from a fixture,
+    // so keep both out of the local history
+    if (!fromArchive && procRoot().empty()) historySample(current);
+    if (isRecording()) recordSnapshot(current);
+}
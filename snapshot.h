@@ -0,0 +1,191 @@
+#pragma once
+#include "header.h"
+#include "cgroups.h"
+#include "fan.h"
+#include "cpufreq.h"
+#include "interrupts.h"
+#include "perfcounters.h"
+#include "psi.h"
+#include "scheduler.h"
+#include "smaps.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_set>
+
+// ------------------------------
+// SNAPSHOTS
+// ------------------------------
+//
+// One round of every collector. The render functions only draw the current
+// snapshot, which comes either from the live host (collected every
+// sampleIntervalMs) or from a recording being replayed.
+
+// One level of the cache hierarchy, as seen from cpu0
+struct CacheLevel {
+    int level = 0;
+    std::string type;       // Data, Instruction or Unified
+    int sizeKB = 0;
+    int sharedBy = 0;       // logical cpus sharing one instance
+};
+
+// Changes only on hotplug; built by hostInventory()
+struct HostInfo {
+    std::string osName;
+    std::string user;
+    std::string hostname;
+    std::string cpuModel;
+    std::string cpuVendor;
+    std::string kernel;
+    std::string hypervisor;  // "KVM", "Hyper-V", ...; empty on bare metal
+    int sockets = 0;
+    int cores = 0;          // physical cores
+    int threads = 0;        // online logical cpus
+    int numaNodes = 0;
+    float memTotalGB = 0.0f;
+    std::vector<CacheLevel> caches;
+};
+
+struct DiskStats {
+    bool ok = false;
+    float usedPercent = 0.0f;  // 0..1
+    float totalGB = 0.0f;
+    float usedGB = 0.0f;
+    float availGB = 0.0f;
+};
+
+struct NetInterface {
+    std::string name;
+    std::string ipv4;
+};
+
+// Per second rates from /proc/[pid]/io
+struct ProcessIo {
+    float readBytes = 0.0f;          // from the block device
+    float writeBytes = 0.0f;
+    float rchar = 0.0f;              // through read() and friends, cache hits included
+    float wchar = 0.0f;
+    float syscr = 0.0f;              // read and write syscalls
+    float syscw = 0.0f;
+};
+
+// One thread of a process, from /proc/[pid]/task/[tid]/stat
+struct ThreadSample {
+    int tid = 0;
+    std::string name;
+    char state = '?';
+    int processor = -1;              // cpu it last ran on
+    unsigned long long cpuTime = 0;  // utime + stime in clock ticks
+    float cpuPercent = 0.0f;         // userPercent + systemPercent; 100 is one cpu
+    float userPercent = 0.0f;
+    float systemPercent = 0.0f;
+};
+
+struct ProcessSample {
+    int pid = 0;
+    std::string name;
+    char state = '?';
+    unsigned long long cpuTime = 0;  // utime + stime in clock ticks
+    float cpuPercent = 0.0f;         // userPercent + systemPercent; 100 is one cpu
+    float userPercent = 0.0f;
+    float systemPercent = 0.0f;
+    bool ioFound = false;            // io was readable and its columns are shown
+    ProcessIo io;
+    SmapsMemory smaps;               // only for the rows the process table asked for
+    float memPercent = 0.0f;
+    int threads = 0;
+    int priority = 0;                // kernel priority: nice + 20, or negative for real-time
+    int nice = 0;
+    int processor = -1;              // cpu it last ran on
+    int policy = 0;                  // SCHED_OTHER, SCHED_FIFO, ...
+    float minorFaults = 0.0f;        // per second
+    float majorFaults = 0.0f;        // per second, each one a read from disk
+    float voluntarySwitches = 0.0f;  // per second, gave up the cpu to wait
+    float involuntarySwitches = 0.0f;// per second, preempted
+    std::vector<ThreadSample> tasks; // only for expandedProcesses, sorted by tid
+    std::string cgroup;              // cgroup v2 path from /proc/[pid]/cgroup, empty if unknown
+};
+
+struct Snapshot {
+    int64_t timeMs = 0;              // wall clock, ms since the Unix epoch
+    HostInfo host;
+    TaskStats tasks = {};
+    CPUStats cpu = {};               // aggregate /proc/stat counters
+    float cpuPercent = 0.0f;         // usage since the previous snapshot
+    CpuStates cpuStates = {};        // time per state since the previous snapshot
+    std::vector<CPUStats> cores;     // per-core /proc/stat counters, indexed by cpu number
+    std::vector<CpuStates> coreStates;
+    StealInfo steal;                 // steal time over the last minute, and the noisy neighbour flag
+    CpuFreqInfo freq;                // clock speed and idle-state residency per core
+    PsiInfo psi;                     // pressure stall information for cpu, memory and io
+    SchedInfo sched;                 // load, run queue and scheduling delay
+    IrqInfo irq;                     // interrupt and softirq increments per cpu
+    PerfInfo perf;                   // perf_event_open counters per cpu, when enabled
+    CgroupInfo cgroups;              // cgroup v2 tree with its own CPU, memory and I/O accounting
+    float memUsedMB = 0.0f;
+    float memTotalMB = 0.0f;
+    SwapStats swap;
+    DiskStats disk;
+    std::map<std::string, NetStats> net;
+    std::vector<NetInterface> interfaces;
+    bool thermalFound = false;
+    float temperatureC = 0.0f;
+    FanInfo fan = {false, 0, 0};
+    std::vector<ProcessSample> processes;  // sorted by pid
+};
+
+// Collectors that need their own translation unit's state
+DiskStats getDiskStats();
+std::vector<NetInterface> getNetworkInterfaces();
+std::vector<ProcessSample> collectProcesses();
+
+// Time constant of the per-process CPU % average in seconds; 0 shows each interval as measured
+extern float processCpuSmoothingSeconds;
+
+// Whether collectProcesses reads /proc/[pid]/io; the process table sets it while an I/O column is shown
+extern bool processIoEnabled;
+
+// Processes whose threads collectProcesses reads; the process table's expanded rows
+extern std::unordered_set<int> expandedProcesses;
+
+// Runs every collector once
+Snapshot collectSnapshot();
+
+// The snapshot the render functions draw this frame
+const Snapshot& currentSnapshot();
+
+// Increments whenever currentSnapshot() changes; graphs push one point per change
+uint64_t snapshotSequence();
+
+// Increments when the timeline jumps (replay seek); graphs clear their history
+uint64_t snapshotEpoch();
+
+// Called once per frame: collects a live snapshot when due, or advances the replay
+void updateSnapshot();
+
+// Minimum time between two live snapshots
+extern int sampleIntervalMs;
+
+// ------------------------------
+// RECORD AND REPLAY
+// ------------------------------
+
+// Writes every live snapshot to `path` until stopRecording()
+bool startRecording(const std::string& path);
+void stopRecording();
+bool isRecording();
+
+// Drives currentSnapshot() from a recording instead of the live host
+bool openReplay(const std::string& path);
+bool isReplaying();
+
+// Appends a live snapshot to the recording (called by updateSnapshot)
+void recordSnapshot(const Snapshot& snap);
+
+// Moves the replay forward by dtSeconds of wall time; returns true with the
+// new snapshot in `out` when it changed, and sets `jumped` after a seek
+bool advanceReplay(double dtSeconds, Snapshot& out, bool& jumped);
+
+// Recording status, or play/pause, seek and speed controls for the replay
+void renderReplayWindow(const char* id, ImVec2 size, ImVec2 position);
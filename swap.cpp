@@ -1,10 +1,12 @@
 #include "header.h"
+#include "snapshot.h"
+#include "procfs.h"
+#include "profiler.h"
 #include <imgui.h>
 #include <utility>
 #include <string>
 
 #if defined(__linux__)
-    #include <fstream>
     #include <sstream>
     #include <unordered_map>
 #elif defined(_WIN32)
@@ -15,19 +17,15 @@
     #include <mach/mach.h>
 #endif
 
-struct SwapStats {
-    float usedMB = 0.0f;
-    float totalMB = 0.0f;
-    std::string errorMessage; // empty if no error
-};
-
 // Returns SwapStats with errorMessage set if unsupported or failed
 SwapStats getSwapInfo()
 {
+    PROFILE_ZONE("getSwapInfo");
 #if defined(__linux__)
-    std::ifstream meminfo("/proc/meminfo");
-    if (!meminfo.is_open())
+    std::string contents;
+    if (!procReadFile("/proc/meminfo", contents))
         return {0, 0, "Failed to open /proc/meminfo"};
+    std::istringstream meminfo(contents);
 
     std::string line;
     std::unordered_map<std::string, long> memValues;
@@ -83,6 +81,7 @@ SwapStats getSwapInfo()
 
 void renderSwapWindow(const char* id, ImVec2 size, ImVec2 position)
 {
+    PROFILE_ZONE("renderSwapWindow");
     ImGui::SetNextWindowSize(size, ImGuiCond_FirstUseEver);
     ImGui::SetNextWindowPos(position, ImGuiCond_FirstUseEver);
 
@@ -91,7 +90,7 @@ void renderSwapWindow(const char* id, ImVec2 size, ImVec2 position)
         return;
     }
 
-    SwapStats swap = getSwapInfo();
+    const SwapStats& swap = currentSnapshot().swap;
 
     if (!swap.errorMessage.empty()) {
         ImGui::TextColored(ImVec4(1,0,0,1), "%s", swap.errorMessage.c_str());
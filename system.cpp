@@ -1,4 +1,7 @@
 #include "header.h"
+#include "procfs.h" // /proc reads go through the active ProcSource
+#include "profiler.h" // timing zones for the profiler overlay
+#include <sstream>  // for parsing file contents
 #include <cstdlib>  // for getenv
 #include <string>   // for std::string
 #include <cstring>  // for memset
@@ -83,6 +86,7 @@ std::string getComputerName()
 //  getTaskStats, this will to get the process states cross-platform💜
 TaskStats getTaskStats()
 {
+    PROFILE_ZONE("getTaskStats");
     TaskStats stats = {0, 0, 0, 0, 0, 0};
 
 #ifdef _WIN32
@@ -114,22 +118,21 @@ TaskStats getTaskStats()
     CloseHandle(hProcessSnap);
 
 #else
-    DIR *dir = opendir("/proc");
-    if (!dir)
+    vector<string> entries;
+    if (!procListDir("/proc", entries))
         return stats;
 
-    struct dirent *entry;
-    while ((entry = readdir(dir)) != NULL)
+    string contents;
+    for (const string &name : entries)
     {
-        if (!isdigit(entry->d_name[0]))
+        if (!isdigit(name[0]))
             continue;
 
         stats.total++;
 
-        string statPath = string("/proc/") + entry->d_name + "/stat";
-        ifstream statFile(statPath);
-        if (!statFile.is_open())
+        if (!procReadFile("/proc/" + name + "/stat", contents))
             continue;
+        istringstream statFile(contents);
 
         string pid, comm, state;
         statFile >> pid >> comm >> state;
@@ -144,58 +147,8 @@ TaskStats getTaskStats()
             stats.stopped++;
         else if (state == "Z")
             stats.zombie++;
-
-        statFile.close();
     }
-
-    closedir(dir);
 #endif
 
     return stats;
 }
-
-//  CPUinfo, this will get the CPU cross-platform💜
-// get cpu id and information, you can use `proc/cpuinfo`
-std::string CPUinfo()
-{
-#ifdef _WIN32
-    int CPUInfo[4] = {-1};
-    char CPUBrandString[0x40];
-    __cpuid(CPUInfo, 0x80000000);
-    unsigned int nExIds = CPUInfo[0];
-
-    memset(CPUBrandString, 0, sizeof(CPUBrandString));
-
-    for (unsigned int i = 0x80000002; i <= nExIds && i <= 0x80000004; ++i)
-    {
-        __cpuid(CPUInfo, i);
-        memcpy(CPUBrandString + (i - 0x80000002) * 16, CPUInfo, sizeof(CPUInfo));
-    }
-
-    return std::string(CPUBrandString);
-
-#elif __linux__
-    std::ifstream cpuinfo("/proc/cpuinfo");
-    std::string line;
-    while (std::getline(cpuinfo, line))
-    {
-        if (line.substr(0, 10) == "model name")
-        {
-            return line.substr(line.find(":") + 2);
-        }
-    }
-    return "Unknown CPU";
-
-#elif __APPLE__
-    char buffer[256];
-    size_t bufferlen = sizeof(buffer);
-    if (sysctlbyname("machdep.cpu.brand_string", &buffer, &bufferlen, NULL, 0) == 0)
-    {
-        return std::string(buffer);
-    }
-    return "Unknown CPU";
-
-#else
-    return "Unknown CPU";
-#endif
-}
@@ -0,0 +1,519 @@
+#include "header.h"
+#include "snapshot.h"
+#include "procfs.h"
+#include "clock.h"
+#include "fixture.h"
+#include <algorithm>
+#include <cmath>
+#include <csignal>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <sys/wait.h>
+
+/*
+Tests for the system monitor, built and run with `make test`.
+
+    ./monitor-test [NAME...]
+
+Runs every test, or those named. Each test runs in its own process, so
+collector state (previous counters, discovery caches, the proc root and the
+clock) starts fresh. The exit status is 1 if any check failed.
+*/
+
+namespace fs = std::filesystem;
+
+// ------------------------------
+// CHECKS
+// ------------------------------
+
+static int failures = 0;
+
+static void check(bool ok, const char* what, const char* file, int line) {
+    if (ok) return;
+    fprintf(stderr, "    %s:%d: %s\n", file, line, what);
+    failures++;
+}
+
+static void checkNear(double value, double expected, double tolerance, const char* what,
+                      const char* file, int line) {
+    if (std::fabs(value - expected) <= tolerance) return;
+    fprintf(stderr, "    %s:%d: %s = %.3f, expected %.3f +- %.3f\n", file, line, what, value, expected, tolerance);
+    failures++;
+}
+
+#define CHECK(cond) check((cond), #cond, __FILE__, __LINE__)
+#define CHECK_NEAR(value, expected, tolerance) checkNear((value), (expected), (tolerance), #value, __FILE__, __LINE__)
+
+static const ProcessSample* findProcess(const std::vector<ProcessSample>& processes, int pid) {
+    auto it = std::lower_bound(processes.begin(), processes.end(), pid,
+                               [](const ProcessSample& p, int pid) { return p.pid < pid; });
+    return it != processes.end() && it->pid == pid ? &*it : nullptr;
+}
+
+// A generated tree under the temp directory, which is the proc root while it lives
+struct FixtureTree {
+    FixtureSpec spec;
+    std::string root;
+    int round = 0;
+    bool ok = false;
+
+    explicit FixtureTree(const FixtureSpec& fixture) : spec(fixture) {
+        root = (fs::temp_directory_path() / ("sysmon-test-" + std::to_string(getpid()))).string();
+        ok = writeFixture(root, spec, round);
+        setProcRoot(root);
+    }
+
+    ~FixtureTree() {
+        setProcRoot("");
+        std::error_code ec;
+        fs::remove_all(root, ec);
+    }
+
+    // Rewrites the tree as it looks one second later
+    bool advance() { return writeFixture(root, spec, ++round); }
+};
+
+// ------------------------------
+// LIVE HOST
+// ------------------------------
+
+// A child spinning on one cpu reads about 100%, this process sleeping in between about 0%
+static void testProcessCpuPercent() {
+    pid_t child = fork();
+    if (child == 0) {
+        for (volatile unsigned long spin = 0;; spin++) {}
+    }
+    CHECK(child > 0);
+    if (child <= 0) return;
+
+    // Let it get going, so the first round's counters are past its start
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    collectProcesses();
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    std::vector<ProcessSample> processes = collectProcesses();
+
+    kill(child, SIGKILL);
+    waitpid(child, nullptr, 0);
+
+    const ProcessSample* busy = findProcess(processes, child);
+    const ProcessSample* idle = findProcess(processes, getpid());
+    CHECK(busy != nullptr);
+    CHECK(idle != nullptr);
+    if (busy) CHECK_NEAR(busy->cpuPercent, 100.0, 15.0);
+    if (idle) CHECK_NEAR(idle->cpuPercent, 0.0, 5.0);
+}
+
+// A held /proc file is read whole, though its seq_file returns a few KB of whole records per
+// read. Fixture files are regular files, read whole at once, so only the live host shows this
+static void testHeldFileReadsWhole() {
+    auto count = [](const std::string& text, const char* key) {
+        size_t n = 0;
+        for (size_t at = text.find(key); at != std::string::npos; at = text.find(key, at + 1)) n++;
+        return n;
+    };
+
+    ProcHandle handle;
+    std::string held, byPath;
+    CHECK(procOpenHandle("/proc/self/smaps", handle));
+    CHECK(procReadHandle(handle, held));
+    CHECK(procReadFile("/proc/self/smaps", byPath));
+    procCloseHandle(handle);
+
+    CHECK(held.size() > 4096);
+    CHECK(count(held, "\nRss:") == count(byPath, "\nRss:"));
+    CHECK(!held.empty() && held.back() == '\n');
+}
+
+// Every row of /proc/interrupts and /proc/softirqs, which are held open and run to tens
+// of KB on a big host, becomes a source
+static void testInterruptsReadWhole() {
+    auto rows = [](const char* path) {
+        std::string text;
+        if (!procReadFile(path, text)) return (size_t)0;
+        size_t n = 0;
+        for (size_t at = text.find('\n'); at != std::string::npos; at = text.find('\n', at + 1)) {
+            size_t eol = text.find('\n', at + 1);
+            if (text.find(':', at + 1) < std::min(eol, text.size())) n++;
+        }
+        return n;
+    };
+
+    IrqInfo info = readInterrupts(clockWallMs());
+    CHECK(info.found);
+    CHECK(info.sources.size() == rows("/proc/interrupts") + rows("/proc/softirqs"));
+}
+
+// Every cpu of /proc/schedstat, which is held open and runs to tens of KB on a big host
+static void testSchedstatReadWhole() {
+    std::string text;
+    if (procReadFile("/proc/schedstat", text)) {
+        size_t cpus = 0;
+        for (size_t at = text.find("\ncpu"); at != std::string::npos; at = text.find("\ncpu", at + 1)) cpus++;
+        CHECK(readSched(ProcStatCounters{}, clockWallMs()).cpus.size() == cpus);
+    }
+
+    FixtureSpec spec;
+    spec.pids = 8;
+    spec.cpus = 256;
+    spec.threads = 4;
+    FixtureTree tree(spec);
+    CHECK(tree.ok);
+    SchedInfo info = readSched(ProcStatCounters{}, clockWallMs());
+    CHECK(info.cpus.size() == 256);
+    CHECK(!info.cpus.empty() && info.cpus.back().cpu == 255);
+}
+
+// ------------------------------
+// FIXTURES
+// ------------------------------
+
+static FixtureSpec smallFixture() {
+    FixtureSpec spec;
+    spec.pids = 50;
+    spec.interfaces = 6;
+    spec.sensors = 3;
+    spec.cpus = 4;
+    spec.threads = 8;
+    spec.containers = 2;
+    return spec;
+}
+
+// One process per slot, with the fixture's pids, names and states
+static void testFixtureProcesses() {
+    FixtureTree tree(smallFixture());
+    CHECK(tree.ok);
+    std::vector<ProcessSample> processes = collectProcesses();
+    CHECK((int)processes.size() == tree.spec.pids);
+    for (int slot = 0; slot < tree.spec.pids; slot++) {
+        const ProcessSample* p = findProcess(processes, fixturePid(tree.spec, slot, 0));
+        CHECK(p != nullptr);
+        if (!p) continue;
+        CHECK(p->name != "unknown");
+        CHECK(p->state != '?');
+        CHECK(p->cgroup[0] == '/');
+    }
+    const ProcessSample* first = findProcess(processes, fixturePid(tree.spec, 0, 0));
+    if (first) CHECK(first->threads == tree.spec.threads);
+}
+
+// lo, eth0, eth1, then veth0... with counters growing each round
+static void testFixtureInterfaces() {
+    FixtureTree tree(smallFixture());
+    CHECK(tree.ok);
+    std::map<std::string, NetStats> before = readNetworkStats();
+    CHECK((int)before.size() == tree.spec.interfaces);
+    for (const char* name : {"lo", "eth0", "eth1", "veth0", "veth1", "veth2"}) CHECK(before.count(name) == 1);
+
+    CHECK(tree.advance());
+    std::map<std::string, NetStats> after = readNetworkStats();
+    CHECK(after.size() == before.size());
+    for (const auto& [name, stats] : after) {
+        CHECK(stats.rx_bytes > 0 && stats.tx_bytes > 0);
+        CHECK(before[name].rx_bytes == 0);
+        CHECK(stats.rx_packets == stats.rx_bytes / 800);
+    }
+}
+
+// The package temperature from thermal_zone0, and the fan of the first hwmon device that has one
+static void testFixtureSensors() {
+    FixtureTree tree(smallFixture());
+    CHECK(tree.ok);
+    std::vector<std::string> devices;
+    CHECK(procListDir("/sys/class/hwmon", devices) && (int)devices.size() == tree.spec.sensors);
+
+    for (int round = 0; round < 3; round++) {
+        if (round > 0) CHECK(tree.advance());
+        int milliC = 45000 + (int)(10000 * std::sin(round / 20.0 + tree.spec.seed));
+        CHECK(thermalSensorFound());
+        CHECK_NEAR(readTemperatureC(), milliC / 1000.0, 0.001);
+    }
+
+    // hwmon1 spins at 800..2000 rpm plus 10 per round
+    FanInfo fan = getFanInfo();
+    CHECK(fan.active);
+    CHECK(fan.speedRPM >= 800 + 20 && fan.speedRPM < 2000 + 20);
+    CHECK(fan.level >= 100 && fan.level < 255);
+    CHECK(tree.advance());
+    CHECK(getFanInfo().speedRPM == fan.speedRPM + 10);
+}
+
+// churn * pids processes exit each round and new ones take their slots with higher pids
+static void testFixtureChurn() {
+    FixtureSpec spec = smallFixture();
+    spec.churn = 0.1;
+    FixtureTree tree(spec);
+    CHECK(tree.ok);
+
+    std::vector<ProcessSample> last = collectProcesses();
+    for (int round = 1; round <= 12; round++) {
+        CHECK(tree.advance());
+        std::vector<ProcessSample> processes = collectProcesses();
+        CHECK((int)processes.size() == spec.pids);
+
+        int started = 0;
+        for (int slot = 0; slot < spec.pids; slot++) {
+            int pid = fixturePid(spec, slot, round);
+            CHECK(findProcess(processes, pid) != nullptr);
+            if (!findProcess(last, pid)) {
+                started++;
+                CHECK(pid > fixturePid(spec, slot, round - 1));
+            }
+        }
+        CHECK(started == 5);
+        last = std::move(processes);
+    }
+}
+
+// The periodic walk of the cgroup tree keeps the files of the cgroups still there open,
+// and closes those of a removed one
+static void testCgroupRescan() {
+    auto openFds = [] {
+        std::error_code ec;
+        return std::distance(fs::directory_iterator("/proc/self/fd", ec), fs::directory_iterator());
+    };
+
+    FixtureTree tree(smallFixture());
+    CHECK(tree.ok);
+    CgroupInfo info = readCgroups(1000);
+    CHECK(info.found && !info.groups.empty());
+    auto fds = openFds();
+
+    CgroupInfo again = readCgroups(7000);
+    CHECK(again.groups.size() == info.groups.size());
+    CHECK(openFds() == fds);
+
+    // A container scope goes away; it is noticed by the next walk
+    auto scope = std::find_if(info.groups.begin(), info.groups.end(),
+                              [](const CgroupStats& g) { return g.path.find("/cri-containerd-") != std::string::npos; });
+    CHECK(scope != info.groups.end());
+    if (scope == info.groups.end()) return;
+    const CgroupStats& leaf = *scope;
+    std::error_code ec;
+    fs::remove_all(tree.root + "/sys/fs/cgroup" + leaf.path, ec);
+    CgroupInfo removed = readCgroups(13000);
+    CHECK(removed.groups.size() == info.groups.size() - 1);
+    CHECK(openFds() < fds);
+    for (const CgroupStats& g : removed.groups) CHECK(g.path != leaf.path);
+}
+
+// utime + stime of a /proc/[pid]/stat line
+static unsigned long long statTicks(const std::string& stat) {
+    size_t at = stat.rfind(')');
+    if (at == std::string::npos) return 0;
+    std::istringstream fields(stat.substr(at + 2));
+    std::string field;
+    unsigned long long utime = 0, stime = 0;
+    for (int i = 0; i < 11 && fields >> field; i++) {}
+    fields >> utime >> stime;
+    return utime + stime;
+}
+
+// A child cgroup is any subdirectory, even one named like an interface file
+static void testCgroupDottedNames() {
+    FixtureTree tree(smallFixture());
+    CHECK(tree.ok);
+    for (const char* name : {"cpu.slice", "io.workers", "memory.batch"}) {
+        std::string dir = tree.root + "/sys/fs/cgroup/system.slice/" + name;
+        fs::create_directory(dir);
+        std::ofstream(dir + "/cpu.stat") << "usage_usec 1000\nuser_usec 600\nsystem_usec 400\n";
+    }
+
+    CgroupInfo info = readCgroups(1000);
+    for (const char* path : {"/system.slice/cpu.slice", "/system.slice/io.workers", "/system.slice/memory.batch"}) {
+        auto found = std::find_if(info.groups.begin(), info.groups.end(),
+                                  [path](const CgroupStats& g) { return g.path == path; });
+        CHECK(found != info.groups.end());
+        if (found != info.groups.end()) CHECK(found->usageUsec == 1000 && found->depth == 2);
+    }
+}
+
+// A recording whose trailer points outside the file opens by walking its frames instead
+static void testRecordingBadIndex() {
+    FixtureTree tree(smallFixture());
+    CHECK(tree.ok);
+    std::string path = tree.root + "/test.smrc";
+    CHECK(startRecording(path));
+    for (int i = 0; i < 3; i++) {
+        recordSnapshot(collectSnapshot());
+        CHECK(tree.advance());
+    }
+    stopRecording();
+
+    std::ifstream in(path, std::ios::binary);
+    std::string good((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    CHECK(good.size() > 17);
+    auto reopen = [&](const std::string& bytes) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << bytes;
+        return openReplay(path);
+    };
+    CHECK(reopen(good));
+
+    // The index offset far outside the file (before it, once added to the mapping's address)
+    std::string bad = good;
+    uint64_t offset = 0 - (1ull << 40);
+    memcpy(&bad[bad.size() - 12], &offset, 8);
+    CHECK(reopen(bad));
+
+    // The last frame and the index cut off, but still ending in the trailer
+    uint64_t indexOffset;
+    memcpy(&indexOffset, &good[good.size() - 12], 8);
+    CHECK(reopen(good.substr(0, indexOffset - 1) + good.substr(good.size() - 12)));
+}
+
+// Adds `delta` to field `field` (numbered as in proc(5)) of a fixture's stat file
+static bool addToStatField(const std::string& path, int field, unsigned long long delta) {
+    std::ifstream in(path);
+    std::string stat((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    size_t at = stat.rfind(')');
+    if (at == std::string::npos) return false;
+    std::istringstream fields(stat.substr(at + 2));
+    std::string rewritten = stat.substr(0, at + 1), value;
+    for (int n = 3; fields >> value; n++)
+        rewritten += " " + (n == field ? std::to_string(std::stoull(value) + delta) : value);
+    std::ofstream(path) << rewritten << "\n";
+    return true;
+}
+
+// A pid taken over by a process that already used more CPU time than the old one starts
+// over, rather than showing the difference as its CPU % and fault rates, and shows its own cgroup
+static void testReusedPid() {
+    FixtureTree tree(smallFixture());
+    CHECK(tree.ok);
+    SimClock clock;
+    setClock(&clock);
+    clock.advance(1.0);
+    CHECK(tree.advance());
+    collectProcesses();
+
+    clock.advance(1.0);
+    CHECK(tree.advance());
+    int pid = fixturePid(tree.spec, 1, tree.round);
+    std::string path = tree.root + "/proc/" + std::to_string(pid) + "/stat";
+    CHECK(addToStatField(path, 10, 5000));   // minflt
+    CHECK(addToStatField(path, 14, 5000));   // utime
+    CHECK(addToStatField(path, 22, 150));    // starttime
+    std::ofstream(tree.root + "/proc/" + std::to_string(pid) + "/cgroup") << "0::/user.slice/reused.scope\n";
+    std::vector<ProcessSample> processes = collectProcesses();
+
+    const ProcessSample* p = findProcess(processes, pid);
+    CHECK(p != nullptr);
+    if (p) {
+        CHECK(p->cpuPercent == 0.0f);
+        CHECK(p->minorFaults == 0.0f);
+        CHECK(p->cgroup == "/user.slice/reused.scope");
+    }
+    setClock(nullptr);
+}
+
+// Rates over a SimClock: the fixture's counters grow by their round 1 values each round, so
+// after one simulated second every rate equals those values, and after two it is half of them
+static void testSimClockRates() {
+    FixtureTree tree(smallFixture());
+    CHECK(tree.ok);
+    SimClock clock;
+    setClock(&clock);
+    processIoEnabled = true;
+
+    // The first round is at time 0 on the simulated clock
+    CHECK(tree.advance());
+    Snapshot last = collectSnapshot();
+
+    std::map<int, unsigned long long> ticks, rchar;
+    std::string text;
+    for (const ProcessSample& p : last.processes) {
+        std::string dir = "/proc/" + std::to_string(p.pid);
+        if (procReadFile(dir + "/stat", text)) ticks[p.pid] = statTicks(text);
+        if (procReadFile(dir + "/io", text)) rchar[p.pid] = std::stoull(text.substr(text.find(' ') + 1));
+    }
+    CHECK((int)ticks.size() == tree.spec.pids);
+
+    // Share of busy ticks in the cpu line, the same in every round
+    CHECK(procReadFile("/proc/stat", text));
+    std::istringstream cpuLine(text.substr(3));
+    unsigned long long values[8] = {}, busy = 0, total = 0;
+    for (int i = 0; i < 8; i++) {
+        cpuLine >> values[i];
+        total += values[i];
+        if (i != 3 && i != 4 && i != 7) busy += values[i];  // idle, iowait and steal aren't busy
+    }
+    double hz = sysconf(_SC_CLK_TCK);
+    std::map<std::string, NetStats> perRound = last.net;
+
+    for (double seconds : {1.0, 2.0}) {
+        clock.advance(seconds);
+        CHECK(tree.advance());
+        Snapshot snap = collectSnapshot();
+
+        CHECK(snap.timeMs - last.timeMs == (int64_t)(seconds * 1000));
+        CHECK_NEAR(snap.cpuPercent, 100.0 * busy / total, 0.01);
+        CHECK_NEAR(snap.sched.ctxtPerSec, 20000.0 * tree.spec.cpus / seconds, 0.5);
+
+        // What the network graphs show: the counter difference over the snapshots' time difference
+        double interval = (snap.timeMs - last.timeMs) / 1000.0;
+        for (const auto& [name, stats] : snap.net) {
+            const NetStats& before = last.net[name];
+            CHECK_NEAR((stats.rx_bytes - before.rx_bytes) / interval, perRound[name].rx_bytes / seconds, 0.5);
+            CHECK_NEAR((stats.tx_bytes - before.tx_bytes) / interval, perRound[name].tx_bytes / seconds, 0.5);
+        }
+
+        CHECK(snap.processes.size() == ticks.size());
+        for (const ProcessSample& p : snap.processes) {
+            CHECK_NEAR(p.cpuPercent, ticks[p.pid] * 100.0 / hz / seconds, 0.01);
+            CHECK_NEAR(p.io.rchar, rchar[p.pid] / seconds, 0.5);
+        }
+        last = std::move(snap);
+    }
+    setClock(nullptr);
+}
+
+// ------------------------------
+// MAIN
+// ------------------------------
+
+struct Test {
+    const char* name;
+    void (*run)();
+};
+
+static const Test tests[] = {
+    {"process_cpu_percent", testProcessCpuPercent},
+    {"held_file_reads_whole", testHeldFileReadsWhole},
+    {"interrupts_read_whole", testInterruptsReadWhole},
+    {"schedstat_read_whole", testSchedstatReadWhole},
+    {"fixture_processes", testFixtureProcesses},
+    {"fixture_interfaces", testFixtureInterfaces},
+    {"fixture_sensors", testFixtureSensors},
+    {"fixture_churn", testFixtureChurn},
+    {"cgroup_rescan", testCgroupRescan},
+    {"cgroup_dotted_names", testCgroupDottedNames},
+    {"recording_bad_index", testRecordingBadIndex},
+    {"sim_clock_rates", testSimClockRates},
+    {"reused_pid", testReusedPid},
+};
+
+int main(int argc, char** argv) {
+    int failed = 0, ran = 0;
+    for (const Test& test : tests) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; i++) selected |= strcmp(argv[i], test.name) == 0;
+        if (!selected) continue;
+
+        fflush(stdout);
+        pid_t pid = fork();
+        if (pid == 0) {
+            test.run();
+            fflush(stderr);
+            _exit(failures > 0 ? 1 : 0);
+        }
+        int status = 0;
+        bool ok = pid > 0 && waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        printf("%s %s\n", ok ? "ok  " : "FAIL", test.name);
+        failed += !ok;
+        ran++;
+    }
+    printf("%d of %d tests passed\n", ran - failed, ran);
+    return failed > 0 ? 1 : 0;
+}
@@ -1,19 +1,23 @@
 #include "header.h" // Include your main header
+#include "plot.h"     // Downsampled history graphs
+#include "snapshot.h" // Current round of collector values
+#include "procfs.h"   // /sys reads go through the active ProcSource
+#include "profiler.h" // Timing zones for the profiler overlay
 #include <imgui.h>  // ImGui UI library
 
 #ifdef __linux__
 
-#include <filesystem>
-#include <fstream>
+#include <sstream>
 #include <deque>
 #include <vector>
 #include <string>
 
-namespace fs = std::filesystem;
-
 // Store a fixed-size history of temperature samples for the graph
-static std::deque<float> thermalHistory;
-static constexpr int maxSamples = 100; // Max number of samples in history
+static constexpr int maxSamples = 172800; // Max number of samples in history (24 h at 2 Hz)
+static PlotHistory thermalHistory(maxSamples);
+static double lastThermalSampleTime = 0.0; // Time of the last sample pushed to the graph
+static uint64_t lastThermalSequence = 0;   // Snapshot sequence the graph last saw
+static uint64_t lastThermalEpoch = 0;      // Replay seeks clear the graph
 
 // Controls for the thermal graph
 static bool pauseThermal = false;      // Whether to pause updating the graph
@@ -29,18 +33,20 @@ static std::string thermalSensorPath;
 // Search for a valid CPU temperature sensor under /sys/class/hwmon
 // Try to find thermal sensor file from various common locations
 static std::string findThermalSensorPath() {
-    // Step 1: Try /sys/class/thermal (generic)
-    for (const auto& entry : fs::directory_iterator("/sys/class/thermal")) {
-        if (entry.path().filename().string().find("thermal_zone") != std::string::npos) {
-            std::string typePath = entry.path() / "type";
-            std::string tempPath = entry.path() / "temp";
+    // Step 1: Try /sys/class/thermal (generic); either directory may be missing
+    std::vector<std::string> entries;
+    std::string contents;
+    if (procListDir("/sys/class/thermal", entries)) {
+        for (const std::string& entry : entries) {
+            if (entry.find("thermal_zone") == std::string::npos) continue;
+            std::string typePath = "/sys/class/thermal/" + entry + "/type";
+            std::string tempPath = "/sys/class/thermal/" + entry + "/temp";
 
-            std::ifstream typeFile(typePath);
             std::string type;
-            if (typeFile >> type) {
+            if (procReadFile(typePath, contents) && std::istringstream(contents) >> type) {
                 // Match CPU-related thermal zones
                 if (type.find("cpu") != std::string::npos || type.find("x86_pkg_temp") != std::string::npos || type.find("k10temp") != std::string::npos) {
-                    if (fs::exists(tempPath)) {
+                    if (procExists(tempPath)) {
                         return tempPath;
                     }
                 }
@@ -49,14 +55,15 @@ static std::string findThermalSensorPath() {
     }
 
     // Step 2: Fallback to hwmon-based method (your original logic)
-    for (const auto& entry : fs::directory_iterator("/sys/class/hwmon")) {
-        std::string namePath = entry.path() / "name";
-        std::ifstream nameFile(namePath);
-        std::string name;
-        if (nameFile >> name && name == "k10temp") {
-            fs::path tempPath = entry.path() / "temp1_input";
-            if (fs::exists(tempPath))
-                return tempPath.string();
+    if (procListDir("/sys/class/hwmon", entries)) {
+        for (const std::string& entry : entries) {
+            std::string namePath = "/sys/class/hwmon/" + entry + "/name";
+            std::string name;
+            if (procReadFile(namePath, contents) && std::istringstream(contents) >> name && name == "k10temp") {
+                std::string tempPath = "/sys/class/hwmon/" + entry + "/temp1_input";
+                if (procExists(tempPath))
+                    return tempPath;
+            }
         }
     }
 
@@ -66,7 +73,8 @@ static std::string findThermalSensorPath() {
 
 
 // Read the current CPU temperature (in Celsius)
-static float readTemperatureC() {
+float readTemperatureC() {
+    PROFILE_ZONE("readTemperatureC");
     // Try to locate the thermal sensor path if not already done
     if (thermalSensorPath.empty()) {
         thermalSensorPath = findThermalSensorPath();
@@ -83,9 +91,9 @@ static float readTemperatureC() {
     }
 
     // Read temperature from the sensor file
-    std::ifstream file(thermalSensorPath);
+    std::string contents;
     int millidegrees = 0;
-    if (file >> millidegrees) {
+    if (procReadFile(thermalSensorPath, contents) && std::istringstream(contents) >> millidegrees) {
         return millidegrees / 1000.0f; // Convert from millidegree to Celsius
     } else {
         useDummyThermal = true; // Fallback if read fails
@@ -93,13 +101,21 @@ static float readTemperatureC() {
     }
 }
 
+// Whether readTemperatureC returns real sensor values rather than dummy ones
+bool thermalSensorFound() {
+    if (thermalSensorPath.empty() && !useDummyThermal)
+        readTemperatureC();
+    return !useDummyThermal;
+}
+
 // Render the "Thermal" tab in the UI
 void renderThermalTab() {
+    PROFILE_ZONE("renderThermalTab");
     ImGui::Text("Thermal Information");
     ImGui::Separator();
 
     // Display the current CPU temperature
-    float currentTemp = readTemperatureC();
+    float currentTemp = currentSnapshot().temperatureC;
     ImGui::Text("Current CPU Temperature: %.1f °C", currentTemp);
 
     // User controls
@@ -107,18 +123,23 @@ void renderThermalTab() {
     ImGui::SliderInt("FPS", &fpsThermal, 1, 144);
     ImGui::SliderFloat("Y Scale", &yScaleThermal, 30.0f, 120.0f, "%.1f °C");
 
-    // Update temperature history if not paused
-    if (!pauseThermal) {
-        thermalHistory.push_back(currentTemp);
-        if (thermalHistory.size() > maxSamples)
-            thermalHistory.pop_front();
+    if (snapshotEpoch() != lastThermalEpoch) {
+        lastThermalEpoch = snapshotEpoch();
+        thermalHistory.clear();
+    }
+
+    // Update temperature history with each new snapshot, at most at the chosen FPS
+    double now = ImGui::GetTime();
+    if (!pauseThermal && snapshotSequence() != lastThermalSequence && now - lastThermalSampleTime >= 1.0 / fpsThermal) {
+        lastThermalSampleTime = now;
+        lastThermalSequence = snapshotSequence();
+        thermalHistory.push(currentTemp);
     }
 
     // Draw temperature graph if there's data
     if (!thermalHistory.empty()) {
-        std::vector<float> plotData(thermalHistory.begin(), thermalHistory.end());
-        ImGui::PlotLines("Temperature (°C)", plotData.data(), plotData.size(), 0, nullptr, 0.0f, yScaleThermal, ImVec2(0, 100));
-        ImGui::Text("Latest: %.1f °C", plotData.back());
+        thermalHistory.plot("Temperature (°C)", 0.0f, yScaleThermal, ImVec2(0, 100));
+        ImGui::Text("Latest: %.1f °C", thermalHistory.back());
     } else {
         ImGui::Text("No thermal data available.");
     }
@@ -126,8 +147,18 @@ void renderThermalTab() {
 
 #else // Non-Linux fallback
 
+float readTemperatureC() {
+    PROFILE_ZONE("readTemperatureC");
+    return 0.0f;
+}
+
+bool thermalSensorFound() {
+    return false;
+}
+
 // Message for unsupported platforms
 void renderThermalTab() {
+    PROFILE_ZONE("renderThermalTab");
     ImGui::Text("Thermal monitoring is only available on Linux.");
     ImGui::Text("This feature uses /sys/class/hwmon.");
 }
@@ -0,0 +1,143 @@
+#include "header.h"
+#include "fan.h"
+#include "snapshot.h"
+#include "cpufreq.h"
+#include "interrupts.h"
+#include "inventory.h"
+#include "perfcounters.h"
+#include "profiler.h"
+#include "scheduler.h"
+#include "selfstats.h"
+
+// The three top-level windows main() draws every frame. They live outside
+// main.cpp so the frame benchmark can drive them without SDL or OpenGL.
+
+// systemWindow, display information for the system monitorization
+void systemWindow(const char *id, ImVec2 size, ImVec2 position)
+{
+    PROFILE_ZONE("systemWindow");
+    ImGui::Begin(id);
+    ImGui::SetWindowSize(id, size);
+    ImGui::SetWindowPos(id, position);
+
+    // student TODO : add code here for the system window
+    // Show system monitorization info💜
+    const Snapshot &snap = currentSnapshot();
+    ImGui::Text("Operating System: %s", snap.host.osName.c_str());
+    ImGui::Text("User logged in: %s", snap.host.user.c_str());
+    ImGui::Text("Computer Name: %s", snap.host.hostname.c_str());
+    
+    const TaskStats &tasks = snap.tasks;
+    ImGui::Text("Total Tasks: %d", tasks.total);
+    ImGui::Text("Running: %d", tasks.running);
+    ImGui::Text("Sleeping: %d", tasks.sleeping);
+    ImGui::Text("Uninterruptible: %d", tasks.uninterruptible);
+    ImGui::Text("Stopped: %d", tasks.stopped);
+    ImGui::Text("Zombie: %d", tasks.zombie);
+    renderSchedPanel();
+
+    ImGui::Text("CPU: %s", snap.host.cpuModel.c_str());
+
+    if (!isReplaying())
+        ImGui::SliderInt("Sample Interval (ms)", &sampleIntervalMs, 100, 5000);
+    if (ImGui::Checkbox("Profiler", &showProfiler))
+        setProfilerEnabled(showProfiler);
+
+
+    if (ImGui::BeginTabBar("SystemMonitorTabs"))
+{
+    // CPU Tab
+    if (ImGui::BeginTabItem("CPU"))
+    {
+    renderCpuTab();
+        ImGui::EndTabItem();
+    }
+
+    // Frequency Tab
+    if (ImGui::BeginTabItem("Frequency"))
+    {
+        renderCpuFreqTab();
+        ImGui::EndTabItem();
+    }
+
+    // Interrupts Tab
+    if (ImGui::BeginTabItem("Interrupts"))
+    {
+        renderInterruptsTab();
+        ImGui::EndTabItem();
+    }
+
+    // Perf Tab
+    if (ImGui::BeginTabItem("Perf"))
+    {
+        renderPerfTab();
+        ImGui::EndTabItem();
+    }
+
+    // Hardware Tab
+    if (ImGui::BeginTabItem("Hardware"))
+    {
+        renderInventoryTab();
+        ImGui::EndTabItem();
+    }
+
+    // Fan Tab
+    if (ImGui::BeginTabItem("Fan"))
+    {
+    renderFanTab();
+        ImGui::EndTabItem();
+    }
+
+    // Thermal Tab
+    if (ImGui::BeginTabItem("Thermal"))
+    {
+        // Your Thermal content goes here
+        renderThermalTab();
+        ImGui::EndTabItem();
+    }
+
+    // Monitor's own resource usage
+    if (ImGui::BeginTabItem("Self"))
+    {
+        renderSelfTab();
+        ImGui::EndTabItem();
+    }
+
+    ImGui::EndTabBar();
+}
+
+    ImGui::End();
+}
+
+// memoryProcessesWindow, display information for the memory and processes information
+void memoryProcessesWindow(const char *id, ImVec2 size, ImVec2 position)
+{
+    PROFILE_ZONE("memoryProcessesWindow");
+    ImGui::Begin(id);
+    ImGui::SetWindowSize(id, size);
+    ImGui::SetWindowPos(id, position);
+
+    // student TODO : add code here for the memory and process information
+    renderRAMWindow(id, size, position);
+    renderSwapWindow(id, size, position);
+    renderDiskWindow(id, size, position);
+
+    renderProcessesWindow(id, size, position);  // NEW LINE
+
+    ImGui::End();
+}
+
+// network, display information network information
+void networkWindow(const char *id, ImVec2 size, ImVec2 position)
+{
+    PROFILE_ZONE("networkWindow");
+    ImGui::Begin(id);
+    ImGui::SetWindowSize(id, size);
+    ImGui::SetWindowPos(id, position);
+
+    // student TODO : add code here for the network information
+    rendernetworkWindow(id, ImVec2(400, 300), ImVec2(50, 400));
+    RenderExtraNetworkWindow(id, ImVec2(400, 300), ImVec2(50, 400));
+
+    ImGui::End();
+}